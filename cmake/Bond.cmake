@@ -5,13 +5,14 @@ include (Folders)
 # add_bond_codegen (file.bond [file2.bond ...]
 #   [ENUM_HEADER]
 #   [GRPC]
+#   [VIEWS]
 #   [OUTPUT_DIR dir]
 #   [IMPORT_DIR dir [dir2, ...]]
 #   [OPTIONS opt [opt2 ...]])
 #   [TARGET name]
 #
 function (add_bond_codegen)
-    set (flagArgs ENUM_HEADER GRPC)
+    set (flagArgs ENUM_HEADER GRPC VIEWS)
     set (oneValueArgs OUTPUT_DIR TARGET)
     set (multiValueArgs IMPORT_DIR OPTIONS)
     cmake_parse_arguments (arg "${flagArgs}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
@@ -34,6 +35,9 @@ function (add_bond_codegen)
     if (arg_GRPC)
         list(APPEND options --grpc)
     endif()
+    if (arg_VIEWS)
+        list(APPEND options --views)
+    endif()
     set (inputs "${arg_UNPARSED_ARGUMENTS}")
     set (outputs)
     foreach (file ${inputs})
@@ -52,6 +56,9 @@ function (add_bond_codegen)
             list(APPEND outputs "${outputDir}/${name}_grpc.cpp")
             list(APPEND outputs "${outputDir}/${name}_grpc.h")
         endif()
+        if (arg_VIEWS)
+            list(APPEND outputs "${outputDir}/${name}_views.h")
+        endif()
     endforeach()
     # if BOND_GBC_PATH is not set we must add a dependency on the "gbc" target to build it
     if (NOT BOND_GBC_PATH)
@@ -134,6 +134,10 @@ find_package (Boost 1.58.0
 
 message(STATUS "Boost Python Library: ${Boost_PYTHON_LIBRARY}")
 
+# zlib is optional and only used by the tests and benchmarks of
+# bond/ext/zlib_codec.h
+find_package (ZLIB)
+
 # Make sure AppVeyor CI runs fail when unit test dependencies are not found
 if (DEFINED ENV{APPVEYOR} AND ("$ENV{BOND_BUILD}" STREQUAL "C++"))
     if (NOT Boost_UNIT_TEST_FRAMEWORK_FOUND)
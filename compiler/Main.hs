@@ -78,7 +78,9 @@ writeSchema _ = error "writeSchema: impossible happened."
 
 cppCodegen :: Options -> IO()
 cppCodegen options@Cpp {..} = do
-    let typeMappingAliases = maybe cppTypeMapping (cppCustomAllocTypeMapping scoped_alloc_enabled) allocator
+    mapM_ fail $ cppOptionsError options
+    let typeMappingAllocator = maybe cppTypeMapping (cppCustomAllocTypeMapping scoped_alloc_enabled) allocator
+    let typeMappingAliases = if string_ref_enabled then cppStringRefTypeMapping typeMappingAllocator else typeMappingAllocator
     let typeMapping = if type_aliases_enabled then typeMappingAliases else cppExpandAliasesTypeMapping typeMappingAliases
     concurrentlyFor_ files $ codeGen options typeMapping templates
   where
@@ -104,7 +106,8 @@ cppCodegen options@Cpp {..} = do
         , apply_h applyProto export_attribute
         , apply_cpp applyProto
         ] <>
-        [ enum_h | enum_header]
+        [ enum_h | enum_header] <>
+        [ views_h | views_enabled]
 cppCodegen _ = error "cppCodegen: impossible happened."
 
 csCodegen :: Options -> IO()
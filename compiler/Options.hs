@@ -8,6 +8,7 @@
 module Options
     ( getOptions
     , processOptions
+    , cppOptionsError
     , Options(..)
     , ApplyOptions(..)
     ) where
@@ -16,6 +17,8 @@ import Paths_bond (version)
 import Data.Version (showVersion)
 import System.Console.CmdArgs
 import System.Console.CmdArgs.Explicit (processValue)
+import Data.List (nub)
+import Data.Maybe (fromMaybe, isJust)
 import IO (slashNormalize)
 
 data ApplyOptions =
@@ -44,6 +47,8 @@ data Options
         , alloc_ctors_enabled :: Bool
         , type_aliases_enabled :: Bool
         , scoped_alloc_enabled :: Bool
+        , string_ref_enabled :: Bool
+        , views_enabled :: Bool
         , service_inheritance_enabled :: Bool
         }
     | Cs
@@ -86,7 +91,7 @@ cpp = Cpp
     { files = def &= typFile &= args
     , import_dir = def &= typDir &= name "i" &= help "Add the directory to import search path"
     , output_dir = "." &= typDir &= name "o" &= help "Output generated files into the specified directory"
-    , using = def &= typ "MAPPING" &= name "u" &= help "Custom type alias mapping in the form alias=type"
+    , using = def &= typ "MAPPING" &= name "u" &= help "Custom type alias mapping in the form alias=type, or the name of a preset set of mappings; supported presets: boost-flat-containers"
     , namespace = def &= typ "MAPPING" &= name "n" &= help "Custom namespace mapping in the form bond_namespace=language_namespace"
     , header = def &= typ "HEADER" &= name "h" &= help "Emit #include HEADER into the generated files"
     , enum_header = def &= name "e" &= help "Generate enums into a separate header file"
@@ -100,6 +105,8 @@ cpp = Cpp
     , alloc_ctors_enabled = False &= explicit &= name "alloc-ctors" &= help "Generate constructors with allocator argument"
     , type_aliases_enabled = False &= explicit &= name "type-aliases" &= help "Generate type aliases"
     , scoped_alloc_enabled = False &= explicit &= name "scoped-alloc" &= help "Use std::scoped_allocator_adaptor for strings and containers"
+    , string_ref_enabled = False &= explicit &= name "string-ref" &= help "Use bond::string_ref, which references the input buffer during deserialization, for strings"
+    , views_enabled = False &= explicit &= name "views" &= help "Generate read-only views of structs serialized using Indexed Binary protocol"
     , service_inheritance_enabled = False &= explicit &= name "enable-service-inheritance" &= help "Enable service inheritance syntax in IDL"
     } &=
     name "c++" &=
@@ -153,8 +160,37 @@ mode = cmdArgsMode $ modes [cpp, cs, java, schema] &=
     help "Compile Bond schema file(s) and generate specified output. The schema file(s) can be in one of two formats: Bond IDL or JSON representation of the schema abstract syntax tree as produced by `gbc schema`. Multiple schema files can be specified either directly on the command line or by listing them in a text file passed to gbc via @listfile syntax." &=
     summary ("Bond Compiler " ++ showVersion version ++ ", (C) Microsoft")
 
+-- Named sets of type alias mappings, and the headers with the container
+-- traits they need, that can be passed to --using in place of a mapping.
+cppUsingPresets :: [(String, ([String], [String]))]
+cppUsingPresets =
+    [ ("boost-flat-containers",
+        ( [ "flat_map=boost::container::flat_map<{0}, {1}>"
+          , "flat_set=boost::container::flat_set<{0}>"
+          , "small_vector=boost::container::small_vector<{0}, 8>"
+          ]
+        , [ "<bond/ext/boost_flat_containers.h>" ]
+        ))
+    ]
+
+-- Expands --using presets and adds the headers needed by the options.
+expandCppOptions :: Options -> Options
+expandCppOptions o@Cpp{..} = o { using = concatMap fst expanded,
+                                 header = nub $ header ++ concatMap snd expanded ++ stringRefHeader }
+  where
+    expanded = map expand using
+    expand u = fromMaybe ([u], []) $ lookup u cppUsingPresets
+    stringRefHeader = [ "<bond/core/string_ref.h>" | string_ref_enabled ]
+expandCppOptions o = o
+
+-- Returns the error for C++ options that can't be used together.
+cppOptionsError :: Options -> Maybe String
+cppOptionsError Cpp{..}
+    | string_ref_enabled && isJust allocator = Just "--string-ref can't be used with --allocator."
+cppOptionsError _ = Nothing
+
 getOptions :: IO Options
-getOptions = slashNormalizeOption <$> cmdArgsRun mode
+getOptions = expandCppOptions . slashNormalizeOption <$> cmdArgsRun mode
 
 processOptions :: [String] -> Options
-processOptions = cmdArgsValue . processValue mode
+processOptions = expandCppOptions . cmdArgsValue . processValue mode
@@ -0,0 +1,133 @@
+-- Copyright (c) Microsoft. All rights reserved.
+-- Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+{-# LANGUAGE QuasiQuotes, OverloadedStrings, RecordWildCards #-}
+
+module Language.Bond.Codegen.Cpp.Views_h (views_h) where
+
+import System.FilePath
+import Data.Monoid
+import Prelude
+import Data.Text.Lazy (Text)
+import Data.Text.Lazy.Builder (toLazyText)
+import Text.Shakespeare.Text
+import Language.Bond.Syntax.Types
+import Language.Bond.Syntax.Util
+import Language.Bond.Codegen.TypeMapping
+import Language.Bond.Codegen.Util
+import qualified Language.Bond.Codegen.Cpp.Util as CPP
+
+-- | Codegen template for generating /base_name/_views.h containing read-only
+-- views of structs serialized using Indexed Binary protocol. Generated by
+-- <https://microsoft.github.io/bond/manual/compiler.html gbc> with
+-- @--views@ flag.
+--
+-- For each non-generic struct @Foo@ the template generates class @FooView@
+-- with an accessor for each field, which reads the field from the payload on
+-- demand. Strings are returned as @bond::string_ref@ and blobs as
+-- @bond::blob@ referencing the payload, containers as @bond::list_view@,
+-- @bond::map_view@ and @bond::nullable_view@ and nested structs as their
+-- views.
+--
+-- Views can't represent @nothing@: the accessor of a field with default value
+-- of @nothing@ returns the default value of the field's type when the field is
+-- missing from the payload, which the generated code notes in a comment.
+views_h :: MappingContext -> String -> [Import] -> [Declaration] -> (String, Text)
+views_h cpp file imports declarations = ("_views.h", [lt|
+#pragma once
+
+#include "#{file}_reflection.h"
+#include <bond/protocol/indexed_binary_view.h>
+#{newlineSepEnd 0 include imports}
+#{CPP.openNamespace cpp}
+    #{newlineSepEnd 1 forwardDeclaration structs}
+    #{doubleLineSepEnd 1 view structs}
+    #{doubleLineSepEnd 1 accessors structs}
+#{CPP.closeNamespace cpp}
+|])
+  where
+    cppType = toLazyText . getTypeName cpp
+
+    -- template for generating #include statement from import
+    include (Import path) = [lt|#include "#{dropExtension (slashForward path)}_views.h"|]
+
+    -- views are generated for non-generic structs
+    structs = filter nonGeneric declarations
+      where
+        nonGeneric Struct {..} = null declParams
+        nonGeneric _ = False
+
+    viewName s = declName s <> "View"
+
+    qualifiedViewName s = [lt|#{getQualifiedName cpp $ getDeclNamespace cpp s}::#{viewName s}|]
+
+    -- type returned by the accessor of a field
+    viewType BT_String = "::bond::string_ref"
+    viewType BT_MetaName = "::bond::string_ref"
+    viewType BT_MetaFullName = "::bond::string_ref"
+    viewType BT_WString = "std::wstring"
+    viewType BT_Blob = "::bond::blob"
+    viewType (BT_Maybe t) = viewType t
+    viewType (BT_List t) = [lt|::bond::list_view<#{viewType t}>|]
+    viewType (BT_Vector t) = [lt|::bond::list_view<#{viewType t}>|]
+    viewType (BT_Set t) = [lt|::bond::list_view<#{viewType t}>|]
+    viewType (BT_Map k v) = [lt|::bond::map_view<#{viewType k}, #{viewType v}>|]
+    viewType (BT_Nullable t) = [lt|::bond::nullable_view<#{viewType t}>|]
+    viewType (BT_Bonded t) = viewType t
+    viewType (BT_UserDefined a@Alias {..} args) = viewType $ resolveAlias a args
+    viewType (BT_UserDefined s@Struct {..} _)
+        | null declParams = qualifiedViewName s
+        | otherwise = "::bond::struct_view"
+    viewType (BT_UserDefined s@Forward {..} _)
+        | null declParams = qualifiedViewName s
+        | otherwise = "::bond::struct_view"
+    viewType t = cppType t
+
+    -- value returned when the field is missing from the payload
+    defaultView Field {..} = [lt|#{viewType fieldType}(#{value fieldType fieldDefault})|]
+      where
+        value (BT_Maybe _) _ = mempty
+        value t (Just d) = CPP.defaultValue cpp t d
+        value _ Nothing = mempty
+
+    forwardDeclaration s = [lt|class #{viewName s};|]
+
+    -- template for generating view class declaration
+    view s@Struct {..} = [lt|//
+    // #{declName}
+    //
+    class #{viewName s}
+        : public #{base structBase}
+    {
+    public:
+        #{viewName s}()
+        {}
+
+        explicit #{viewName s}(const ::bond::blob& data)
+            : #{base structBase}(data)
+        {}
+        #{newlineBeginSep 2 accessor structFields}
+    };|]
+      where
+        base (Just t) = viewType t
+        base Nothing = "::bond::struct_view"
+
+        accessor f@Field {..} = [lt|#{nothingComment f}#{viewType fieldType} #{fieldName}() const;|]
+
+        nothingComment f@Field {fieldType = BT_Maybe _, ..} = [lt|// The default value of #{fieldName} is nothing, which views can't
+        // represent, so #{fieldName}() returns #{defaultView f} if it is missing.
+        |]
+        nothingComment _ = mempty
+
+    view _ = mempty
+
+    -- template for generating accessor definitions
+    accessors s@Struct {..} = newlineSep 1 accessor structFields
+      where
+        accessor f@Field {..} = [lt|inline #{viewType fieldType} #{viewName s}::#{fieldName}() const
+    {
+        return ::bond::struct_view::get<#{declName}::Schema::var::#{fieldName}>(#{defaultView f});
+    }
+    |]
+
+    accessors _ = mempty
@@ -43,6 +43,7 @@ module Language.Bond.Codegen.Templates
     ,  Protocol(..)
     , grpc_h
     , grpc_cpp
+    , views_h
       -- ** C#
     , FieldMapping(..)
     , StructMapping(..)
@@ -65,6 +66,7 @@ import Language.Bond.Codegen.Cpp.Types_cpp
 import Language.Bond.Codegen.Cpp.Types_h
 import Language.Bond.Codegen.Cpp.Grpc_cpp
 import Language.Bond.Codegen.Cpp.Grpc_h
+import Language.Bond.Codegen.Cpp.Views_h
 import Language.Bond.Codegen.Cs.Types_cs
 import Language.Bond.Codegen.Cs.Grpc_cs
 import Language.Bond.Codegen.Java.Class_java
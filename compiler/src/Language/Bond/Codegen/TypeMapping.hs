@@ -24,6 +24,7 @@ module Language.Bond.Codegen.TypeMapping
     , cppTypeMapping
     , cppCustomAllocTypeMapping
     , cppExpandAliasesTypeMapping
+    , cppStringRefTypeMapping
     , csTypeMapping
     , csCollectionInterfacesTypeMapping
     , javaTypeMapping
@@ -195,6 +196,16 @@ cppExpandAliasesTypeMapping m = m
     , annotatedMapping = cppExpandAliasesTypeMapping $ annotatedMapping m
     }
 
+-- | C++ type name mapping which maps the @string@ type to @bond::string_ref@
+-- referencing the input buffer during deserialization.
+cppStringRefTypeMapping :: TypeMapping -> TypeMapping
+cppStringRefTypeMapping m = m
+    { mapType = cppTypeStringRef $ mapType m
+    , instanceMapping = cppStringRefTypeMapping $ instanceMapping m
+    , elementMapping = cppStringRefTypeMapping $ elementMapping m
+    , annotatedMapping = cppStringRefTypeMapping $ annotatedMapping m
+    }
+
 -- | The default C# type name mapping.
 csTypeMapping :: TypeMapping
 csTypeMapping = TypeMapping
@@ -446,6 +457,10 @@ cppTypeExpandAliases :: (Type -> TypeNameBuilder) -> Type -> TypeNameBuilder
 cppTypeExpandAliases _ (BT_UserDefined a@Alias {..} args) = aliasTypeName a args
 cppTypeExpandAliases m t = m t
 
+cppTypeStringRef :: (Type -> TypeNameBuilder) -> Type -> TypeNameBuilder
+cppTypeStringRef _ BT_String = pure "::bond::string_ref"
+cppTypeStringRef m t = m t
+
 comparer :: Type -> TypeNameBuilder
 comparer t = ", std::less<" <>> elementTypeName t <<> ">, "
 
@@ -60,6 +60,7 @@ tests = testGroup "Compiler tests"
         , testCase "Duplicate method definition in service" $ failBadSyntax "Should fail, method name should be unique" "duplicate_service_method"
         , testCase "Invalid service base: struct" $ failBadSyntax "Should fail, struct can't be used as service base" "service_invalid_base_struct"
         , testCase "Invalid service base: type param" $ failBadSyntax "Should fail, type param can't be used as service base" "service_invalid_base_type_param"
+        , testCase "String ref with allocator" $ failCppOptions "--string-ref can't be used with --allocator." ["c++", "--string-ref", "--allocator=arena"]
         ]
     , testGroup "Codegen"
         [ utilTestGroup,
@@ -76,6 +77,7 @@ tests = testGroup "Compiler tests"
             , verifyCppCodegen "aliases"
             , verifyCppCodegen "alias_key"
             , verifyCppCodegen "maybe_blob"
+            , verifyCppCodegen "fixed"
             , verifyCodegen
                 [ "c++"
                 , "--enum-header"
@@ -111,6 +113,17 @@ tests = testGroup "Compiler tests"
                 , "--using=String=my::string"
                 ]
                 "custom_alias_without_allocator"
+            , verifyCodegen
+                [ "c++"
+                , "--allocator=arena"
+                , "--using=boost-flat-containers"
+                ]
+                "boost_flat_containers"
+            , verifyCodegen
+                [ "c++"
+                , "--string-ref"
+                ]
+                "string_ref"
            , testGroup "Apply"
                 [ verifyApplyCodegen
                     [ "c++"
@@ -130,6 +143,13 @@ tests = testGroup "Compiler tests"
                     ]
                     "with_enum_header"
                 ]
+           , testGroup "Views"
+                [ verifyViewsCodegen
+                    [ "c++"
+                    , "--views"
+                    ]
+                    "views"
+                ]
             , verifyCodegen
                 [ "c++"
                 , "--namespace=tests=nsmapped"
@@ -11,9 +11,11 @@ module Tests.Codegen
     , verifyCppGrpcCodegen
     , verifyApplyCodegen
     , verifyExportsCodegen
+    , verifyViewsCodegen
     , verifyCsCodegen
     , verifyCsGrpcCodegen
     , verifyJavaCodegen
+    , failCppOptions
     ) where
 
 import System.FilePath
@@ -28,6 +30,7 @@ import qualified Data.ByteString.Char8 as BS
 import Text.PrettyPrint (render, text)
 import Test.Tasty
 import Test.Tasty.Golden.Advanced
+import Test.Tasty.HUnit (Assertion, (@?=))
 import Language.Bond.Codegen.Templates
 import Language.Bond.Codegen.TypeMapping
 import Language.Bond.Syntax.Types (Bond(..), Import, Declaration(..))
@@ -86,6 +89,13 @@ verifyExportsCodegen args baseName =
         , types_h export_attribute header enum_header allocator alloc_ctors_enabled type_aliases_enabled scoped_alloc_enabled
         ]
 
+verifyViewsCodegen :: [String] -> FilePath -> TestTree
+verifyViewsCodegen args baseName =
+    testGroup baseName $
+        map (verifyFile options baseName (cppExpandAliases (type_aliases_enabled options) cppTypeMapping) "views") [views_h]
+  where
+    options = processOptions args
+
 verifyCppGrpcCodegen :: [String] -> FilePath -> TestTree
 verifyCppGrpcCodegen args baseName =
     testGroup baseName $
@@ -130,9 +140,10 @@ verifyFiles options baseName variation =
     constructorOptions Cs {..} = if constructor_parameters
         then ConstructorParameters
         else DefaultWithProtectedBase
-    typeMapping Cpp {..} = cppExpandAliases type_aliases_enabled $ maybe cppTypeMapping (cppCustomAllocTypeMapping scoped_alloc_enabled) allocator
+    typeMapping Cpp {..} = cppExpandAliases type_aliases_enabled $ stringRef string_ref_enabled $ maybe cppTypeMapping (cppCustomAllocTypeMapping scoped_alloc_enabled) allocator
     typeMapping Cs {} = csTypeMapping
     typeMapping Java {} = javaTypeMapping
+    stringRef enabled = if enabled then cppStringRefTypeMapping else id
     templates Cpp {..} =
         [ (reflection_h export_attribute)
         , types_cpp
@@ -153,26 +164,30 @@ verifyFiles options baseName variation =
         [ testGroup "custom allocator" $
             map (verify (cppExpandAliasesTypeMapping $ cppCustomAllocTypeMapping False "arena") (variation </> "allocator"))
                 (templates $ options { allocator = Just "arena" })
-            | isNothing allocator
+            | isNothing allocator && not string_ref_enabled
         ] ++
         [ testGroup "constructors with allocator argument" $
             map (verify (cppExpandAliasesTypeMapping $ cppCustomAllocTypeMapping False "arena") (variation </> "alloc_ctors"))
                 (templates $ options { allocator = Just "arena", alloc_ctors_enabled = True })
-            | isNothing allocator
+            | isNothing allocator && not string_ref_enabled
         ] ++
         [ testGroup "type aliases" $
             map (verify (cppCustomAllocTypeMapping False "arena") (variation </> "type_aliases"))
                 (templates $ options { allocator = Just "arena", type_aliases_enabled = True })
+            | not string_ref_enabled
         ] ++
         [ testGroup "scoped allocator" $
             map (verify (cppExpandAliasesTypeMapping $ cppCustomAllocTypeMapping True "arena") (variation </> "scoped_allocator"))
                 (templates $ options { allocator = Just "arena", scoped_alloc_enabled = True })
-            | isNothing allocator
+            | isNothing allocator && not string_ref_enabled
         ]
     extra Java {} =
         [
         ]
 
+failCppOptions :: String -> [String] -> Assertion
+failCppOptions errMsg args = cppOptionsError (processOptions args) @?= Just errMsg
+
 verifyFile :: Options -> FilePath -> TypeMapping -> FilePath -> Template -> TestTree
 verifyFile options baseName typeMapping subfolder template =
     goldenTest suffix readGolden codegen cmp updateGolden
@@ -0,0 +1,117 @@
+
+#pragma once
+
+#include <bond/core/bond_version.h>
+
+#if BOND_VERSION < 0x0800
+#error This file was generated by a newer version of the Bond compiler and is incompatible with your version of the Bond library.
+#endif
+
+#if BOND_MIN_CODEGEN_VERSION > 0x0b03
+#error This file was generated by an older version of the Bond compiler and is incompatible with your version of the Bond library.
+#endif
+
+#include <bond/core/config.h>
+#include <bond/core/containers.h>
+#include <bond/core/blob.h>
+
+
+namespace tests
+{
+    
+    struct Foo
+    {
+        using allocator_type = arena;
+
+        uint64_t hash;
+        int32_t offset;
+        uint16_t port;
+        std::basic_string<char, std::char_traits<char>, typename std::allocator_traits<arena>::template rebind_alloc<char> > name;
+        ::bond::blob data;
+        
+        struct _bond_vc12_ctor_workaround_ {};
+        template <int = 0> // Workaround to avoid compilation if not used
+        Foo(_bond_vc12_ctor_workaround_ = {})
+          : hash(),
+            offset(),
+            port()
+        {
+        }
+
+        
+        // Compiler generated copy ctor OK
+        Foo(const Foo&) = default;
+        
+#if defined(_MSC_VER) && (_MSC_VER < 1900)  // Versions of MSVC prior to 1900 do not support = default for move ctors
+        Foo(Foo&& other)
+          : hash(std::move(other.hash)),
+            offset(std::move(other.offset)),
+            port(std::move(other.port)),
+            name(std::move(other.name)),
+            data(std::move(other.data))
+        {
+        }
+#else
+        Foo(Foo&&) = default;
+#endif
+        
+        explicit
+        Foo(const arena& allocator)
+          : hash(),
+            offset(),
+            port(),
+            name(allocator)
+        {
+        }
+        
+        
+#if defined(_MSC_VER) && (_MSC_VER < 1900)  // Versions of MSVC prior to 1900 do not support = default for move ctors
+        Foo& operator=(Foo other)
+        {
+            other.swap(*this);
+            return *this;
+        }
+#else
+        // Compiler generated operator= OK
+        Foo& operator=(const Foo&) = default;
+        Foo& operator=(Foo&&) = default;
+#endif
+
+        bool operator==(const Foo& other) const
+        {
+            return true
+                && (hash == other.hash)
+                && (offset == other.offset)
+                && (port == other.port)
+                && (name == other.name)
+                && (data == other.data);
+        }
+
+        bool operator!=(const Foo& other) const
+        {
+            return !(*this == other);
+        }
+
+        void swap(Foo& other)
+        {
+            using std::swap;
+            swap(hash, other.hash);
+            swap(offset, other.offset);
+            swap(port, other.port);
+            swap(name, other.name);
+            swap(data, other.data);
+        }
+
+        struct Schema;
+
+    protected:
+        void InitMetadata(const char*, const char*)
+        {
+        }
+    };
+
+    inline void swap(::tests::Foo& left, ::tests::Foo& right)
+    {
+        left.swap(right);
+    }
+} // namespace tests
@@ -0,0 +1,73 @@
+
+#pragma once
+
+#include "boost_flat_containers_types.h"
+#include <bond/core/reflection.h>
+
+namespace test
+{
+    //
+    // foo
+    //
+    struct foo::Schema
+    {
+        typedef ::bond::no_base base;
+
+        static const ::bond::Metadata metadata;
+        
+        private: static const ::bond::Metadata s_m_metadata;
+        private: static const ::bond::Metadata s_s_metadata;
+        private: static const ::bond::Metadata s_v_metadata;
+
+        public: struct var
+        {
+            // m
+            typedef struct : ::bond::reflection::FieldTemplate<
+                0,
+                ::bond::reflection::optional_field_modifier,
+                foo,
+                boost::container::flat_map<uint64_t, uint32_t>,
+                &foo::m,
+                &s_m_metadata
+            > {}  m;
+        
+            // s
+            typedef struct : ::bond::reflection::FieldTemplate<
+                1,
+                ::bond::reflection::optional_field_modifier,
+                foo,
+                boost::container::flat_set<uint64_t>,
+                &foo::s,
+                &s_s_metadata
+            > {}  s;
+        
+            // v
+            typedef struct : ::bond::reflection::FieldTemplate<
+                2,
+                ::bond::reflection::optional_field_modifier,
+                foo,
+                boost::container::small_vector<uint32_t, 8>,
+                &foo::v,
+                &s_v_metadata
+            > {}  v;
+        };
+
+        private: typedef boost::mpl::list<> fields0;
+        private: typedef boost::mpl::push_front<fields0, var::v>::type fields1;
+        private: typedef boost::mpl::push_front<fields1, var::s>::type fields2;
+        private: typedef boost::mpl::push_front<fields2, var::m>::type fields3;
+
+        public: typedef fields3::type fields;
+        
+        
+        static ::bond::Metadata GetMetadata()
+        {
+            return ::bond::reflection::MetadataInit("foo", "test.foo",
+                ::bond::reflection::Attributes()
+            );
+        }
+    };
+    
+
+    
+} // namespace test
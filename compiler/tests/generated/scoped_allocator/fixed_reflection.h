@@ -0,0 +1,97 @@
+
+#pragma once
+
+#include "fixed_types.h"
+#include <bond/core/reflection.h>
+
+namespace tests
+{
+    //
+    // Foo
+    //
+    struct Foo::Schema
+    {
+        typedef ::bond::no_base base;
+
+        static const ::bond::Metadata metadata;
+        
+        private: static const ::bond::Metadata s_hash_metadata;
+        private: static const ::bond::Metadata s_offset_metadata;
+        private: static const ::bond::Metadata s_port_metadata;
+        private: static const ::bond::Metadata s_name_metadata;
+        private: static const ::bond::Metadata s_data_metadata;
+
+        public: struct var
+        {
+            // hash
+            typedef struct : ::bond::reflection::FieldTemplate<
+                0,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                uint64_t,
+                &Foo::hash,
+                &s_hash_metadata
+            > {}  hash;
+        
+            // offset
+            typedef struct : ::bond::reflection::FieldTemplate<
+                1,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                int32_t,
+                &Foo::offset,
+                &s_offset_metadata
+            > {}  offset;
+        
+            // port
+            typedef struct : ::bond::reflection::FieldTemplate<
+                2,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                uint16_t,
+                &Foo::port,
+                &s_port_metadata
+            > {}  port;
+        
+            // name
+            typedef struct : ::bond::reflection::FieldTemplate<
+                3,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                std::basic_string<char, std::char_traits<char>, std::scoped_allocator_adaptor<typename std::allocator_traits<arena>::template rebind_alloc<char> > >,
+                &Foo::name,
+                &s_name_metadata
+            > {}  name;
+        
+            // data
+            typedef struct : ::bond::reflection::FieldTemplate<
+                4,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                ::bond::blob,
+                &Foo::data,
+                &s_data_metadata
+            > {}  data;
+        };
+
+        private: typedef boost::mpl::list<> fields0;
+        private: typedef boost::mpl::push_front<fields0, var::data>::type fields1;
+        private: typedef boost::mpl::push_front<fields1, var::name>::type fields2;
+        private: typedef boost::mpl::push_front<fields2, var::port>::type fields3;
+        private: typedef boost::mpl::push_front<fields3, var::offset>::type fields4;
+        private: typedef boost::mpl::push_front<fields4, var::hash>::type fields5;
+
+        public: typedef fields5::type fields;
+        
+        
+        static ::bond::Metadata GetMetadata()
+        {
+            return ::bond::reflection::MetadataInit("Foo", "tests.Foo",
+                ::bond::reflection::Attributes()
+            );
+        }
+    };
+    
+
+    
+} // namespace tests
@@ -0,0 +1,42 @@
+
+#include "fixed_reflection.h"
+#include <bond/core/exception.h>
+
+namespace tests
+{
+    
+    const ::bond::Metadata Foo::Schema::metadata
+        = Foo::Schema::GetMetadata();
+    
+    const ::bond::Metadata Foo::Schema::s_hash_metadata
+        = ::bond::reflection::MetadataInit("hash", ::bond::reflection::optional_field_modifier::value,
+                {
+                    { "fixed", "" }
+                });
+    
+    const ::bond::Metadata Foo::Schema::s_offset_metadata
+        = ::bond::reflection::MetadataInit("offset", ::bond::reflection::optional_field_modifier::value,
+                {
+                    { "fixed", "" }
+                });
+    
+    const ::bond::Metadata Foo::Schema::s_port_metadata
+        = ::bond::reflection::MetadataInit("port", ::bond::reflection::optional_field_modifier::value,
+                {
+                    { "fixed", "" }
+                });
+    
+    const ::bond::Metadata Foo::Schema::s_name_metadata
+        = ::bond::reflection::MetadataInit("name", ::bond::reflection::optional_field_modifier::value,
+                {
+                    { "fixed", "" }
+                });
+    
+    const ::bond::Metadata Foo::Schema::s_data_metadata
+        = ::bond::reflection::MetadataInit("data", ::bond::reflection::optional_field_modifier::value,
+                {
+                    { "fixed", "" }
+                });
+
+    
+} // namespace tests
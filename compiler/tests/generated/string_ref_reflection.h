@@ -0,0 +1,109 @@
+
+#pragma once
+
+#include "string_ref_types.h"
+#include <bond/core/reflection.h>
+
+namespace tests
+{
+    //
+    // Foo
+    //
+    struct Foo::Schema
+    {
+        typedef ::bond::no_base base;
+
+        static const ::bond::Metadata metadata;
+        
+        private: static const ::bond::Metadata s_s_metadata;
+        private: static const ::bond::Metadata s_d_metadata;
+        private: static const ::bond::Metadata s_v_metadata;
+        private: static const ::bond::Metadata s_m_metadata;
+        private: static const ::bond::Metadata s_n_metadata;
+        private: static const ::bond::Metadata s_st_metadata;
+
+        public: struct var
+        {
+            // s
+            typedef struct : ::bond::reflection::FieldTemplate<
+                0,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                ::bond::string_ref,
+                &Foo::s,
+                &s_s_metadata
+            > {}  s;
+        
+            // d
+            typedef struct : ::bond::reflection::FieldTemplate<
+                1,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                ::bond::string_ref,
+                &Foo::d,
+                &s_d_metadata
+            > {}  d;
+        
+            // v
+            typedef struct : ::bond::reflection::FieldTemplate<
+                2,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                std::vector< ::bond::string_ref>,
+                &Foo::v,
+                &s_v_metadata
+            > {}  v;
+        
+            // m
+            typedef struct : ::bond::reflection::FieldTemplate<
+                3,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                std::map< ::bond::string_ref, int32_t>,
+                &Foo::m,
+                &s_m_metadata
+            > {}  m;
+        
+            // n
+            typedef struct : ::bond::reflection::FieldTemplate<
+                4,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                ::bond::nullable< ::bond::string_ref>,
+                &Foo::n,
+                &s_n_metadata
+            > {}  n;
+        
+            // st
+            typedef struct : ::bond::reflection::FieldTemplate<
+                5,
+                ::bond::reflection::optional_field_modifier,
+                Foo,
+                ::bond::maybe< ::bond::string_ref>,
+                &Foo::st,
+                &s_st_metadata
+            > {}  st;
+        };
+
+        private: typedef boost::mpl::list<> fields0;
+        private: typedef boost::mpl::push_front<fields0, var::st>::type fields1;
+        private: typedef boost::mpl::push_front<fields1, var::n>::type fields2;
+        private: typedef boost::mpl::push_front<fields2, var::m>::type fields3;
+        private: typedef boost::mpl::push_front<fields3, var::v>::type fields4;
+        private: typedef boost::mpl::push_front<fields4, var::d>::type fields5;
+        private: typedef boost::mpl::push_front<fields5, var::s>::type fields6;
+
+        public: typedef fields6::type fields;
+        
+        
+        static ::bond::Metadata GetMetadata()
+        {
+            return ::bond::reflection::MetadataInit("Foo", "tests.Foo",
+                ::bond::reflection::Attributes()
+            );
+        }
+    };
+    
+
+    
+} // namespace tests
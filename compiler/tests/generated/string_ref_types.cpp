@@ -0,0 +1,30 @@
+
+#include "string_ref_reflection.h"
+#include <bond/core/exception.h>
+
+namespace tests
+{
+    
+    const ::bond::Metadata Foo::Schema::metadata
+        = Foo::Schema::GetMetadata();
+    
+    const ::bond::Metadata Foo::Schema::s_s_metadata
+        = ::bond::reflection::MetadataInit("s");
+    
+    const ::bond::Metadata Foo::Schema::s_d_metadata
+        = ::bond::reflection::MetadataInit("default", "d");
+    
+    const ::bond::Metadata Foo::Schema::s_v_metadata
+        = ::bond::reflection::MetadataInit("v");
+    
+    const ::bond::Metadata Foo::Schema::s_m_metadata
+        = ::bond::reflection::MetadataInit("m");
+    
+    const ::bond::Metadata Foo::Schema::s_n_metadata
+        = ::bond::reflection::MetadataInit("n");
+    
+    const ::bond::Metadata Foo::Schema::s_st_metadata
+        = ::bond::reflection::MetadataInit(::bond::nothing, "st");
+
+    
+} // namespace tests
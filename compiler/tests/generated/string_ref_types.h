@@ -0,0 +1,107 @@
+
+#pragma once
+
+#include <bond/core/string_ref.h>
+#include <bond/core/bond_version.h>
+
+#if BOND_VERSION < 0x0800
+#error This file was generated by a newer version of the Bond compiler and is incompatible with your version of the Bond library.
+#endif
+
+#if BOND_MIN_CODEGEN_VERSION > 0x0b03
+#error This file was generated by an older version of the Bond compiler and is incompatible with your version of the Bond library.
+#endif
+
+#include <bond/core/config.h>
+#include <bond/core/containers.h>
+#include <bond/core/nullable.h>
+
+
+namespace tests
+{
+    
+    struct Foo
+    {
+        ::bond::string_ref s;
+        ::bond::string_ref d;
+        std::vector< ::bond::string_ref> v;
+        std::map< ::bond::string_ref, int32_t> m;
+        ::bond::nullable< ::bond::string_ref> n;
+        ::bond::maybe< ::bond::string_ref> st;
+        
+        Foo()
+          : d("default")
+        {
+        }
+
+        
+        // Compiler generated copy ctor OK
+        Foo(const Foo&) = default;
+        
+#if defined(_MSC_VER) && (_MSC_VER < 1900)  // Versions of MSVC prior to 1900 do not support = default for move ctors
+        Foo(Foo&& other)
+          : s(std::move(other.s)),
+            d(std::move(other.d)),
+            v(std::move(other.v)),
+            m(std::move(other.m)),
+            n(std::move(other.n)),
+            st(std::move(other.st))
+        {
+        }
+#else
+        Foo(Foo&&) = default;
+#endif
+        
+        
+#if defined(_MSC_VER) && (_MSC_VER < 1900)  // Versions of MSVC prior to 1900 do not support = default for move ctors
+        Foo& operator=(Foo other)
+        {
+            other.swap(*this);
+            return *this;
+        }
+#else
+        // Compiler generated operator= OK
+        Foo& operator=(const Foo&) = default;
+        Foo& operator=(Foo&&) = default;
+#endif
+
+        bool operator==(const Foo& other) const
+        {
+            return true
+                && (s == other.s)
+                && (d == other.d)
+                && (v == other.v)
+                && (m == other.m)
+                && (n == other.n)
+                && (st == other.st);
+        }
+
+        bool operator!=(const Foo& other) const
+        {
+            return !(*this == other);
+        }
+
+        void swap(Foo& other)
+        {
+            using std::swap;
+            swap(s, other.s);
+            swap(d, other.d);
+            swap(v, other.v);
+            swap(m, other.m);
+            swap(n, other.n);
+            swap(st, other.st);
+        }
+
+        struct Schema;
+
+    protected:
+        void InitMetadata(const char*, const char*)
+        {
+        }
+    };
+
+    inline void swap(::tests::Foo& left, ::tests::Foo& right)
+    {
+        left.swap(right);
+    }
+} // namespace tests
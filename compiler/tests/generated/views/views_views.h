@@ -0,0 +1,130 @@
+
+#pragma once
+
+#include "views_reflection.h"
+#include <bond/protocol/indexed_binary_view.h>
+
+namespace tests
+{
+    class BaseView;
+    class DerivedView;
+    
+    //
+    // Base
+    //
+    class BaseView
+        : public ::bond::struct_view
+    {
+    public:
+        BaseView()
+        {}
+
+        explicit BaseView(const ::bond::blob& data)
+            : ::bond::struct_view(data)
+        {}
+        
+        int32_t id() const;
+        ::bond::string_ref name() const;
+    };
+
+    //
+    // Derived
+    //
+    class DerivedView
+        : public ::tests::BaseView
+    {
+    public:
+        DerivedView()
+        {}
+
+        explicit DerivedView(const ::bond::blob& data)
+            : ::tests::BaseView(data)
+        {}
+        
+        uint64_t id() const;
+        ::bond::list_view<::bond::string_ref> tags() const;
+        ::bond::map_view<::bond::string_ref, ::tests::BaseView> items() const;
+        ::bond::nullable_view<::tests::BaseView> parent() const;
+        ::bond::list_view<::bond::nullable_view<double>> values() const;
+        ::bond::blob payload() const;
+        ::tests::BaseView lazy() const;
+        std::wstring label() const;
+        ::tests::Color color() const;
+        // The default value of title is nothing, which views can't
+        // represent, so title() returns ::bond::string_ref() if it is missing.
+        ::bond::string_ref title() const;
+        // The default value of count is nothing, which views can't
+        // represent, so count() returns int32_t() if it is missing.
+        int32_t count() const;
+    };
+
+    
+    inline int32_t BaseView::id() const
+    {
+        return ::bond::struct_view::get<Base::Schema::var::id>(int32_t(7));
+    }
+    
+    inline ::bond::string_ref BaseView::name() const
+    {
+        return ::bond::struct_view::get<Base::Schema::var::name>(::bond::string_ref());
+    }
+    
+
+    inline uint64_t DerivedView::id() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::id>(uint64_t());
+    }
+    
+    inline ::bond::list_view<::bond::string_ref> DerivedView::tags() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::tags>(::bond::list_view<::bond::string_ref>());
+    }
+    
+    inline ::bond::map_view<::bond::string_ref, ::tests::BaseView> DerivedView::items() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::items>(::bond::map_view<::bond::string_ref, ::tests::BaseView>());
+    }
+    
+    inline ::bond::nullable_view<::tests::BaseView> DerivedView::parent() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::parent>(::bond::nullable_view<::tests::BaseView>());
+    }
+    
+    inline ::bond::list_view<::bond::nullable_view<double>> DerivedView::values() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::values>(::bond::list_view<::bond::nullable_view<double>>());
+    }
+    
+    inline ::bond::blob DerivedView::payload() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::payload>(::bond::blob());
+    }
+    
+    inline ::tests::BaseView DerivedView::lazy() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::lazy>(::tests::BaseView());
+    }
+    
+    inline std::wstring DerivedView::label() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::label>(std::wstring(L"label"));
+    }
+    
+    inline ::tests::Color DerivedView::color() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::color>(::tests::Color(::tests::_bond_enumerators::Color::Green));
+    }
+    
+    inline ::bond::string_ref DerivedView::title() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::title>(::bond::string_ref());
+    }
+    
+    inline int32_t DerivedView::count() const
+    {
+        return ::bond::struct_view::get<Derived::Schema::var::count>(int32_t());
+    }
+    
+
+    
+} // namespace tests
@@ -58,6 +58,15 @@ inline T Deserialize(Reader input, const RuntimeSchema& schema)
 }
 
 
+/// @brief Deserialize into an existing object from a protocol reader, reusing
+/// the memory held by the object
+template <typename Protocols = BuiltInProtocols, typename Reader, typename T>
+inline void DeserializeExisting(Reader input, T& obj)
+{
+    Apply<Protocols>(ToExisting<T, Protocols>(obj), bonded<T, Reader&>(input));
+}
+
+
 /// @brief Marshal an object using a protocol writer
 template <typename Protocols, typename T, typename Writer>
 inline void Marshal(const T& obj, Writer& output)
@@ -127,4 +136,223 @@ inline void Merge(const T& obj, Reader input, Writer& output)
     Apply<Protocols>(Merger<T, Writer, Protocols>(obj, output), bonded<T>(input));
 }
 
+
+namespace detail
+{
+
+// FindField is an optional protocol reader method implemented by protocols
+// with random access to fields of structs.
+template <typename Input, typename Enable = void> struct
+implements_find_field
+    : std::false_type {};
+
+
+template <typename Input> struct
+implements_find_field<Input,
+#ifdef BOND_NO_SFINAE_EXPR
+    typename boost::enable_if<check_method<bool (Input::*)(uint16_t, uint16_t, BondDataType&), &Input::FindField> >::type>
+#else
+    typename boost::enable_if<std::is_same<
+        bool,
+        decltype(std::declval<Input>().FindField(
+            std::declval<uint16_t>(),
+            std::declval<uint16_t>(),
+            std::declval<BondDataType&>()))>>::type>
+#endif
+    : std::true_type {};
+
+
+template <typename X>
+class FieldValueReader
+{
+public:
+    FieldValueReader(X& var)
+        : _var(var)
+    {}
+
+    template <typename T, typename Reader>
+    bool Field(uint16_t /*id*/, const Metadata& /*metadata*/, const value<T, Reader>& value) const
+    {
+        value.Deserialize(_var);
+        return false;
+    }
+
+private:
+    X& _var;
+};
+
+
+template <typename Field, typename Reader, typename X>
+typename boost::enable_if<is_basic_type<typename Field::field_type>, bool>::type
+inline ReadFieldValue(Reader& input, BondDataType type, X& var)
+{
+    if (type < BT_BOOL || type > BT_WSTRING
+        || type == BT_STRUCT || type == BT_LIST || type == BT_SET || type == BT_MAP
+        || !IsMatching<typename Field::field_type>(type))
+    {
+        return false;
+    }
+
+    BasicTypeField(Field::id, Field::metadata, type, FieldValueReader<X>(var), input);
+    return true;
+}
+
+
+template <typename Field, typename Reader, typename X>
+typename boost::disable_if<is_basic_type<typename Field::field_type>, bool>::type
+inline ReadFieldValue(Reader& input, BondDataType type, X& var)
+{
+    if (type != get_type_id<typename Field::field_type>::value)
+    {
+        return false;
+    }
+
+    GetFieldValue<Field>(input).Deserialize(var);
+    return true;
+}
+
+
+template <typename T, typename X>
+inline bool AssignFieldValue(const T& value, X& var)
+{
+    var = value;
+    return true;
+}
+
+
+template <typename T, typename X>
+inline bool AssignFieldValue(const maybe<T>& value, X& var)
+{
+    if (value.is_nothing())
+    {
+        return false;
+    }
+
+    var = value.value();
+    return true;
+}
+
+
+template <typename Field, typename T, typename Protocols, typename Reader, typename X>
+typename boost::enable_if<implements_find_field<Reader>, bool>::type
+inline GetField(Reader& input, X& var)
+{
+    // Level of the struct declaring the field in the hierarchy, 0 for the top-most base
+    const uint16_t level = hierarchy_depth<typename schema<typename Field::struct_type>::type>::value - 1;
+    BondDataType type;
+
+    return input.FindField(level, Field::id, type)
+        && ReadFieldValue<Field>(input, type, var);
+}
+
+
+// Deserializes a struct and records whether the payload contains the field
+// TargetField of it.
+template <typename TargetField, typename Protocols>
+class FieldFinder
+    : public bond::To<typename TargetField::struct_type, Protocols>
+{
+    typedef bond::To<typename TargetField::struct_type, Protocols> Transform;
+
+public:
+    FieldFinder(typename TargetField::struct_type& var, bool& found)
+        : Transform(var),
+          _found(found)
+    {}
+
+    using Transform::Field;
+
+    template <typename FieldT, typename X>
+    bool Field(const FieldT& field, const X& value) const
+    {
+        _found = _found || FieldT::id == TargetField::id;
+        return Transform::Field(field, value);
+    }
+
+private:
+    bool& _found;
+};
+
+
+template <typename Field, typename T, typename Protocols, typename Reader, typename X>
+typename boost::disable_if<implements_find_field<Reader>, bool>::type
+inline GetField(Reader& input, X& var)
+{
+    // The protocol doesn't support random access to fields, deserialize the
+    // struct declaring the field.
+    typedef typename Field::struct_type Struct;
+    Struct obj;
+    bool found = false;
+
+    Parse<Struct, Protocols>(FieldFinder<Field, Protocols>(obj, found), input, typename schema<Struct>::type(), nullptr, false);
+    return found && AssignFieldValue(Field::GetVariable(obj), var);
+}
+
+
+template <typename Field, typename T, typename Protocols, typename X>
+class FieldGetter
+{
+public:
+    FieldGetter(X& var)
+        : _var(var)
+    {}
+
+    template <typename Reader>
+    bool operator()(Reader& input) const
+    {
+        return GetField<Field, T, Protocols>(input, _var);
+    }
+
+    bool operator()(ValueReader& value) const
+    {
+        BOOST_ASSERT(value.pointer);
+        return AssignFieldValue(Field::GetVariable(*static_cast<const T*>(value.pointer)), _var);
+    }
+
+private:
+    X& _var;
+};
+
+
+template <typename Field, typename T, typename Protocols, typename X>
+inline bool GetField(ProtocolReader& input, X& var)
+{
+    if (auto&& result = input.template Visit<Protocols
+#if defined(BOND_NO_CXX14_RETURN_TYPE_DEDUCTION) || defined(BOND_NO_CXX14_GENERIC_LAMBDAS)
+        , bool
+#endif
+        >(FieldGetter<Field, T, Protocols, X>(var)))
+    {
+        return result.get();
+    }
+
+    UnknownProtocolException();
+}
+
+} // namespace detail
+
+
+/// @brief Deserialize a single field of a struct from bonded<T>
+///
+/// Protocols with random access to fields, such as Indexed Binary protocol,
+/// read the field using the index of the struct without parsing any other
+/// fields. Returns false and leaves `var` unchanged if the payload doesn't
+/// contain the field, e.g. because its default value was omitted, or if the
+/// field was serialized with a type that doesn't match `Field`.
+///
+/// Other protocols deserialize the struct declaring the field, and likewise
+/// return false and leave `var` unchanged for fields not in the payload.
+///
+/// `Field` is a field of T or of one of its bases, e.g.
+/// `Struct::Schema::var::field_name`.
+template <typename Field, typename Protocols, typename T, typename Reader>
+inline bool GetField(const bonded<T, Reader>& value, typename Field::field_type& var)
+{
+    BOOST_STATIC_ASSERT((std::is_base_of<typename Field::struct_type, T>::value));
+
+    typename std::remove_reference<Reader>::type input(value._data);
+
+    return detail::GetField<Field, T, Protocols>(input, var);
+}
+
 }
@@ -52,6 +52,9 @@ struct BuiltInProtocols;
 template <typename T, typename Protocols = BuiltInProtocols, typename Validator = RequiredFieldValiadator<T> >
 class To;
 
+template <typename T, typename Protocols = BuiltInProtocols, typename Validator = RequiredFieldValiadator<T> >
+class ToExisting;
+
 template <typename T, typename Enable = void> struct
 schema_for_passthrough;
 
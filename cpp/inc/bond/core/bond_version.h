@@ -24,6 +24,7 @@ namespace bond
 
     BOND_CONSTEXPR_OR_CONST uint16_t v1 = 0x0001;
     BOND_CONSTEXPR_OR_CONST uint16_t v2 = 0x0002;
+    BOND_CONSTEXPR_OR_CONST uint16_t v3 = 0x0003;
 
     template <typename T> struct
     default_version
@@ -55,6 +55,10 @@ is_marshaled_bonded
         && is_bonded<T>::value> {};
 
 
+template <typename Field, typename Protocols = BuiltInProtocols, typename T, typename Reader>
+inline bool GetField(const bonded<T, Reader>& value, typename Field::field_type& var);
+
+
 /// @brief Represents data for a struct T known at compile-time
 ///
 /// See [User's Manual](../../manual/bond_cpp.html#understanding-bondedt)
@@ -187,6 +191,16 @@ public:
         Apply<Protocols>(To<X, Protocols>(var), *this);
     }
 
+    /// @brief Deserialize to an existing object of type X, reusing the memory it holds
+    ///
+    /// Fields missing from the payload are reset to their default values, so
+    /// var doesn't need to be reset first.
+    template <typename Protocols = BuiltInProtocols, typename X>
+    void DeserializeExisting(X& var) const
+    {
+        Apply<Protocols>(ToExisting<X, Protocols>(var), *this);
+    }
+
     /// @brief Deserialize to a bonded<U>
     template <typename Protocols = BuiltInProtocols, typename U>
     typename boost::enable_if<is_marshaled_bonded<T, Reader, U> >::type
@@ -241,6 +255,9 @@ public:
     template <typename U, typename ReaderT>
     friend class bonded;
 
+    template <typename Field, typename Protocols, typename U, typename ReaderT>
+    friend bool GetField(const bonded<U, ReaderT>& value, typename Field::field_type& var);
+
 private:
     // Apply transform to serialized data
     template <typename Protocols, typename Transform>
@@ -107,6 +107,14 @@ public:
     }
 
 
+    /// @brief Deserialize to an existing object of type T, reusing the memory it holds
+    template <typename Protocols = BuiltInProtocols, typename T>
+    void DeserializeExisting(T& var) const
+    {
+        Apply<Protocols>(ToExisting<T, Protocols>(var), *this);
+    }
+
+
     /// @brief Deserialize to a bonded<T>
     template <typename Protocols = BuiltInProtocols, typename T>
     typename boost::enable_if<uses_marshaled_bonded<Reader, T> >::type
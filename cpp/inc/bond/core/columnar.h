@@ -0,0 +1,600 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file */
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "bond.h"
+#include "detail/field_dispatch.h"
+#include "exception.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/mpl/begin_end.hpp>
+#include <boost/mpl/for_each.hpp>
+
+#include <vector>
+
+/*
+    Columnar layout of a vector of structs T
+    =========================================
+
+    The rows are written as a struct containing the number of rows and a struct
+    of columns. The struct of columns has the same hierarchy and field ids as T,
+    and the column of each field holds the values of the field in all the rows:
+
+    struct
+    {
+        0: uint32 count;
+        1: struct                                   // hierarchy of T
+        {
+            <id>: list<field type>                  // column of a field
+            <id>: struct                            // column of a maybe or nullable field
+            {
+                0: blob presence;                   // bit i set if row i has a value
+                1: list<value type> values;         // values of the rows that have one
+            }
+        };
+    }
+
+    Bits of the presence bitmap are numbered from the least significant bit of
+    the first byte. Field headers and element types are written once per column
+    instead of once per row, and values of each column are read in a single loop.
+*/
+
+namespace bond
+{
+
+namespace detail
+{
+
+// How values of a field are stored in its column. Fields which may not have a
+// value, i.e. maybe<T> and nullable<T>, are stored in sparse columns with the
+// values of only those rows that have one.
+template <typename T> struct
+column_traits
+{
+    typedef T value_type;
+
+    static const bool sparse = false;
+
+    static bool has_value(const T& /*var*/)
+    {
+        return true;
+    }
+
+    static const T& get(const T& var)
+    {
+        return var;
+    }
+
+    static T& set(T& var)
+    {
+        return var;
+    }
+};
+
+
+template <typename T> struct
+column_traits<maybe<T> >
+{
+    typedef T value_type;
+
+    static const bool sparse = true;
+
+    static bool has_value(const maybe<T>& var)
+    {
+        return !var.is_nothing();
+    }
+
+    static const T& get(const maybe<T>& var)
+    {
+        return var.value();
+    }
+
+    static T& set(maybe<T>& var)
+    {
+        return var.set_value();
+    }
+};
+
+
+template <typename T> struct
+column_traits<nullable<T> >
+{
+    typedef T value_type;
+
+    static const bool sparse = true;
+
+    static bool has_value(const nullable<T>& var)
+    {
+        return var.hasvalue();
+    }
+
+    static const T& get(const nullable<T>& var)
+    {
+        return var.value();
+    }
+
+    static T& set(nullable<T>& var)
+    {
+        return var.set();
+    }
+};
+
+
+// Values of Field in a vector of rows, serialized as a list container. The
+// values of a sparse column are those of the rows listed in the index.
+template <typename Field, typename Rows>
+class column
+{
+public:
+    typedef column_traits<typename Field::value_type> traits;
+    typedef typename traits::value_type value_type;
+
+    explicit column(Rows& rows, const std::vector<uint32_t>* index = nullptr)
+        : _rows(rows),
+          _index(index),
+          _size(static_cast<uint32_t>(index ? index->size() : rows.size()))
+    {}
+
+    uint32_t size() const
+    {
+        return _size;
+    }
+
+    const value_type& get(uint32_t i) const
+    {
+        return traits::get(Field::GetVariable(_rows[row(i)]));
+    }
+
+    value_type& set(uint32_t i) const
+    {
+        return traits::set(Field::GetVariable(_rows[row(i)]));
+    }
+
+private:
+    uint32_t row(uint32_t i) const
+    {
+        return _index ? (*_index)[i] : i;
+    }
+
+    Rows& _rows;
+    const std::vector<uint32_t>* _index;
+    uint32_t _size;
+};
+
+
+// Container functions of the column are found by argument dependent lookup
+template <typename Field, typename Rows>
+inline uint32_t container_size(const column<Field, Rows>& list)
+{
+    return list.size();
+}
+
+
+// Columns are read into rows allocated beforehand, so the number of values in
+// the payload must be the number of rows that have a value of the field.
+template <typename Field, typename Rows>
+inline void resize_list(column<Field, Rows>& list, uint32_t size)
+{
+    if (size != list.size())
+    {
+        ColumnSizeException(size, list.size());
+    }
+}
+
+} // namespace detail
+
+
+template <typename Field, typename Rows> struct
+is_list_container<detail::column<Field, Rows> >
+    : std::true_type {};
+
+
+template <typename Field, typename Rows>
+class const_enumerator<detail::column<Field, Rows> >
+{
+public:
+    explicit const_enumerator(const detail::column<Field, Rows>& list)
+        : _list(list),
+          _i(0)
+    {}
+
+    bool more() const
+    {
+        return _i != _list.size();
+    }
+
+    const typename detail::column<Field, Rows>::value_type& next()
+    {
+        return _list.get(_i++);
+    }
+
+private:
+    const detail::column<Field, Rows>& _list;
+    uint32_t _i;
+};
+
+
+template <typename Field, typename Rows>
+class enumerator<detail::column<Field, Rows> >
+{
+public:
+    explicit enumerator(detail::column<Field, Rows>& list)
+        : _list(list),
+          _i(0)
+    {}
+
+    bool more() const
+    {
+        return _i != _list.size();
+    }
+
+    typename detail::column<Field, Rows>::value_type& next()
+    {
+        return _list.set(_i++);
+    }
+
+private:
+    detail::column<Field, Rows>& _list;
+    uint32_t _i;
+};
+
+
+namespace detail
+{
+
+template <typename Protocols, typename Writer, typename Rows>
+class ColumnsWriter
+{
+public:
+    ColumnsWriter(Writer& output, const Rows& rows)
+        : _output(output),
+          _rows(rows)
+    {}
+
+    void Write() const
+    {
+        typedef typename schema<typename Rows::value_type>::type Schema;
+
+        _output.WriteStructBegin(Schema::metadata, false);
+
+        _output.WriteFieldBegin(BT_UINT32, 0);
+        _output.Write(static_cast<uint32_t>(_rows.size()));
+        _output.WriteFieldEnd();
+
+        _output.WriteFieldBegin(BT_STRUCT, 1);
+        WriteColumns<Schema>(false);
+        _output.WriteFieldEnd();
+
+        _output.WriteStructEnd(false);
+    }
+
+    template <typename Field>
+    void operator()(const Field&) const
+    {
+        WriteColumn<Field>(std::integral_constant<bool, column_traits<typename Field::value_type>::sparse>());
+    }
+
+private:
+    template <typename Schema>
+    void WriteColumns(bool base) const
+    {
+        _output.WriteStructBegin(Schema::metadata, base);
+        WriteBaseColumns(base_class<Schema>());
+        boost::mpl::for_each<typename Schema::fields>(*this);
+        _output.WriteStructEnd(base);
+    }
+
+    template <typename Base>
+    void WriteBaseColumns(const Base*) const
+    {
+        WriteColumns<typename schema<Base>::type>(true);
+    }
+
+    void WriteBaseColumns(const no_base*) const
+    {}
+
+    // Columns are written by the Serializer, so the values use the same
+    // encoding as elements of a list field.
+    template <typename Field>
+    void WriteColumn(std::false_type) const
+    {
+        Serializer<Writer, Protocols>(_output).UnknownField(Field::id, column<Field, const Rows>(_rows));
+    }
+
+    template <typename Field>
+    void WriteColumn(std::true_type) const
+    {
+        const uint32_t size = static_cast<uint32_t>(_rows.size());
+        const uint32_t length = (size + 7) / 8;
+
+        // The output may keep a reference to the blob instead of copying it
+        boost::shared_ptr<char[]> presence(boost::make_shared<char[]>(length));
+        std::vector<uint32_t> index;
+
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            if (column_traits<typename Field::value_type>::has_value(Field::GetVariable(_rows[i])))
+            {
+                presence[i >> 3] |= static_cast<char>(1 << (i & 7));
+                index.push_back(i);
+            }
+        }
+
+        Serializer<Writer, Protocols> serializer(_output);
+
+        _output.WriteFieldBegin(BT_STRUCT, Field::id);
+        _output.WriteStructBegin(Field::metadata, false);
+        serializer.UnknownField(0, blob(presence, length));
+        serializer.UnknownField(1, column<Field, const Rows>(_rows, &index));
+        _output.WriteStructEnd(false);
+        _output.WriteFieldEnd();
+    }
+
+    Writer& _output;
+    const Rows& _rows;
+};
+
+
+template <typename Protocols, typename Reader, typename Rows>
+class ColumnsReader
+{
+public:
+    ColumnsReader(Reader& input, Rows& rows)
+        : _input(input),
+          _rows(rows),
+          _type(BT_STOP)
+    {}
+
+    void Read()
+    {
+        BondDataType type;
+        uint16_t id;
+
+        _rows.clear();
+
+        detail::StructBegin(_input, false);
+
+        for (_input.ReadFieldBegin(type, id); type != BT_STOP; _input.ReadFieldEnd(), _input.ReadFieldBegin(type, id))
+        {
+            if (id == 0 && type == BT_UINT32)
+            {
+                uint32_t count;
+                _input.Read(count);
+                bond::resize_list(_rows, count);
+            }
+            else if (id == 1 && type == BT_STRUCT)
+            {
+                ReadColumns<typename schema<typename Rows::value_type>::type>(false);
+            }
+            else
+            {
+                _input.Skip(type);
+            }
+        }
+
+        _input.ReadFieldEnd();
+
+        detail::StructEnd(_input, false);
+    }
+
+    template <typename Field>
+    void operator()(const Field&)
+    {
+        ReadColumn<Field>(std::integral_constant<bool, column_traits<typename Field::value_type>::sparse>());
+    }
+
+private:
+    // Returns true if the payload ends before the level of Schema in the
+    // hierarchy, i.e. it has fewer levels than the rows.
+    template <typename Schema>
+    bool ReadColumns(bool base)
+    {
+        BondDataType type = BT_STOP;
+        uint16_t id;
+
+        detail::StructBegin(_input, base);
+
+        bool done = ReadBaseColumns(base_class<Schema>());
+
+        if (!done)
+        {
+            // Columns of levels of the payload that are deeper than the rows
+            // follow the end of the top level and are skipped, rather than
+            // matched against the fields of the rows by id.
+            bool deeper = false;
+
+            for (_input.ReadFieldBegin(type, id);
+                 type != BT_STOP && (type != BT_STOP_BASE || !base);
+                 _input.ReadFieldEnd(), _input.ReadFieldBegin(type, id))
+            {
+                _type = type;
+
+                if (type == BT_STOP_BASE)
+                {
+                    deeper = true;
+                }
+                else if (deeper
+                    || !detail::DispatchField<typename boost::mpl::begin<typename Schema::fields>::type>(id, *this))
+                {
+                    _input.Skip(type);
+                }
+            }
+
+            _input.ReadFieldEnd();
+
+            done = base && type == BT_STOP;
+        }
+
+        detail::StructEnd(_input, base);
+
+        return done;
+    }
+
+    template <typename Base>
+    bool ReadBaseColumns(const Base*)
+    {
+        return ReadColumns<typename schema<Base>::type>(true);
+    }
+
+    bool ReadBaseColumns(const no_base*)
+    {
+        return false;
+    }
+
+    template <typename Field>
+    void ReadColumn(std::false_type)
+    {
+        if (_type == BT_LIST)
+        {
+            ReadValues<Field>(nullptr);
+        }
+        else
+        {
+            _input.Skip(_type);
+        }
+    }
+
+    template <typename Field>
+    void ReadColumn(std::true_type)
+    {
+        if (_type != BT_STRUCT)
+        {
+            _input.Skip(_type);
+            return;
+        }
+
+        std::vector<uint32_t> index;
+        BondDataType type;
+        uint16_t id;
+
+        detail::StructBegin(_input, false);
+
+        for (_input.ReadFieldBegin(type, id); type != BT_STOP; _input.ReadFieldEnd(), _input.ReadFieldBegin(type, id))
+        {
+            if (id == 0 && type == BT_LIST)
+            {
+                ReadPresence(index);
+            }
+            else if (id == 1 && type == BT_LIST)
+            {
+                ReadValues<Field>(&index);
+            }
+            else
+            {
+                _input.Skip(type);
+            }
+        }
+
+        _input.ReadFieldEnd();
+
+        detail::StructEnd(_input, false);
+    }
+
+    // Reads the presence bitmap into the index of the rows that have a value
+    void ReadPresence(std::vector<uint32_t>& index)
+    {
+        const uint32_t size = static_cast<uint32_t>(_rows.size());
+        blob presence;
+
+        value<blob, Reader&>(_input, false).template Deserialize<Protocols>(presence);
+
+        if (presence.length() != (size + 7) / 8)
+        {
+            ColumnSizeException(presence.length(), (size + 7) / 8);
+        }
+
+        const uint8_t* bits = reinterpret_cast<const uint8_t*>(presence.content());
+
+        index.clear();
+
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            if (bits[i >> 3] & (1 << (i & 7)))
+            {
+                index.push_back(i);
+            }
+        }
+    }
+
+    template <typename Field>
+    void ReadValues(const std::vector<uint32_t>* index)
+    {
+        typedef column<Field, Rows> Column;
+
+        Column values(_rows, index);
+
+        value<Column, Reader&>(_input, false).template Deserialize<Protocols>(values);
+    }
+
+    Reader& _input;
+    Rows& _rows;
+    BondDataType _type;
+};
+
+
+template <typename Protocols, typename Writer, typename Rows>
+typename boost::disable_if<need_double_pass<Serializer<Writer, Protocols> > >::type
+inline WriteColumns(const Rows& rows, Writer& output)
+{
+    ColumnsWriter<Protocols, Writer, Rows>(output, rows).Write();
+}
+
+
+template <typename Protocols, typename Writer, typename Rows>
+typename boost::enable_if<need_double_pass<Serializer<Writer, Protocols> > >::type
+inline WriteColumns(const Rows& rows, Writer& output)
+{
+    if (output.NeedPass0())
+    {
+        typename Writer::Pass0::Buffer buffer;
+        typename Writer::Pass0 pass0(buffer, output);
+
+        ColumnsWriter<Protocols, typename Writer::Pass0, Rows>(pass0, rows).Write();
+
+        // The writer uses the data collected by pass0 until the end of the full expression
+        output.WithPass0(pass0), ColumnsWriter<Protocols, Writer, Rows>(output, rows).Write();
+    }
+    else
+    {
+        ColumnsWriter<Protocols, Writer, Rows>(output, rows).Write();
+    }
+}
+
+} // namespace detail
+
+
+/// @brief Serialize a vector of structs in columnar layout
+///
+/// Each field of the struct is written as a column of the values of the field
+/// in all the elements, which is more compact and faster to read than a list
+/// of structs when the vector has many small elements. Values of `maybe` and
+/// `nullable` fields are written only for the elements that have one, along
+/// with a bitmap of those elements. Requires a tagged protocol, such as
+/// Compact Binary or Fast Binary. The data is read using DeserializeColumns.
+template <typename Protocols = BuiltInProtocols, typename T, typename A, typename Writer>
+inline void SerializeColumns(const std::vector<T, A>& rows, Writer& output)
+{
+    BOOST_STATIC_ASSERT(!uses_static_parser<typename Writer::Reader>::value);
+
+    detail::WriteColumns<Protocols>(rows, output);
+}
+
+
+/// @brief Deserialize a vector of structs serialized using SerializeColumns
+///
+/// Replaces the content of `rows` and fills the fields of the elements one
+/// column at a time. Columns of fields that are not in T, or whose values don't
+/// match the type of the field, are skipped.
+template <typename Protocols = BuiltInProtocols, typename Reader, typename T, typename A>
+inline void DeserializeColumns(Reader input, std::vector<T, A>& rows)
+{
+    BOOST_STATIC_ASSERT(!uses_static_parser<Reader>::value);
+
+    detail::ColumnsReader<Protocols, Reader, std::vector<T, A> >(input, rows).Read();
+}
+
+} // namespace bond
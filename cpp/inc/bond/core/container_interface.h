@@ -46,6 +46,14 @@ is_wstring
     : std::false_type {};
 
 
+// Strings which are deserialized by referencing the string data in the input
+// buffer rather than copying it. Specialize for custom read-only strings that
+// are constructible from a blob.
+template <typename T> struct
+use_blob_for_string
+    : std::false_type {};
+
+
 template <typename T> struct
 element_type
 {
@@ -96,14 +104,26 @@ void modify_element(T& list, E& element, F deserialize);
 template <typename T>
 void clear_set(T& set);
 
+template <typename T>
+void reserve_set(T& set, uint32_t size);
+
 template <typename S, typename T>
 void set_insert(S& set, const T& item);
 
+template <typename S, typename F>
+void insert_set_items(S& set, uint32_t size, F deserialize);
+
 template <typename T>
 void clear_map(T& map);
 
+template <typename T>
+void reserve_map(T& map, uint32_t size);
+
 template <typename M, typename K, typename T>
 T& mapped_at(M& map, const K& key);
+
+template <typename M, typename F, typename G>
+void insert_map_elements(M& map, uint32_t size, F deserialize_key, G deserialize_value);
 #endif
 
 //
@@ -122,6 +142,19 @@ uint32_t string_length(const T& str);
 
 template<typename T>
 void resize_string(T& str, uint32_t size);
+
+template<typename T>
+void resize_string_for_overwrite(T& str, uint32_t size);
 #endif
 
+
+// Resize a string whose content is going to be overwritten, e.g. by reading
+// the string data from the input. Overload for custom strings that can resize
+// without initializing the new characters; by default calls resize_string.
+template <typename T>
+inline void resize_string_for_overwrite(T& str, uint32_t size)
+{
+    resize_string(str, size);
+}
+
 } // namespace bond
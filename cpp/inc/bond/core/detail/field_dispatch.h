@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "mpl.h"
+
+#include <boost/mpl/begin_end.hpp>
+#include <boost/mpl/deref.hpp>
+#include <boost/mpl/list.hpp>
+#include <boost/mpl/next.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace bond
+{
+namespace detail
+{
+
+// Converts the fields from the boost::mpl::list iterator Fields to the end of
+// the list into a detail::mpl::list.
+template <typename Fields> struct
+field_list
+    : mpl::append<mpl::list<typename boost::mpl::deref<Fields>::type>,
+                  typename field_list<typename boost::mpl::next<Fields>::type>::type> {};
+
+template <> struct
+field_list<boost::mpl::l_iter<boost::mpl::l_end> >
+    : mpl::identity<mpl::list<> > {};
+
+
+template <typename... Fields> struct
+field_id_range;
+
+template <typename Field> struct
+field_id_range<Field>
+{
+    static const uint16_t min_id = Field::id;
+    static const uint16_t max_id = Field::id;
+};
+
+template <typename Field, typename... Rest> struct
+field_id_range<Field, Rest...>
+{
+    static const uint16_t min_id = Field::id < field_id_range<Rest...>::min_id ? Field::id : field_id_range<Rest...>::min_id;
+    static const uint16_t max_id = Field::id > field_id_range<Rest...>::max_id ? Field::id : field_id_range<Rest...>::max_id;
+};
+
+
+// Decides whether fields are looked up by id in a table rather than by
+// comparing the id with that of each field in turn. Tables are used for
+// lists of at least 8 fields whose ids are dense enough to keep the table
+// within 64 bytes per field.
+template <typename List> struct
+use_field_table
+    : std::false_type {};
+
+template <typename... Fields> struct
+use_field_table<mpl::list<Fields...> >
+    : std::integral_constant<bool,
+        (sizeof...(Fields) >= 8
+        && static_cast<size_t>(field_id_range<Fields...>::max_id - field_id_range<Fields...>::min_id) < 32 * sizeof...(Fields))> {};
+
+template <> struct
+use_field_table<mpl::list<> >
+    : std::false_type {};
+
+
+// Maps the ids of Fields to handlers that call F with the field.
+template <typename F, typename... Fields>
+class field_table
+{
+public:
+    typedef void (*handler)(F& f);
+
+    // Returns the handler for the field with the given id or nullptr if there
+    // is no such field.
+    static handler find(uint16_t id)
+    {
+        static const field_table table;
+
+        if (id < range::min_id || id > range::max_id)
+        {
+            return nullptr;
+        }
+
+        const uint16_t slot = table._slots[id - range::min_id];
+        return slot ? table._handlers[slot - 1] : nullptr;
+    }
+
+private:
+    typedef field_id_range<Fields...> range;
+
+    field_table()
+        : _slots(),
+          _handlers{ &invoke<Fields>... }
+    {
+        const uint16_t ids[] = { Fields::id... };
+
+        for (uint16_t i = 0; i < sizeof...(Fields); ++i)
+        {
+            _slots[ids[i] - range::min_id] = static_cast<uint16_t>(i + 1);
+        }
+    }
+
+    template <typename Field>
+    static void invoke(F& f)
+    {
+        f(Field());
+    }
+
+    // One-based index into _handlers of the field with id range::min_id + i,
+    // or 0 if there is no such field.
+    uint16_t _slots[range::max_id - range::min_id + 1];
+    handler _handlers[sizeof...(Fields)];
+};
+
+
+template <typename F>
+inline bool DispatchField(uint16_t /*id*/, F& /*f*/, const mpl::list<>&, std::false_type)
+{
+    return false;
+}
+
+
+template <typename F, typename Field, typename... Rest>
+inline bool DispatchField(uint16_t id, F& f, const mpl::list<Field, Rest...>&, std::false_type)
+{
+    if (id == Field::id)
+    {
+        f(Field());
+        return true;
+    }
+
+    return DispatchField(id, f, mpl::list<Rest...>(), std::false_type());
+}
+
+
+template <typename F, typename... Fields>
+inline bool DispatchField(uint16_t id, F& f, const mpl::list<Fields...>&, std::true_type)
+{
+    if (auto handler = field_table<F, Fields...>::find(id))
+    {
+        handler(f);
+        return true;
+    }
+
+    return false;
+}
+
+
+// Calls f with the field that has the given id among the fields from the
+// boost::mpl::list iterator Fields to the end of the list. Returns false
+// when there is no such field.
+//
+// Short or sparse lists of fields are searched linearly, others through a
+// table indexed by field id built on first use.
+template <typename Fields, typename F>
+inline bool DispatchField(uint16_t id, F& f)
+{
+    typedef typename field_list<Fields>::type list;
+
+    return DispatchField(id, f, list(), use_field_table<list>());
+}
+
+} // namespace detail
+
+} // namespace bond
@@ -193,7 +193,7 @@ VariantGet(const bond::Variant& variant, T& var)
     BOOST_ASSERT(!variant.nothing);
 
     const size_t size = variant.string_value.size();
-    resize_string(var, static_cast<uint32_t>(size));
+    resize_string_for_overwrite(var, static_cast<uint32_t>(size));
 
     std::copy(
         variant.string_value.begin(),
@@ -210,7 +210,7 @@ VariantGet(const bond::Variant& variant, T& var)
     BOOST_ASSERT(!variant.nothing);
 
     const size_t size = variant.wstring_value.size();
-    resize_string(var, static_cast<uint32_t>(size));
+    resize_string_for_overwrite(var, static_cast<uint32_t>(size));
 
     std::copy(
         variant.wstring_value.begin(),
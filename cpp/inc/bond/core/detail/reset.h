@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "../blob.h"
+#include "../container_interface.h"
+#include "../maybe.h"
+#include "../reflection.h"
+#include "../scalar_interface.h"
+
+#include <boost/mpl/for_each.hpp>
+
+namespace bond
+{
+namespace detail
+{
+
+template <typename T>
+typename boost::enable_if<has_schema<T> >::type
+inline ResetToDefault(T& var);
+
+
+// default for maybe<T> is 'nothing'
+template <typename T>
+inline void ResetToDefault(maybe<T>& var, const Metadata& /*metadata*/)
+{
+    var.set_nothing();
+}
+
+
+// basic fields, including strings, get the default value from metadata
+template <typename T>
+typename boost::enable_if_c<is_basic_type<T>::value
+                        && !is_type_alias<T>::value>::type
+inline ResetToDefault(T& var, const Metadata& metadata)
+{
+    VariantGet(metadata.default_value, var);
+}
+
+
+template <typename T>
+typename boost::enable_if<is_type_alias<T> >::type
+inline ResetToDefault(T& var, const Metadata& metadata)
+{
+    typename aliased_type<T>::type value(get_aliased_value(var));
+
+    VariantGet(metadata.default_value, value);
+    set_aliased_value(var, value);
+}
+
+
+// for containers default value is always empty
+inline void ResetToDefault(blob& var, const Metadata& /*metadata*/)
+{
+    var.clear();
+}
+
+
+template <typename T>
+typename boost::enable_if<is_list_container<T> >::type
+inline ResetToDefault(T& var, const Metadata& /*metadata*/)
+{
+    resize_list(var, 0);
+}
+
+
+template <typename T>
+typename boost::enable_if<is_set_container<T> >::type
+inline ResetToDefault(T& var, const Metadata& /*metadata*/)
+{
+    clear_set(var);
+}
+
+
+template <typename T>
+typename boost::enable_if<is_map_container<T> >::type
+inline ResetToDefault(T& var, const Metadata& /*metadata*/)
+{
+    clear_map(var);
+}
+
+
+template <typename T>
+typename boost::enable_if<has_schema<T> >::type
+inline ResetToDefault(T& var, const Metadata& /*metadata*/)
+{
+    ResetToDefault(var);
+}
+
+
+template <typename T>
+typename boost::enable_if<is_bonded<T> >::type
+inline ResetToDefault(T& var, const Metadata& /*metadata*/)
+{
+    var = T();
+}
+
+
+template <typename T>
+class FieldReset
+{
+public:
+    explicit FieldReset(T& var)
+        : _var(var)
+    {}
+
+    template <typename Field>
+    void operator()(const Field&) const
+    {
+        ResetToDefault(Field::GetVariable(_var), Field::metadata);
+    }
+
+private:
+    T& _var;
+};
+
+
+template <typename T>
+typename boost::enable_if<has_base<T> >::type
+inline ResetBase(T& var)
+{
+    ResetToDefault(static_cast<typename schema<T>::type::base&>(var));
+}
+
+
+template <typename T>
+typename boost::disable_if<has_base<T> >::type
+inline ResetBase(T& /*var*/)
+{}
+
+
+// Resets the fields of a struct, and of its base, to their default values.
+// The fields are reset in place rather than assigned from a new instance,
+// which keeps the memory allocated by strings and containers so that it can
+// be reused, and doesn't construct the struct, which might require an
+// allocator that isn't default constructible.
+template <typename T>
+typename boost::enable_if<has_schema<T> >::type
+inline ResetToDefault(T& var)
+{
+    ResetBase(var);
+    boost::mpl::for_each<typename schema<T>::type::fields>(FieldReset<T>(var));
+}
+
+
+// Lists of structs, lists of lists of structs and so on.
+template <typename T, typename Enable = void> struct
+has_reusable_elements
+    : std::false_type {};
+
+
+template <typename T> struct
+has_reusable_elements<T, typename boost::enable_if<is_list_container<T> >::type>
+    : std::integral_constant<bool,
+        has_schema<typename element_type<T>::type>::value
+        || has_reusable_elements<typename element_type<T>::type>::value> {};
+
+
+// Prepares the elements that a list keeps when it is deserialized into, so
+// that they can be reused: struct elements are reset to default values and
+// lists of structs are prepared in turn. Other elements are overwritten by
+// deserialization anyway.
+template <typename T>
+typename boost::enable_if<has_schema<T> >::type
+inline ResetElements(T& var)
+{
+    ResetToDefault(var);
+}
+
+
+template <typename T>
+typename boost::enable_if<has_reusable_elements<T> >::type
+inline ResetElements(T& var)
+{
+    for (enumerator<T> items(var); items.more();)
+        ResetElements(items.next());
+}
+
+
+template <typename T>
+typename boost::disable_if_c<has_schema<T>::value
+                          || has_reusable_elements<T>::value>::type
+inline ResetElements(T& /*var*/)
+{}
+
+} // namespace detail
+} // namespace bond
@@ -167,6 +167,83 @@ struct StreamException
 };
 
 
+BOND_NORETURN inline void MalformedStructIndexException(uint32_t length, uint32_t count)
+{
+    BOND_THROW(StreamException,
+        "Malformed struct index with " << count << " entries in struct of length " << length);
+}
+
+
+BOND_NORETURN inline void PackedIntegersWidthException(uint8_t width)
+{
+    BOND_THROW(StreamException,
+        "Malformed packed integers with width of " << static_cast<uint32_t>(width) << " bits");
+}
+
+
+BOND_NORETURN inline void PackedIntegersLengthException()
+{
+    BOND_THROW(StreamException,
+        "Malformed packed integers not matching their length");
+}
+
+
+BOND_NORETURN inline void StringIdException(uint32_t id, uint32_t count)
+{
+    BOND_THROW(StreamException,
+        "Reference to string " << id << " when " << count << " strings are defined");
+}
+
+
+BOND_NORETURN inline void MalformedBlockException(uint8_t codec)
+{
+    BOND_THROW(StreamException,
+        "Malformed block compressed with codec " << static_cast<uint32_t>(codec));
+}
+
+
+BOND_NORETURN inline void UnknownBlockCodecException(uint8_t codec)
+{
+    BOND_THROW(StreamException,
+        "Block compressed with unknown codec " << static_cast<uint32_t>(codec));
+}
+
+
+BOND_NORETURN inline void BlockChecksumException(uint64_t offset)
+{
+    BOND_THROW(StreamException,
+        "Checksum mismatch of block at offset " << offset);
+}
+
+
+BOND_NORETURN inline void MalformedRecordContainerException(const char* reason)
+{
+    BOND_THROW(StreamException,
+        "Malformed record container: " << reason);
+}
+
+
+BOND_NORETURN inline void RecordIndexException(uint32_t record)
+{
+    BOND_THROW(StreamException,
+        "Record index doesn't match the data at record " << record);
+}
+
+
+BOND_NORETURN inline void ColumnSizeException(uint32_t size, uint32_t expected)
+{
+    BOND_THROW(StreamException,
+        "Malformed columnar data with column of " << size << " values where " << expected << " are expected");
+}
+
+
+BOND_NORETURN inline void OutputReserveException()
+{
+    BOND_THROW(StreamException,
+        "Output buffer doesn't support reserving space for values written later");
+}
+
+
 struct SchemaValidateException
     : CoreException
 {
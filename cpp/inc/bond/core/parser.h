@@ -5,6 +5,7 @@
 
 #include <bond/core/config.h>
 
+#include "detail/field_dispatch.h"
 #include "detail/inheritance.h"
 #include "detail/omit_default.h"
 #include "detail/parser_utils.h"
@@ -18,6 +19,8 @@
 #include <bond/protocol/simple_binary_impl.h>
 #include <bond/protocol/simple_json_reader_impl.h>
 
+#include <algorithm>
+
 namespace bond
 {
 
@@ -258,7 +261,15 @@ private:
     // use compile-time schema
     template <typename Fields, typename Transform>
     void
-    ReadFields(const Fields&, uint16_t& id, BondDataType& type, const Transform& transform)
+    ReadFields(const Fields& fields, uint16_t& id, BondDataType& type, const Transform& transform)
+    {
+        ReadFields(fields, fields, id, type, transform);
+    }
+
+
+    template <typename AllFields, typename Fields, typename Transform>
+    void
+    ReadFields(const AllFields& all, const Fields&, uint16_t& id, BondDataType& type, const Transform& transform)
     {
         typedef typename boost::mpl::deref<Fields>::type Head;
 
@@ -271,8 +282,8 @@ private:
             }
             else if (Head::id >= id && type != bond::BT_STOP && type != bond::BT_STOP_BASE)
             {
-                // Unknown field or non-exact type match
-                UnknownFieldOrTypeMismatch<is_basic_type<typename Head::field_type>::value>(
+                // Unknown field, field out of order or non-exact type match
+                UnknownFieldOrTypeMismatch<is_basic_type<typename Head::field_type>::value, AllFields>(
                     Head::id,
                     Head::metadata,
                     id,
@@ -289,19 +300,19 @@ private:
 
             if (Head::id < id || type == bond::BT_STOP || type == bond::BT_STOP_BASE)
             {
-                NextSchemaField: return ReadFields(typename boost::mpl::next<Fields>::type(), id, type, transform);
+                NextSchemaField: return ReadFields(all, typename boost::mpl::next<Fields>::type(), id, type, transform);
             }
         }
     }
 
 
-    template <typename Transform>
+    template <typename AllFields, typename Transform>
     void
-    ReadFields(const boost::mpl::l_iter<boost::mpl::l_end>&, uint16_t& id, BondDataType& type, const Transform& transform)
+    ReadFields(const AllFields&, const boost::mpl::l_iter<boost::mpl::l_end>&, uint16_t& id, BondDataType& type, const Transform& transform)
     {
         for (; type != bond::BT_STOP && type != bond::BT_STOP_BASE; ReadSubsequentField(type, id))
         {
-            UnknownField(id, type, transform);
+            OutOfOrderField<AllFields>(id, type, transform);
         }
     }
 
@@ -309,16 +320,19 @@ private:
     // This function is called only when payload has unknown field id or type is not
     // matching exactly. This relativly rare so we don't inline the function to help
     // the compiler to optimize the common path.
-    template <bool IsBasicType, typename Transform>
+    template <bool IsBasicType, typename AllFields, typename Transform>
     BOND_NO_INLINE
     typename boost::enable_if_c<IsBasicType, bool>::type
     UnknownFieldOrTypeMismatch(uint16_t expected_id, const Metadata& metadata, uint16_t id, BondDataType type, const Transform& transform)
     {
-        if (id == expected_id &&
-            type != bond::BT_LIST &&
-            type != bond::BT_SET &&
-            type != bond::BT_MAP &&
-            type != bond::BT_STRUCT)
+        if (id != expected_id)
+        {
+            return OutOfOrderField<AllFields>(id, type, transform);
+        }
+        else if (type != bond::BT_LIST &&
+                 type != bond::BT_SET &&
+                 type != bond::BT_MAP &&
+                 type != bond::BT_STRUCT)
         {
             return detail::BasicTypeField(expected_id, metadata, type, transform, _input);
         }
@@ -328,15 +342,70 @@ private:
         }
     }
 
-    template <bool IsBasicType, typename Transform>
+    template <bool IsBasicType, typename AllFields, typename Transform>
     BOND_NO_INLINE
     typename boost::disable_if_c<IsBasicType, bool>::type
-    UnknownFieldOrTypeMismatch(uint16_t /*expected_id*/, const Metadata& /*metadata*/, uint16_t id, BondDataType type, const Transform& transform)
+    UnknownFieldOrTypeMismatch(uint16_t expected_id, const Metadata& /*metadata*/, uint16_t id, BondDataType type, const Transform& transform)
     {
+        if (id != expected_id)
+        {
+            return OutOfOrderField<AllFields>(id, type, transform);
+        }
+        else
+        {
+            return UnknownField(id, type, transform);
+        }
+    }
+
+
+    // Reads a field that doesn't match the current schema field. Such a field
+    // is either unknown or was written out of the schema order, in which case
+    // it is looked up among all the schema fields by its id.
+    template <typename AllFields, typename Transform>
+    bool OutOfOrderField(uint16_t id, BondDataType type, const Transform& transform)
+    {
+        OutOfOrderFieldReader<Transform> reader = { *this, type, transform, false };
+
+        if (detail::DispatchField<AllFields>(id, reader))
+        {
+            return reader.done;
+        }
+
         return UnknownField(id, type, transform);
     }
 
 
+    template <typename Transform>
+    struct OutOfOrderFieldReader
+    {
+        template <typename Field>
+        void operator()(const Field& field)
+        {
+            if (get_type_id<typename Field::field_type>::value == type)
+            {
+                done = detail::NonBasicTypeField(field, transform, parser._input);
+            }
+            else if (is_basic_type<typename Field::field_type>::value &&
+                     type != bond::BT_LIST &&
+                     type != bond::BT_SET &&
+                     type != bond::BT_MAP &&
+                     type != bond::BT_STRUCT)
+            {
+                done = detail::BasicTypeField(Field::id, Field::metadata, type, transform, parser._input);
+            }
+            else
+            {
+                done = parser.UnknownField(Field::id, type, transform);
+            }
+        }
+
+        DynamicParser& parser;
+        const BondDataType type;
+        const Transform& transform;
+        bool done;
+    };
+
+
     // use runtime schema
     template <typename Transform>
     void
@@ -357,21 +426,40 @@ private:
                 break;
             }
 
+            const FieldDef* field = nullptr;
+
             if (it != end && it->id == id)
             {
-                const FieldDef& field = *it++;
+                field = &*it++;
+            }
+            else
+            {
+                // The field is either unknown or precedes the current schema
+                // field because it was written out of the schema order. Fields
+                // of the schema are ordered by id, like the compile-time ones,
+                // so the passed fields are searched in logarithmic time.
+                auto found = std::lower_bound(fields.begin(), it, id,
+                    [](const FieldDef& f, uint16_t field_id) { return f.id < field_id; });
+
+                if (found != it && found->id == id)
+                {
+                    field = &*found;
+                }
+            }
 
+            if (field)
+            {
                 if (type == bond::BT_STRUCT || type == bond::BT_LIST || type == bond::BT_SET || type == bond::BT_MAP)
                 {
-                    if (field.type.id == type)
+                    if (field->type.id == type)
                     {
-                        detail::NonBasicTypeField(field, schema, transform, _input);
+                        detail::NonBasicTypeField(*field, schema, transform, _input);
                         continue;
                     }
                 }
                 else
                 {
-                    detail::BasicTypeField(id, field.metadata, type, transform, _input);
+                    detail::BasicTypeField(id, field->metadata, type, transform, _input);
                     continue;
                 }
             }
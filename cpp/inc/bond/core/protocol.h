@@ -14,6 +14,7 @@
 
 #include <bond/protocol/compact_binary.h>
 #include <bond/protocol/fast_binary.h>
+#include <bond/protocol/indexed_binary.h>
 #include <bond/protocol/simple_binary.h>
 #include <bond/protocol/simple_json_reader.h>
 #include <bond/stream/input_buffer.h>
@@ -50,6 +51,12 @@ is_protocol_enabled<FastBinaryReader<Buffer> >
     : std::true_type {};
 #endif
 
+#ifdef BOND_INDEXED_BINARY_PROTOCOL
+template <typename Buffer> struct
+is_protocol_enabled<IndexedBinaryReader<Buffer> >
+    : std::true_type {};
+#endif
+
 // uses_static_parser
 template <typename Reader, typename Enable = void> struct
 uses_static_parser
@@ -142,7 +149,8 @@ struct BuiltInProtocols
         CompactBinaryReader<InputBuffer>,
         SimpleBinaryReader<InputBuffer>,
         FastBinaryReader<InputBuffer>,
-        SimpleJsonReader<InputBuffer> > {};
+        SimpleJsonReader<InputBuffer>,
+        IndexedBinaryReader<InputBuffer> > {};
 
 
 struct ValueReader
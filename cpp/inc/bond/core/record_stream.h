@@ -0,0 +1,223 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file */
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "bond.h"
+
+#include <bond/protocol/compact_binary.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+
+/*
+    Record stream
+    =============
+
+    A sequence of records, each a struct serialized using Compact Binary v2 or
+    v3, followed by the strings it defines:
+
+                     .--------.---------.   .--------.---------.
+   stream            | record | strings |...| record | strings |
+                     '--------'---------'   '--------'---------'
+
+                     .--------.--------.   .--------.
+   strings           | header | string |...| string |
+                     '--------'--------'   '--------'
+
+   header            variable encoded uint32 (count << 1) | reset, where count is
+                     the number of strings defined by the record and reset is 1
+                     if the record is a reset point
+
+   string            length and UTF-8 code units of the string, as in Compact
+                     Binary
+
+    Strings in the records are written as variable encoded uint32 (length << 1)
+    followed by the code units, or as (id << 1) | 1 referencing a string
+    defined by the record or a preceding record. Ids are assigned in order of
+    definition, from 0 at every reset point, so reading of the stream can start
+    at any reset point.
+*/
+
+namespace bond
+{
+
+/// @brief Default maximum number of strings defined by a record stream
+/// between reset points
+BOND_CONSTEXPR_OR_CONST uint32_t record_stream_max_strings = 0x10000;
+
+
+/// @brief Writer of a stream of records which defines each string once
+/// and references it in the following records
+template <typename Buffer>
+class RecordWriter
+    : boost::noncopyable
+{
+public:
+    /// @brief Construct from output buffer/stream
+    ///
+    /// @param output output buffer/stream
+    /// @param max_strings maximum number of strings defined between reset
+    /// points; further strings are written in the records
+    /// @param version version of Compact Binary, v2 or later
+    explicit
+    RecordWriter(Buffer& output,
+                 uint32_t max_strings = record_stream_max_strings,
+                 uint16_t version = v2)
+        : _writer(output, version),
+          _ids(max_strings),
+          _reset(true)
+    {
+        BOOST_ASSERT(v2 <= version);
+        BOOST_ASSERT(max_strings <= 0x7fffffff);
+
+        _writer._strings = &_ids;
+    }
+
+    /// @brief Write a record, which can be an object or bonded<T>
+    template <typename T>
+    void Write(const T& record)
+    {
+        Serialize(record, _writer);
+
+        const uint32_t reset = _reset ? 1 : 0;
+        std::deque<std::string>::const_iterator it = _ids.Added();
+        const uint32_t count = static_cast<uint32_t>(_ids.End() - it);
+
+        _writer.Write((count << 1) | reset);
+
+        for (; it != _ids.End(); ++it)
+        {
+            const uint32_t length = static_cast<uint32_t>(it->size());
+
+            _writer.Write(length);
+            _writer.GetBuffer().Write(it->data(), length);
+        }
+
+        _reset = false;
+    }
+
+    /// @brief Make the next record a reset point, which doesn't reference
+    /// strings defined by the preceding records
+    void Reset()
+    {
+        _ids.Clear();
+        _reset = true;
+    }
+
+    /// @brief Access to underlying buffer
+    Buffer& GetBuffer()
+    {
+        return _writer.GetBuffer();
+    }
+
+private:
+    CompactBinaryWriter<Buffer> _writer;
+    detail::StringIds _ids;
+    bool _reset;
+};
+
+
+/// @brief Reader of a stream of records written by RecordWriter
+///
+/// Strings of the records read into bond::string_ref share the input buffer,
+/// and every occurrence of a string defined once references the same data.
+template <typename Buffer>
+class RecordReader
+{
+public:
+    typedef CompactBinaryReader<Buffer> Reader;
+
+    /// @brief Construct from input buffer/stream positioned at the start of
+    /// the stream or at a reset point
+    explicit
+    RecordReader(typename boost::call_traits<Buffer>::param_type input,
+                 uint16_t version = v2)
+        : _reader(input, version)
+    {
+        BOOST_ASSERT(v2 <= version);
+    }
+
+    /// @brief Read the next record, reusing the memory held by the object
+    ///
+    /// @return false at the end of the stream
+    template <typename T>
+    bool Read(T& record)
+    {
+        if (_reader.GetBuffer().IsEof())
+        {
+            return false;
+        }
+
+        DeserializeExisting(Next(), record);
+        return true;
+    }
+
+    /// @brief Read the next record as bonded<T>, which can be deserialized
+    /// after the following records are read, also on other threads
+    ///
+    /// @return false at the end of the stream
+    template <typename T>
+    bool Read(bonded<T>& record)
+    {
+        if (_reader.GetBuffer().IsEof())
+        {
+            return false;
+        }
+
+        record = bonded<T>(Next());
+        return true;
+    }
+
+    /// @brief Access to underlying buffer
+    typename boost::call_traits<Buffer>::const_reference
+    GetBuffer() const
+    {
+        return _reader.GetBuffer();
+    }
+
+private:
+    // Returns reader of the next record and reads the strings it defines
+    Reader Next()
+    {
+        Reader record(_reader);
+
+        _reader.Skip(BT_STRUCT);
+
+        uint32_t header;
+        _reader.Read(header);
+
+        // Readers of the preceding records keep the strings they reference.
+        // The table is never changed while one of them, e.g. in a bonded<T>,
+        // shares it: the strings are added to a copy instead.
+        if ((header & 1) || !_strings)
+        {
+            _strings = boost::make_shared<detail::StringTable>();
+        }
+        else if ((header >> 1) && _strings.use_count() != 1)
+        {
+            _strings = boost::make_shared<detail::StringTable>(*_strings);
+        }
+
+        for (uint32_t count = header >> 1; count; --count)
+        {
+            uint32_t length;
+            blob data;
+
+            _reader.Read(length);
+            _reader.Read(data, length);
+            _strings->Add(data);
+        }
+
+        record._strings = _strings;
+        return record;
+    }
+
+    Reader _reader;
+    boost::shared_ptr<detail::StringTable> _strings;
+};
+
+} // namespace bond
@@ -6,6 +6,7 @@
 #include <bond/core/config.h>
 
 #include "container_interface.h"
+#include "detail/mpl.h"
 #include "traits.h"
 
 #include <boost/utility/enable_if.hpp>
@@ -122,6 +123,20 @@ void resize_string(std::basic_string<C, T, A>& str, uint32_t size)
 }
 
 
+// resize_string_for_overwrite
+template<typename C, typename T, typename A>
+inline
+void resize_string_for_overwrite(std::basic_string<C, T, A>& str, uint32_t size)
+{
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    // The characters are overwritten by the caller, so skip initializing them.
+    str.resize_and_overwrite(size, [](C*, std::size_t n) { return n; });
+#else
+    str.resize(size);
+#endif
+}
+
+
 // container_size
 template <typename T>
 inline
@@ -196,6 +211,22 @@ void modify_element(std::vector<bool, A>&,
 }
 
 
+// has_reserve
+template <typename T, typename Enable = void> struct
+has_reserve
+    : std::false_type {};
+
+
+template <typename T> struct
+has_reserve<T,
+#ifdef BOND_NO_SFINAE_EXPR
+    typename boost::enable_if<check_method<void (T::*)(typename T::size_type), &T::reserve> >::type>
+#else
+    detail::mpl::void_t<decltype(std::declval<T&>().reserve(std::declval<typename T::size_type>()))> >
+#endif
+    : std::true_type {};
+
+
 // clear_set
 template <typename T, typename C, typename A>
 inline
@@ -205,12 +236,51 @@ void clear_set(std::set<T, C, A>& set)
 }
 
 
+// reserve_set
+// Containers with a reserve member, such as flat sets, make room for all the
+// items read before the first one is inserted.
+template <typename T>
+inline
+typename boost::enable_if<has_reserve<T> >::type
+reserve_set(T& set, uint32_t size)
+{
+    set.reserve(size);
+}
+
+
+template <typename T>
+inline
+typename boost::disable_if<has_reserve<T> >::type
+reserve_set(T& /*set*/, uint32_t /*size*/)
+{}
+
+
 // set_insert
+// Using the end of the set as a hint makes inserting items that arrive in
+// sorted order, e.g. written from a std::set, take amortized constant time.
+// Items in any other order are inserted in logarithmic time as without it.
 template <typename T, typename C, typename A>
 inline
 void set_insert(std::set<T, C, A>& set, const T& item)
 {
-    set.insert(item);
+    set.insert(set.end(), item);
+}
+
+
+// insert_set_items
+// Inserts the items read into a set one at a time. Containers that can
+// insert many items at once more efficiently, such as flat sets, overload it.
+template <typename S, typename F>
+inline
+void insert_set_items(S& set, uint32_t size, F deserialize)
+{
+    typename element_type<S>::type item(make_element(set));
+
+    while (size--)
+    {
+        deserialize(item);
+        set_insert(set, item);
+    }
 }
 
 
@@ -223,6 +293,23 @@ void clear_map(std::map<K, T, C, A>& map)
 }
 
 
+// reserve_map
+template <typename T>
+inline
+typename boost::enable_if<has_reserve<T> >::type
+reserve_map(T& map, uint32_t size)
+{
+    map.reserve(size);
+}
+
+
+template <typename T>
+inline
+typename boost::disable_if<has_reserve<T> >::type
+reserve_map(T& /*map*/, uint32_t /*size*/)
+{}
+
+
 // use_map_allocator_for_keys
 template <typename T, typename Enable = void> struct
 use_map_allocator_for_keys
@@ -287,11 +374,14 @@ make_value(T& map)
 
 
 // mapped_at
+// Using the end of the map as a hint makes inserting keys that arrive in
+// sorted order, e.g. written from a std::map, take amortized constant time.
+// Keys in any other order are inserted in logarithmic time as without it.
 template <typename K, typename T, typename C, typename A>
 inline
 T& mapped_at(std::map<K, T, C, A>& map, const K& key)
 {
-    return map.insert(typename std::map<K, T, C, A>::value_type(key, make_value(map))).first->second;
+    return map.insert(map.end(), typename std::map<K, T, C, A>::value_type(key, make_value(map)))->second;
 }
 
 template <typename K, typename T, typename C, typename A>
@@ -307,6 +397,32 @@ const T& mapped_at(const std::map<K, T, C, A>& map, const K& key)
 }
 
 
+// insert_map_elements
+// Inserts the elements read into a map one at a time. Containers that can
+// insert many elements at once more efficiently, such as flat maps,
+// overload it.
+template <typename M, typename F, typename G>
+inline
+void insert_map_elements(M& map, uint32_t size, F deserialize_key, G deserialize_value)
+{
+    typename element_type<M>::type::first_type key(make_key(map));
+
+    while (size--)
+    {
+        deserialize_key(key);
+
+#ifndef NDEBUG
+        // In debug build To<T> asserts that optional fields are set to default
+        // values before deserialization; if invalid map payload contains duplicate
+        // keys the second time we deserialize a value it will trigger the assert.
+        deserialize_value(mapped_at(map, key) = make_value(map));
+#else
+        deserialize_value(mapped_at(map, key));
+#endif
+    }
+}
+
+
 // enumerators
 template <typename T>
 class const_enumerator
@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file */
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "blob.h"
+#include "container_interface.h"
+
+#include <boost/make_shared.hpp>
+
+#include <stdint.h>
+#include <cstring>
+#include <string>
+
+namespace bond
+{
+
+/// @brief Read-only string referencing a memory buffer
+///
+/// When deserialized from a binary protocol, the string references the
+/// string data in the input buffer instead of copying it: the content is a
+/// range of the input blob, and the buffer is held alive for as long as the
+/// string exists if the input blob owns its memory. If the input blob was
+/// constructed from a raw pointer the application must keep the memory
+/// alive while the string is in use.
+///
+/// Protocols which can't reference the input, such as Simple JSON, and
+/// default values allocate a buffer owned by the string.
+class string_ref
+{
+public:
+    typedef char value_type;
+    typedef const char* const_iterator;
+
+    /// @brief Default constructor
+    string_ref()
+    {}
+
+    /// @brief Construct from a null-terminated string
+    ///
+    /// The string is referenced, not copied.
+    string_ref(const char* str)
+        : _data(str, static_cast<uint32_t>(std::strlen(str)))
+    {}
+
+    /// @brief Construct from a pointer and length
+    ///
+    /// The string is referenced, not copied.
+    string_ref(const char* str, uint32_t length)
+        : _data(str, length)
+    {}
+
+    /// @brief Construct from a blob, sharing the blob's buffer
+    explicit string_ref(const blob& data)
+        : _data(data)
+    {}
+
+    /// @brief Pointer to the string data, not null-terminated
+    const char* data() const
+    {
+        return _data.content();
+    }
+
+    /// @brief Length of the string
+    uint32_t length() const
+    {
+        return _data.length();
+    }
+
+    /// @brief Length of the string
+    uint32_t size() const
+    {
+        return _data.length();
+    }
+
+    /// @brief Check if the string is empty
+    bool empty() const
+    {
+        return _data.empty();
+    }
+
+    const char& operator[](uint32_t index) const
+    {
+        return data()[index];
+    }
+
+    /// @brief Iterator for the beginning of the string
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    /// @brief Iterator for the end of the string
+    const_iterator end() const
+    {
+        return data() + length();
+    }
+
+    /// @brief Return the blob holding the string data
+    const blob& get_blob() const
+    {
+        return _data;
+    }
+
+    /// @brief Copy the string into a std::string
+    std::string str() const
+    {
+        return std::string(data(), length());
+    }
+
+    /// @brief Compare with another string, like std::string::compare
+    int compare(const string_ref& other) const
+    {
+        const uint32_t length = this->length() < other.length() ? this->length() : other.length();
+        const int result = length ? std::memcmp(data(), other.data(), length) : 0;
+
+        return result != 0 ? result
+            : this->length() < other.length() ? -1
+            : this->length() > other.length() ? 1 : 0;
+    }
+
+    void swap(string_ref& other)
+    {
+        _data.swap(other._data);
+    }
+
+    friend void resize_string(string_ref& str, uint32_t size);
+
+private:
+    blob _data;
+};
+
+
+template <> struct
+is_string<string_ref>
+    : std::true_type {};
+
+
+template <> struct
+use_blob_for_string<string_ref>
+    : std::true_type {};
+
+
+// Empty strings have no buffer, so a pointer to a static character is returned
+// for them rather than nullptr, which memcpy and the like don't accept even for
+// zero length.
+inline const char* string_data(const string_ref& str)
+{
+    return str.empty() ? "" : str.data();
+}
+
+
+// Only valid after resize_string, which allocates a buffer owned by the string.
+inline char* string_data(string_ref& str)
+{
+    static char empty;
+    return str.empty() ? &empty : const_cast<char*>(str.data());
+}
+
+
+inline uint32_t string_length(const string_ref& str)
+{
+    return str.length();
+}
+
+
+inline void resize_string(string_ref& str, uint32_t size)
+{
+    if (size == 0)
+    {
+        str._data.clear();
+    }
+    else
+    {
+        boost::shared_ptr<char[]> buffer = boost::make_shared_noinit<char[]>(size);
+        str._data.assign(buffer, size);
+    }
+}
+
+
+inline void swap(string_ref& x, string_ref& y)
+{
+    x.swap(y);
+}
+
+
+inline bool operator==(const string_ref& x, const string_ref& y)
+{
+    return x.length() == y.length()
+        && (x.empty() || 0 == std::memcmp(x.data(), y.data(), x.length()));
+}
+
+inline bool operator!=(const string_ref& x, const string_ref& y)
+{
+    return !(x == y);
+}
+
+inline bool operator<(const string_ref& x, const string_ref& y)
+{
+    return x.compare(y) < 0;
+}
+
+inline bool operator>(const string_ref& x, const string_ref& y)
+{
+    return y < x;
+}
+
+inline bool operator<=(const string_ref& x, const string_ref& y)
+{
+    return !(y < x);
+}
+
+inline bool operator>=(const string_ref& x, const string_ref& y)
+{
+    return !(x < y);
+}
+
+} // namespace bond
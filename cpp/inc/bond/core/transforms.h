@@ -8,16 +8,28 @@
 #include "bond_fwd.h"
 #include "detail/debug.h"
 #include "detail/double_pass.h"
+#include "detail/field_dispatch.h"
 #include "detail/marshaled_bonded.h"
 #include "detail/odr.h"
 #include "detail/omit_default.h"
+#include "detail/reset.h"
 #include "detail/tags.h"
 #include "exception.h"
 #include "null.h"
 #include "reflection.h"
 
+#include <boost/mpl/distance.hpp>
+#include <boost/mpl/find.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/size.hpp>
 #include <boost/static_assert.hpp>
 
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+#include <map>
+#include <vector>
+
 namespace bond
 {
 
@@ -472,12 +484,6 @@ protected:
     {
         AssignToVar<Protocols>(var.set_value(), value);
     }
-
-    template <typename X>
-    bool AssignToField(const boost::mpl::l_iter<boost::mpl::l_end>&, uint16_t /*id*/, const X& /*value*/) const
-    {
-        return false;
-    }
 };
 
 } // namespace detail
@@ -529,21 +535,21 @@ public:
     template <typename Reader, typename X>
     bool Field(uint16_t id, const Metadata& /*metadata*/, const bonded<X, Reader>& value) const
     {
-        return AssignToField(typename boost::mpl::begin<typename nested_fields<T>::type>::type(), id, value);
+        return AssignToField<typename boost::mpl::begin<typename nested_fields<T>::type>::type>(*this, id, value);
     }
 
 
     template <typename Reader, typename X>
     bool Field(uint16_t id, const Metadata& /*metadata*/, const value<X, Reader>& value) const
     {
-        return AssignToField(typename boost::mpl::begin<typename matching_fields<T, X>::type>::type(), id, value);
+        return AssignToField<typename boost::mpl::begin<typename matching_fields<T, X>::type>::type>(*this, id, value);
     }
 
 
     template <typename Reader>
     bool Field(uint16_t id, const Metadata& /*metadata*/, const value<void, Reader>& value) const
     {
-        return AssignToField(typename boost::mpl::begin<typename container_fields<T>::type>::type(), id, value);
+        return AssignToField<typename boost::mpl::begin<typename container_fields<T>::type>::type>(*this, id, value);
     }
 
 
@@ -561,7 +567,6 @@ public:
 
 private:
     using detail::To::AssignToVar;
-    using detail::To::AssignToField;
 
     template <typename X, typename U = T>
     typename boost::enable_if<has_base<U>, bool>::type
@@ -584,19 +589,27 @@ private:
         return false;
     }
 
-    template <typename Fields, typename X>
-    bool AssignToField(const Fields&, uint16_t id, const X& value) const
+protected:
+    template <typename Transform, typename X>
+    struct FieldAssigner
     {
-        typedef typename boost::mpl::deref<Fields>::type Head;
-
-        if (id == Head::id)
-        {
-            return Field(Head(), value);
-        }
-        else
+        template <typename FieldT>
+        void operator()(const FieldT& field) const
         {
-            return AssignToField(typename boost::mpl::next<Fields>::type(), id, value);
+            transform.Field(field, value);
         }
+
+        const Transform& transform;
+        const X& value;
+    };
+
+    template <typename Fields, typename Transform, typename X>
+    static bool AssignToField(const Transform& transform, uint16_t id, const X& value)
+    {
+        const FieldAssigner<Transform, X> assign = { transform, value };
+
+        detail::DispatchField<Fields>(id, assign);
+        return false;
     }
 
     BOND_NORETURN void UnexpectedStructStopException() const
@@ -613,6 +626,173 @@ private:
 };
 
 
+// Deserializes into an existing object, reusing the memory it holds.
+//
+// Unlike To, ToExisting doesn't require the object to be in its default
+// state. The fields that are present in the payload are deserialized over
+// the current values, so that strings and containers keep their capacity,
+// list elements are reused and map and set nodes with matching keys are
+// kept. At the end, the fields that were not in the payload are reset to
+// their default values, making the result the same as if the object had
+// been default constructed first.
+template <typename T, typename Protocols, typename Validator>
+class ToExisting
+    : public To<T, Protocols, Validator>
+{
+    typedef To<T, Protocols, Validator> Base_;
+    typedef typename schema<T>::type::fields fields;
+
+public:
+    BOOST_STATIC_ASSERT(has_schema<T>::value);
+
+    ToExisting(T& var)
+        : Base_(var),
+          _base(false)
+    {}
+
+    void Begin(const Metadata& /*metadata*/) const
+    {
+        _assigned.reset();
+        _base = false;
+        Validator::Begin();
+    }
+
+    void End() const
+    {
+        ResetBase();
+        boost::mpl::for_each<fields>(UnassignedFieldReset{ *this });
+        Base_::End();
+    }
+
+    template <typename X>
+    bool Base(const X& value) const
+    {
+        _base = true;
+        return AssignToBase(value);
+    }
+
+    using Base_::Field;
+
+    template <typename Reader, typename X>
+    bool Field(uint16_t id, const Metadata& /*metadata*/, const bonded<X, Reader>& value) const
+    {
+        return Base_::template AssignToField<typename boost::mpl::begin<typename nested_fields<T>::type>::type>(*this, id, value);
+    }
+
+
+    template <typename Reader, typename X>
+    bool Field(uint16_t id, const Metadata& /*metadata*/, const value<X, Reader>& value) const
+    {
+        return Base_::template AssignToField<typename boost::mpl::begin<typename matching_fields<T, X>::type>::type>(*this, id, value);
+    }
+
+
+    template <typename Reader>
+    bool Field(uint16_t id, const Metadata& /*metadata*/, const value<void, Reader>& value) const
+    {
+        return Base_::template AssignToField<typename boost::mpl::begin<typename container_fields<T>::type>::type>(*this, id, value);
+    }
+
+
+    template <typename FieldT, typename X>
+    bool Field(const FieldT&, const X& value) const
+    {
+        Validator::template Validate<FieldT>();
+        _assigned.set(field_index<FieldT>::value);
+        AssignToExisting(FieldT::GetVariable(this->_var), value);
+        return false;
+    }
+
+private:
+    template <typename FieldT> struct
+    field_index
+        : boost::mpl::distance<
+            typename boost::mpl::begin<fields>::type,
+            typename boost::mpl::find<fields, FieldT>::type> {};
+
+    struct UnassignedFieldReset
+    {
+        template <typename FieldT>
+        void operator()(const FieldT&) const
+        {
+            if (!transform._assigned.test(field_index<FieldT>::value))
+            {
+                detail::ResetToDefault(FieldT::GetVariable(transform._var), FieldT::metadata);
+            }
+        }
+
+        const ToExisting& transform;
+    };
+
+    // Nested structs are deserialized into in turn.
+    template <typename V, typename X>
+    typename boost::enable_if<has_schema<V> >::type
+    AssignToExisting(V& var, const X& value) const
+    {
+        Apply<Protocols>(ToExisting<V, Protocols>(var), value);
+    }
+
+    // The elements that containers keep are reset so that they can be
+    // deserialized into.
+    template <typename V, typename X>
+    typename boost::disable_if<has_schema<V> >::type
+    AssignToExisting(V& var, const X& value) const
+    {
+        detail::ResetElements(var);
+        value.template Deserialize<Protocols>(var);
+    }
+
+    template <typename V, typename X>
+    void AssignToExisting(maybe<V>& var, const X& value) const
+    {
+        AssignToExisting(var.set_value(), value);
+    }
+
+    template <typename X, typename U = T>
+    typename boost::enable_if<has_base<U>, bool>::type
+    AssignToBase(const X& value) const
+    {
+        bool done = Apply<Protocols>(ToExisting<typename schema<T>::type::base, Protocols>(this->_var), value);
+
+        if (done)
+        {
+            this->UnexpectedStructStopException();
+        }
+
+        return false;
+    }
+
+    template <typename X, typename U = T>
+    typename boost::disable_if<has_base<U>, bool>::type
+    AssignToBase(const X& /*value*/) const
+    {
+        return false;
+    }
+
+    // Resets the base part of the object when the payload doesn't have it.
+    template <typename U = T>
+    typename boost::enable_if<has_base<U> >::type
+    ResetBase() const
+    {
+        typedef typename schema<T>::type::base BaseT;
+
+        if (!_base)
+        {
+            detail::ResetToDefault(static_cast<BaseT&>(this->_var));
+        }
+    }
+
+    template <typename U = T>
+    typename boost::disable_if<has_base<U> >::type
+    ResetBase() const
+    {}
+
+    mutable std::bitset<boost::mpl::size<fields>::value> _assigned;
+    mutable bool _base;
+};
+
+
+
 struct Mapping;
 
 typedef std::vector<uint16_t> Path;
@@ -626,6 +806,145 @@ struct Mapping
 
 BOND_STATIC_CONSTEXPR uint16_t mapping_base = invalid_field_id;
 
+//
+// CompiledMappings holds Mappings converted into flat arrays of the source
+// fields, indexed by id unless the ids are sparse, so that MapTo<T> doesn't
+// search a std::map for each input field. It is built once, doesn't refer to the Mappings it was built from,
+// and may be used by any number of MapTo<T> transforms at the same time.
+//
+class CompiledMappings
+{
+public:
+    explicit CompiledMappings(const Mappings& mappings)
+    {
+        Add(mappings);
+    }
+
+private:
+    template <typename T, typename Protocols>
+    friend class MapTo;
+
+    BOND_STATIC_CONSTEXPR uint32_t none = 0xFFFFFFFF;
+
+    struct Entry
+    {
+        // Index into _paths of the destination path, or none.
+        uint32_t path = none;
+
+        // Index into _levels of the mappings of the fields of a nested
+        // struct, or none.
+        uint32_t fields = none;
+    };
+
+    // The mappings of the fields of one struct in the source. Entries are
+    // indexed by id when the mapped ids are dense, and otherwise ordered by
+    // id and found by binary search in ids.
+    struct Level
+    {
+        const Entry* find(uint16_t id) const
+        {
+            if (ids.empty())
+            {
+                const size_t offset = static_cast<size_t>(id - first);
+
+                return id >= first && offset < entries.size() ? &entries[offset] : nullptr;
+            }
+
+            std::vector<uint16_t>::const_iterator it = std::lower_bound(ids.begin(), ids.end(), id);
+
+            return it != ids.end() && *it == id ? &entries[it - ids.begin()] : nullptr;
+        }
+
+        // Id of the field mapped by entries[0].
+        uint16_t first = 0;
+        std::vector<Entry> entries;
+
+        // Ids of the entries when they are sparse.
+        std::vector<uint16_t> ids;
+
+        // Index into _levels of the mappings of the base struct, or none.
+        uint32_t base = none;
+    };
+
+    uint32_t Add(const Mappings& mappings)
+    {
+        const uint32_t index = static_cast<uint32_t>(_levels.size());
+        _levels.emplace_back();
+
+        Mappings::const_iterator end = mappings.find(mapping_base);
+
+        if (end != mappings.end())
+        {
+            // mapping_base is the largest id, so it is the last mapping.
+            const uint32_t base = Add(end->second.fields);
+            _levels[index].base = base;
+        }
+
+        if (mappings.begin() == end)
+        {
+            return index;
+        }
+
+        const uint16_t first = mappings.begin()->first;
+        const uint32_t range = std::prev(end)->first - first + 1u;
+        const uint32_t count = static_cast<uint32_t>(std::distance(mappings.begin(), end));
+
+        // A table indexed by id is used when at most about half of its
+        // entries are unused, so that sparse ids don't allocate an entry for
+        // every id in their range.
+        const bool dense = range <= 2 * count + 8;
+
+        _levels[index].first = first;
+        _levels[index].entries.resize(dense ? range : count);
+
+        if (!dense)
+        {
+            _levels[index].ids.reserve(count);
+        }
+
+        for (Mappings::const_iterator it = mappings.begin(); it != end; ++it)
+        {
+            Entry entry;
+
+            if (!it->second.path.empty())
+            {
+                entry.path = static_cast<uint32_t>(_paths.size());
+                _paths.push_back(it->second.path);
+            }
+
+            if (!it->second.fields.empty())
+            {
+                entry.fields = Add(it->second.fields);
+            }
+
+            if (dense)
+            {
+                _levels[index].entries[it->first - first] = entry;
+            }
+            else
+            {
+                _levels[index].entries[_levels[index].ids.size()] = entry;
+                _levels[index].ids.push_back(it->first);
+            }
+        }
+
+        return index;
+    }
+
+    const Level& level(uint32_t index) const
+    {
+        return _levels[index];
+    }
+
+    const Path& path(uint32_t index) const
+    {
+        return _paths[index];
+    }
+
+    std::vector<Level> _levels;
+    std::vector<Path> _paths;
+};
+
 //
 // MapTo<T> maps the input fields onto an instance of a static bond type T,
 // using provided mappings from field path in the source to field path in
@@ -695,7 +1014,10 @@ protected:
     template <typename Protocols, typename V, typename X>
     bool AssignToNested(V& var, const PathView& ids, const X& value) const
     {
-        return AssignToNested<Protocols>(typename boost::mpl::begin<typename struct_fields<V>::type>::type(), var, ids, value);
+        NestedAssigner<Protocols, V, X> assign = { *this, var, ids, value, false };
+
+        detail::DispatchField<typename boost::mpl::begin<typename struct_fields<V>::type>::type>(*ids.current, assign);
+        return assign.done;
     }
 
 
@@ -713,22 +1035,36 @@ protected:
     }
 
 
-    template <typename Protocols, typename Nested, typename V, typename X>
-    bool AssignToNested(const Nested&, V& var, const PathView& ids, const X& value) const
+    template <typename Protocols, typename V, typename X>
+    struct NestedAssigner
     {
-        typedef typename boost::mpl::deref<Nested>::type Head;
+        template <typename Field>
+        void operator()(const Field&)
+        {
+            done = transform.template Assign<Protocols>(Field::GetVariable(var), PathView(ids.path, ids.current + 1), value);
+        }
+
+        const MapTo& transform;
+        V& var;
+        const PathView& ids;
+        const X& value;
+        bool done;
+    };
 
-        if (*ids.current == Head::id)
-            return Assign<Protocols>(Head::GetVariable(var), PathView(ids.path, ids.current + 1), value);
-        else
-            return AssignToNested<Protocols>(typename boost::mpl::next<Nested>::type(), var, ids, value);
-    }
 
     template <typename Protocols, typename V, typename X>
-    bool AssignToNested(const boost::mpl::l_iter<boost::mpl::l_end>&, V& /*var*/, const PathView& /*ids*/, const X& /*value*/) const
+    struct FieldAssigner
     {
-        return false;
-    }
+        template <typename Field>
+        void operator()(const Field&) const
+        {
+            transform.template AssignToVar<Protocols>(Field::GetVariable(var), value);
+        }
+
+        const MapTo& transform;
+        V& var;
+        const X& value;
+    };
 
 
     // Separate AssignToField overloads for bonded<T>, basic types and containers allows us
@@ -758,23 +1094,9 @@ protected:
     template <typename Protocols, typename Fields, typename V, typename X>
     bool AssignToField(const Fields&, V& var, uint16_t id, const X& value) const
     {
-        typedef typename boost::mpl::deref<Fields>::type Head;
-
-        if (id == Head::id)
-        {
-            AssignToVar<Protocols>(Head::GetVariable(var), value);
-            return false;
-        }
-        else
-        {
-            return AssignToField<Protocols>(typename boost::mpl::next<Fields>::type(), var, id, value);
-        }
-    }
-
+        const FieldAssigner<Protocols, V, X> assign = { *this, var, value };
 
-    template <typename Protocols, typename V, typename X>
-    bool AssignToField(const boost::mpl::l_iter<boost::mpl::l_end>&, V& /*var*/, uint16_t /*id*/, const X& /*value*/) const
-    {
+        detail::DispatchField<Fields>(id, assign);
         return false;
     }
 
@@ -805,16 +1127,30 @@ public:
 
     MapTo(T& var, const Mappings& mappings)
         : _var(var),
-          _mappings(mappings)
+          _mappings(&mappings),
+          _compiled(nullptr),
+          _level(nullptr)
+    {}
+
+    MapTo(T& var, const CompiledMappings& mappings)
+        : MapTo(var, mappings, mappings.level(0))
     {}
 
 
     template <typename X>
     bool Base(const X& value) const
     {
-        Mappings::const_iterator it = _mappings.find(mapping_base);
+        if (_compiled)
+        {
+            if (_level->base != CompiledMappings::none)
+                return Apply<Protocols>(MapTo(_var, *_compiled, _compiled->level(_level->base)), value);
+            else
+                return false;
+        }
+
+        Mappings::const_iterator it = _mappings->find(mapping_base);
 
-        if (it != _mappings.end())
+        if (it != _mappings->end())
             return Apply<Protocols>(MapTo(_var, it->second.fields), value);
         else
             return false;
@@ -825,9 +1161,23 @@ public:
     {
         BOOST_ASSERT(id != mapping_base);
 
-        Mappings::const_iterator it = _mappings.find(id);
+        if (_compiled)
+        {
+            if (const CompiledMappings::Entry* entry = _level->find(id))
+            {
+                if (entry->fields != CompiledMappings::none)
+                    return Apply<Protocols>(MapTo(_var, *_compiled, _compiled->level(entry->fields)), value);
+
+                if (entry->path != CompiledMappings::none)
+                    return Assign<Protocols>(_var, _compiled->path(entry->path), value);
+            }
 
-        if (it != _mappings.end())
+            return false;
+        }
+
+        Mappings::const_iterator it = _mappings->find(id);
+
+        if (it != _mappings->end())
         {
             if (!it->second.fields.empty())
                 return Apply<Protocols>(MapTo(_var, it->second.fields), value);
@@ -844,9 +1194,19 @@ public:
     {
         BOOST_ASSERT(id != mapping_base);
 
-        Mappings::const_iterator it = _mappings.find(id);
+        if (_compiled)
+        {
+            const CompiledMappings::Entry* entry = _level->find(id);
 
-        if (it != _mappings.end() && !it->second.path.empty())
+            if (entry && entry->path != CompiledMappings::none)
+                return Assign<Protocols>(_var, _compiled->path(entry->path), value);
+            else
+                return false;
+        }
+
+        Mappings::const_iterator it = _mappings->find(id);
+
+        if (it != _mappings->end() && !it->second.path.empty())
             return Assign<Protocols>(_var, it->second.path, value);
         else
             return false;
@@ -855,8 +1215,17 @@ public:
 private:
     using detail::MapTo::Assign;
 
-    T&               _var;
-    const Mappings&  _mappings;
+    MapTo(T& var, const CompiledMappings& mappings, const CompiledMappings::Level& level)
+        : _var(var),
+          _mappings(nullptr),
+          _compiled(&mappings),
+          _level(&level)
+    {}
+
+    T&                                  _var;
+    const Mappings*                     _mappings;
+    const CompiledMappings*             _compiled;
+    const CompiledMappings::Level*      _level;
 };
 
 } // namespace bond
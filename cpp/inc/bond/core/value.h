@@ -5,11 +5,16 @@
 
 #include <bond/core/config.h>
 
+#include "detail/reset.h"
 #include "protocol.h"
 #include "schema.h"
 
 #include <boost/static_assert.hpp>
 
+#include <map>
+#include <set>
+#include <vector>
+
 namespace bond
 {
 
@@ -253,7 +258,18 @@ public:
     template <typename Protocols = BuiltInProtocols>
     void Deserialize(blob& var, uint32_t size) const
     {
-        BOOST_STATIC_ASSERT((std::is_same<T, blob::value_type>::value));
+        BOOST_STATIC_ASSERT((std::is_same<T, blob::value_type>::value
+                          || std::is_same<T, uint8_t>::value));
+        _skip = false;
+        _input.Read(var, size);
+    }
+
+
+    // deserialize series of bools to std::vector<bool>
+    template <typename Protocols = BuiltInProtocols, typename A>
+    void Deserialize(std::vector<bool, A>& var, uint32_t size) const
+    {
+        BOOST_STATIC_ASSERT((std::is_same<T, bool>::value));
         _skip = false;
         _input.Read(var, size);
     }
@@ -671,20 +687,113 @@ inline void DeserializeElements(blob& var, const value<blob::value_type, Reader&
 }
 
 
+// Lists of bytes are read with one bounds check and copied, instead of
+// initializing the elements and reading them one at a time.
+template <typename Protocols, typename T, typename A, typename Reader>
+typename boost::enable_if_c<std::is_same<T, int8_t>::value
+                         || std::is_same<T, uint8_t>::value>::type
+inline DeserializeElements(std::vector<T, A>& var, const value<T, Reader&>& element, uint32_t size)
+{
+    blob data;
+    element.template Deserialize<Protocols>(data, size);
+
+    const T* begin = reinterpret_cast<const T*>(data.content());
+    var.assign(begin, begin + data.length());
+}
+
+
+template <typename Reader, typename A, typename Enable = void> struct
+implements_bool_list_read
+    : std::false_type {};
+
+
+// Older compilers read lists of bools one element at a time
+#ifndef BOND_NO_SFINAE_EXPR
+template <typename Reader, typename A> struct
+implements_bool_list_read<Reader, A,
+    detail::mpl::void_t<decltype(std::declval<Reader&>().Read(
+        std::declval<std::vector<bool, A>&>(),
+        std::declval<uint32_t>()))> >
+    : std::true_type {};
+#endif
+
+
+// Lists of bools are passed to the reader of protocols which pack them, e.g.
+// Compact Binary v3, which unpacks the bits into the vector one at a time,
+// instead of being deserialized one element at a time.
+template <typename Protocols, typename A, typename Reader>
+typename boost::enable_if<implements_bool_list_read<Reader, A> >::type
+inline DeserializeElements(std::vector<bool, A>& var, const value<bool, Reader&>& element, uint32_t size)
+{
+    element.template Deserialize<Protocols>(var, size);
+}
+
+
+namespace detail
+{
+
+template <typename Protocols, typename T>
+struct DeserializeItem
+{
+    explicit DeserializeItem(const T& element)
+        : element(element)
+    {}
+
+    template <typename X>
+    void operator()(X& var) const
+    {
+        this->element.template Deserialize<Protocols>(var);
+    }
+
+    const T& element;
+};
+
+
 template <typename Protocols, typename X, typename T>
-typename boost::enable_if_c<is_set_container<X>::value
-                         && is_element_matching<T, X>::value>::type
-inline DeserializeElements(X& var, const T& element, uint32_t size)
+inline void ReadSetElements(X& var, const T& element, uint32_t size)
 {
     clear_set(var);
+    reserve_set(var, size);
+    insert_set_items(var, size, DeserializeItem<Protocols, T>(element));
+}
 
-    typename element_type<X>::type e(make_element(var));
+
+// Keeps the nodes of the items of a std::set that are also in the payload.
+// Items of the set that sort before the next one read are erased. When the
+// payload is sorted, e.g. written from a std::set, none of them is in the
+// payload, so every node whose item is read again is kept; otherwise erased
+// items that are read later are inserted again.
+template <typename Protocols, typename K, typename C, typename A, typename T>
+inline void ReadSetElements(std::set<K, C, A>& var, const T& element, uint32_t size)
+{
+    typename std::set<K, C, A>::iterator it = var.begin();
+    K e(make_element(var));
 
     while (size--)
     {
         element.template Deserialize<Protocols>(e);
-        set_insert(var, e);
+
+        while (it != var.end() && var.key_comp()(*it, e))
+            it = var.erase(it);
+
+        if (it != var.end() && !var.key_comp()(e, *it))
+            ++it;
+        else
+            var.insert(it, e);
     }
+
+    var.erase(it, var.end());
+}
+
+} // namespace detail
+
+
+template <typename Protocols, typename X, typename T>
+typename boost::enable_if_c<is_set_container<X>::value
+                         && is_element_matching<T, X>::value>::type
+inline DeserializeElements(X& var, const T& element, uint32_t size)
+{
+    detail::ReadSetElements<Protocols>(var, element, size);
 }
 
 
@@ -834,29 +943,64 @@ inline DeserializeContainer(X& var, const T& element, Reader& input)
 }
 
 
-template <typename Protocols, typename X, typename Key, typename T>
-typename boost::enable_if<is_map_key_matching<Key, X> >::type
-inline DeserializeMapElements(X& var, const Key& key, const T& element, uint32_t size)
+namespace detail
 {
-    BOOST_STATIC_ASSERT((is_map_element_matching<T, X>::value));
 
+template <typename Protocols, typename X, typename Key, typename T>
+inline void ReadMapElements(X& var, const Key& key, const T& element, uint32_t size)
+{
     clear_map(var);
+    reserve_map(var, size);
+    insert_map_elements(var, size, DeserializeItem<Protocols, Key>(key), DeserializeItem<Protocols, T>(element));
+}
 
-    typename element_type<X>::type::first_type k(make_key(var));
+
+// Keeps the nodes of the elements of a std::map whose keys are also in the
+// payload, deserializing the values into the existing ones. Elements whose
+// keys sort before the next key read are erased. When the payload is sorted,
+// e.g. written from a std::map, none of them is in the payload; otherwise
+// erased elements whose keys are read later are inserted again.
+template <typename Protocols, typename K, typename V, typename C, typename A, typename Key, typename T>
+inline void ReadMapElements(std::map<K, V, C, A>& var, const Key& key, const T& element, uint32_t size)
+{
+    typename std::map<K, V, C, A>::iterator it = var.begin();
+    K k(make_key(var));
 
     while (size--)
     {
         key.template Deserialize<Protocols>(k);
 
-#ifndef NDEBUG
-        // In debug build To<T> asserts that optional fields are set to default
-        // values before deserialization; if invalid map payload contains duplicate
-        // keys the second time we deserialize a value it will trigger the assert.
-        element.template Deserialize<Protocols>(mapped_at(var, k) = make_value(var));
-#else
-        element.template Deserialize<Protocols>(mapped_at(var, k));
-#endif
+        while (it != var.end() && var.key_comp()(it->first, k))
+            it = var.erase(it);
+
+        V* mapped;
+
+        if (it != var.end() && !var.key_comp()(k, it->first))
+        {
+            mapped = &(it++)->second;
+            ResetElements(*mapped);
+        }
+        else
+        {
+            mapped = &var.insert(it, typename std::map<K, V, C, A>::value_type(k, make_value(var)))->second;
+        }
+
+        element.template Deserialize<Protocols>(*mapped);
     }
+
+    var.erase(it, var.end());
+}
+
+} // namespace detail
+
+
+template <typename Protocols, typename X, typename Key, typename T>
+typename boost::enable_if<is_map_key_matching<Key, X> >::type
+inline DeserializeMapElements(X& var, const Key& key, const T& element, uint32_t size)
+{
+    BOOST_STATIC_ASSERT((is_map_element_matching<T, X>::value));
+
+    detail::ReadMapElements<Protocols>(var, key, element, size);
 }
 
 
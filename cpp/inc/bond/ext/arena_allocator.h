@@ -0,0 +1,281 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include <bond/core/detail/alloc.h>
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace bond { namespace ext
+{
+    /// @brief Monotonic memory arena to be used with \ref arena_allocator.
+    ///
+    /// Hands out memory from chunks obtained from the underlying allocator.
+    /// Deallocation is a no-op; the chunks are returned to the underlying
+    /// allocator all at once by \ref release, \ref reset or the destructor.
+    /// This fits deserialization of large nested objects, which performs
+    /// many small allocations that are all freed together.
+    ///
+    /// @tparam Alloc underlying allocator type used for the chunks.
+    ///
+    /// @remarks The arena is not thread-safe. Objects allocated from the
+    /// arena must be destroyed before the arena is released or reset.
+    template <typename Alloc = std::allocator<char>>
+    class monotonic_arena
+        : private bond::detail::allocator_holder<
+            typename std::allocator_traits<Alloc>::template rebind_alloc<char>>
+    {
+        using char_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<char>;
+        using holder = bond::detail::allocator_holder<char_alloc>;
+        using traits = std::allocator_traits<char_alloc>;
+
+    public:
+        /// @brief Constructs an empty arena.
+        ///
+        /// @param initial_size size in bytes of the first chunk. Each
+        /// following chunk is twice the size of the previous one.
+        ///
+        /// @param alloc the underlying allocator instance.
+        explicit monotonic_arena(std::size_t initial_size = 4096, const Alloc& alloc = {})
+            : holder{ char_alloc{ alloc } },
+              _next_size{ initial_size != 0 ? initial_size : 1 }
+        {}
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena()
+        {
+            release();
+        }
+
+        /// @brief Allocates \p size bytes aligned to \p alignment.
+        ///
+        /// @remarks Throws \c std::bad_alloc if the underlying allocator
+        /// fails or the size is too large.
+        void* allocate(std::size_t size, std::size_t alignment)
+        {
+            BOOST_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+            void* ptr = try_allocate(size, alignment);
+
+            if (!ptr)
+            {
+                add_chunk(size, alignment);
+                ptr = try_allocate(size, alignment);
+                BOOST_ASSERT(ptr);
+            }
+
+            _used += size;
+            return ptr;
+        }
+
+        /// @brief Returns all chunks to the underlying allocator.
+        void release() BOND_NOEXCEPT
+        {
+            while (_chunks)
+            {
+                chunk* prev = _chunks->prev;
+                traits::deallocate(holder::get(), reinterpret_cast<char*>(_chunks), _chunks->size);
+                _chunks = prev;
+            }
+
+            _current = _end = nullptr;
+            _used = _capacity = 0;
+        }
+
+        /// @brief Makes all memory available again while keeping the most
+        /// recent, and largest, chunk.
+        ///
+        /// @remarks Use it to reuse the memory for a stream of similar
+        /// objects, such as records deserialized in a loop; after a few
+        /// objects the kept chunk is large enough for one object.
+        void reset() BOND_NOEXCEPT
+        {
+            if (!_chunks)
+            {
+                return;
+            }
+
+            chunk* last = _chunks;
+            _chunks = last->prev;
+            release();
+
+            last->prev = nullptr;
+            _chunks = last;
+            _current = reinterpret_cast<char*>(last) + sizeof(chunk);
+            _end = reinterpret_cast<char*>(last) + last->size;
+            _capacity = last->size;
+        }
+
+        /// @brief Returns the number of bytes handed out since the last
+        /// release or reset.
+        std::size_t used() const BOND_NOEXCEPT
+        {
+            return _used;
+        }
+
+        /// @brief Returns the total size in bytes of the chunks the arena
+        /// holds.
+        std::size_t capacity() const BOND_NOEXCEPT
+        {
+            return _capacity;
+        }
+
+        const char_alloc& get_allocator() const BOND_NOEXCEPT
+        {
+            return holder::get();
+        }
+
+    private:
+        struct chunk
+        {
+            chunk* prev;
+            std::size_t size;
+        };
+
+        void* try_allocate(std::size_t size, std::size_t alignment) BOND_NOEXCEPT
+        {
+            if (!_current)
+            {
+                return nullptr;
+            }
+
+            const std::uintptr_t aligned =
+                (reinterpret_cast<std::uintptr_t>(_current) + alignment - 1) & ~(alignment - 1);
+            const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(_end);
+
+            if (aligned > end || end - aligned < size)
+            {
+                return nullptr;
+            }
+
+            _current = reinterpret_cast<char*>(aligned + size);
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        void add_chunk(std::size_t size, std::size_t alignment)
+        {
+            const std::size_t max_size = (std::numeric_limits<std::size_t>::max)();
+
+            if (size > max_size - sizeof(chunk) - alignment)
+            {
+                throw std::bad_alloc{};
+            }
+
+            const std::size_t required = sizeof(chunk) + size + alignment;
+            const std::size_t chunk_size = required > _next_size ? required : _next_size;
+
+            char* ptr = traits::allocate(holder::get(), chunk_size);
+
+            _chunks = ::new (ptr) chunk{ _chunks, chunk_size };
+            _current = ptr + sizeof(chunk);
+            _end = ptr + chunk_size;
+            _capacity += chunk_size;
+            _next_size = chunk_size <= max_size / 2 ? chunk_size * 2 : chunk_size;
+        }
+
+        chunk* _chunks{};
+        char* _current{};
+        char* _end{};
+        std::size_t _next_size;
+        std::size_t _used{};
+        std::size_t _capacity{};
+    };
+
+
+    /// @brief STL-compatible allocator that allocates from a
+    /// \ref monotonic_arena.
+    ///
+    /// @tparam T value type.
+    ///
+    /// @tparam Alloc underlying allocator type of the arena.
+    ///
+    /// @remarks Deallocation is a no-op. The allocator is stateful and
+    /// copies refer to the same arena, so it can be passed to generated
+    /// structs and propagates to nested containers and strings through
+    /// \c std::scoped_allocator_adaptor. Copy assignment keeps the arena of
+    /// the destination, while move assignment and swap exchange arenas.
+    template <typename T, typename Alloc = std::allocator<char>>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+        using arena_type = monotonic_arena<Alloc>;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = arena_allocator<U, Alloc>;
+        };
+
+
+        /// @brief Constructs an allocator that allocates from \p arena.
+        arena_allocator(arena_type& arena) BOND_NOEXCEPT
+            : _arena{ &arena }
+        {}
+
+        /// @brief Converts from an allocator for another value type.
+        template <typename U>
+        arena_allocator(const arena_allocator<U, Alloc>& other) BOND_NOEXCEPT
+            : _arena{ &other.get_arena() }
+        {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n > max_size())
+            {
+                throw std::bad_alloc{};
+            }
+
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), std::alignment_of<T>::value));
+        }
+
+        void deallocate(T* /*ptr*/, std::size_t /*n*/) BOND_NOEXCEPT
+        {}
+
+        std::size_t max_size() const BOND_NOEXCEPT
+        {
+            return (std::numeric_limits<std::size_t>::max)() / sizeof(T);
+        }
+
+        arena_type& get_arena() const BOND_NOEXCEPT
+        {
+            return *_arena;
+        }
+
+    private:
+        arena_type* _arena;
+    };
+
+
+    template <typename T1, typename T2, typename Alloc>
+    inline bool operator==(
+        const arena_allocator<T1, Alloc>& a1,
+        const arena_allocator<T2, Alloc>& a2) BOND_NOEXCEPT
+    {
+        return &a1.get_arena() == &a2.get_arena();
+    }
+
+    template <typename T1, typename T2, typename Alloc>
+    inline bool operator!=(
+        const arena_allocator<T1, Alloc>& a1,
+        const arena_allocator<T2, Alloc>& a2) BOND_NOEXCEPT
+    {
+        return !(a1 == a2);
+    }
+
+} } // namespace bond::ext
@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include <bond/core/exception.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bond { namespace ext
+{
+    /// @brief Interface of the codecs which compress the blocks of a
+    /// \ref record_container_writer.
+    ///
+    /// The functions are called concurrently from multiple threads.
+    class block_codec
+    {
+    public:
+        virtual ~block_codec() = default;
+
+        /// @brief Id of the codec stored in the header of each block, between
+        /// 1 and 255. Id 0 marks blocks stored without compression.
+        virtual uint8_t id() const = 0;
+
+        /// @brief Upper bound of the compressed length of \p length bytes.
+        virtual uint32_t max_compressed_length(uint32_t length) const = 0;
+
+        /// @brief Compresses \p length bytes of \p data into \p output, which
+        /// has room for max_compressed_length(length) bytes.
+        ///
+        /// @return length of the compressed data.
+        virtual uint32_t compress(const char* data, uint32_t length, char* output) const = 0;
+
+        /// @brief Decompresses \p length bytes of \p data into exactly
+        /// \p output_length bytes of \p output.
+        ///
+        /// @throws StreamException if the data is malformed.
+        virtual void decompress(const char* data, uint32_t length, char* output, uint32_t output_length) const = 0;
+    };
+
+
+    /// @brief Fast LZ77 codec, with id 1.
+    ///
+    /// The compressed data is a sequence of literal runs and matches of at
+    /// least 4 bytes within the preceding 64 KiB, found with a hash table of
+    /// 4-byte sequences. Each run and match is preceded by a token byte with
+    /// the literal length in the high nibble and the match length minus 4 in
+    /// the low nibble; lengths of 15 or more continue in following bytes,
+    /// which are added up until a byte other than 255. The 2-byte little
+    /// endian offset of the match follows the literals. The last run of
+    /// literals has no match.
+    class lz_codec : public block_codec
+    {
+    public:
+        uint8_t id() const override
+        {
+            return 1;
+        }
+
+        uint32_t max_compressed_length(uint32_t length) const override
+        {
+            return length + length / 255 + 16;
+        }
+
+        uint32_t compress(const char* data, uint32_t length, char* output) const override
+        {
+            const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+            uint8_t* out = reinterpret_cast<uint8_t*>(output);
+            std::vector<uint32_t> table(hash_size);
+            uint32_t anchor = 0;
+            uint32_t pos = 0;
+
+            while (length >= min_match && pos <= length - min_match)
+            {
+                const uint32_t sequence = load(in + pos);
+                uint32_t& entry = table[(sequence * 2654435761u) >> (32 - hash_bits)];
+                const uint32_t candidate = entry;
+
+                entry = pos;
+
+                if (candidate < pos && pos - candidate <= max_offset && load(in + candidate) == sequence)
+                {
+                    uint32_t end = pos + min_match;
+
+                    while (end < length && in[end] == in[end - pos + candidate])
+                    {
+                        ++end;
+                    }
+
+                    out = write_sequence(out, in + anchor, pos - anchor, pos - candidate, end - pos);
+                    pos = anchor = end;
+                }
+                else
+                {
+                    // Skip faster through data which doesn't compress
+                    pos += 1 + ((pos - anchor) >> 6);
+                }
+            }
+
+            out = write_sequence(out, in + anchor, length - anchor, 0, 0);
+
+            return static_cast<uint32_t>(out - reinterpret_cast<uint8_t*>(output));
+        }
+
+        void decompress(const char* data, uint32_t length, char* output, uint32_t output_length) const override
+        {
+            const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+            const uint8_t* const in_end = in + length;
+            uint8_t* const out_begin = reinterpret_cast<uint8_t*>(output);
+            uint8_t* out = out_begin;
+            uint8_t* const out_end = out_begin + output_length;
+
+            while (in != in_end)
+            {
+                const uint8_t token = *in++;
+                const uint64_t literals = read_length(in, in_end, token >> 4);
+
+                if (literals > static_cast<uint64_t>(in_end - in) || literals > static_cast<uint64_t>(out_end - out))
+                {
+                    malformed();
+                }
+
+                if (literals)
+                {
+                    std::memcpy(out, in, static_cast<size_t>(literals));
+                    in += literals;
+                    out += literals;
+                }
+
+                if (in == in_end)
+                {
+                    break;
+                }
+
+                if (in_end - in < 2)
+                {
+                    malformed();
+                }
+
+                const uint32_t offset = in[0] | (in[1] << 8);
+                in += 2;
+
+                const uint64_t match = read_length(in, in_end, token & 0x0f) + min_match;
+
+                if (offset == 0
+                    || offset > static_cast<uint64_t>(out - out_begin)
+                    || match > static_cast<uint64_t>(out_end - out))
+                {
+                    malformed();
+                }
+
+                const uint8_t* from = out - offset;
+
+                if (offset >= match)
+                {
+                    std::memcpy(out, from, static_cast<size_t>(match));
+                    out += match;
+                }
+                else
+                {
+                    // Overlapping match repeats the last offset bytes
+                    for (uint8_t* const end = out + match; out != end; )
+                    {
+                        *out++ = *from++;
+                    }
+                }
+            }
+
+            if (out != out_end)
+            {
+                malformed();
+            }
+        }
+
+    private:
+        static const uint32_t hash_bits = 12;
+        static const uint32_t hash_size = 1 << hash_bits;
+        static const uint32_t min_match = 4;
+        static const uint32_t max_offset = 0xffff;
+
+        static uint32_t load(const uint8_t* data)
+        {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        static uint8_t* write_length(uint8_t* out, uint32_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                *out++ = 255;
+            }
+
+            *out++ = static_cast<uint8_t>(length);
+            return out;
+        }
+
+        static uint8_t* write_sequence(uint8_t* out, const uint8_t* literals, uint32_t count, uint32_t offset, uint32_t match)
+        {
+            const uint32_t match_code = match ? match - min_match : 0;
+            uint8_t* token = out++;
+
+            *token = static_cast<uint8_t>(((count < 15 ? count : 15) << 4) | (match_code < 15 ? match_code : 15));
+
+            if (count >= 15)
+            {
+                out = write_length(out, count - 15);
+            }
+
+            if (count)
+            {
+                std::memcpy(out, literals, count);
+                out += count;
+            }
+
+            if (match)
+            {
+                *out++ = static_cast<uint8_t>(offset);
+                *out++ = static_cast<uint8_t>(offset >> 8);
+
+                if (match_code >= 15)
+                {
+                    out = write_length(out, match_code - 15);
+                }
+            }
+
+            return out;
+        }
+
+        static uint64_t read_length(const uint8_t*& in, const uint8_t* in_end, uint32_t nibble)
+        {
+            uint64_t length = nibble;
+
+            if (nibble == 15)
+            {
+                uint8_t byte;
+
+                do
+                {
+                    if (in == in_end)
+                    {
+                        malformed();
+                    }
+
+                    byte = *in++;
+                    length += byte;
+                }
+                while (byte == 255);
+            }
+
+            return length;
+        }
+
+        BOND_NORETURN static void malformed()
+        {
+            MalformedBlockException(1);
+        }
+    };
+
+} } // namespace bond::ext
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/// @file
+/// Container interface and traits that make \c boost::container::flat_map,
+/// \c flat_set and \c small_vector usable as Bond map, set and list fields.
+///
+/// The header is included in generated code by the \c boost-flat-containers
+/// preset of the \c gbc \c --using option, which maps the \c flat_map,
+/// \c flat_set and \c small_vector type aliases to these containers.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include <bond/core/containers.h>
+#include <bond/core/exception.h>
+
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/version.hpp>
+
+#include <algorithm>
+
+namespace bond
+{
+    /// @brief \c boost::container::flat_set is a set container.
+    template <typename T, typename C, typename A>
+    struct is_set_container<boost::container::flat_set<T, C, A> >
+        : std::true_type {};
+
+    /// @brief \c boost::container::flat_map is a map container.
+    template <typename K, typename T, typename C, typename A>
+    struct is_map_container<boost::container::flat_map<K, T, C, A> >
+        : std::true_type {};
+
+    /// @brief \c boost::container::small_vector is a list container.
+    ///
+    /// @remarks Newer versions of Boost add an options parameter to
+    /// \c small_vector, hence the parameter pack.
+    template <typename T, std::size_t N, typename... Rest>
+    struct is_list_container<boost::container::small_vector<T, N, Rest...> >
+        : std::true_type {};
+
+} // namespace bond
+
+
+// The container interface functions are looked up via ADL, so they are
+// defined in the namespace of the containers. The generic \c resize_list,
+// \c reserve_set, \c reserve_map and enumerators in namespace bond cover the
+// rest of the interface.
+namespace boost { namespace container
+{
+    /// @brief Clears a flat_set before it is deserialized into.
+    template <typename T, typename C, typename A>
+    inline void clear_set(flat_set<T, C, A>& set)
+    {
+        set.clear();
+    }
+
+    /// @brief Inserts an item into a flat_set.
+    template <typename T, typename C, typename A>
+    inline void set_insert(flat_set<T, C, A>& set, const T& item)
+    {
+        set.insert(item);
+    }
+
+#if BOOST_VERSION >= 106600
+    /// @brief Inserts the items read into a flat_set.
+    ///
+    /// @remarks The items are appended to the underlying vector, which is
+    /// then sorted once, rather than each being inserted at its position,
+    /// which moves the items after it. Payloads written from ordered
+    /// containers are already sorted and only checked.
+    template <typename T, typename C, typename A, typename F>
+    inline void insert_set_items(flat_set<T, C, A>& set, uint32_t size, F deserialize)
+    {
+        typename flat_set<T, C, A>::sequence_type items(set.extract_sequence());
+        typename flat_set<T, C, A>::value_compare less = set.value_comp();
+
+        items.reserve(items.size() + size);
+
+        while (size--)
+        {
+            items.push_back(bond::make_element(set));
+            deserialize(items.back());
+        }
+
+        if (std::adjacent_find(items.begin(), items.end(),
+                [&less](const T& x, const T& y) { return !less(x, y); }) == items.end())
+        {
+            set.adopt_sequence(ordered_unique_range, boost::move(items));
+        }
+        else
+        {
+            set.adopt_sequence(boost::move(items));
+        }
+    }
+#endif
+
+    /// @brief Clears a flat_map before it is deserialized into.
+    template <typename K, typename T, typename C, typename A>
+    inline void clear_map(flat_map<K, T, C, A>& map)
+    {
+        map.clear();
+    }
+
+    /// @brief Returns the value mapped to a key, inserting it if necessary.
+    template <typename K, typename T, typename C, typename A>
+    inline T& mapped_at(flat_map<K, T, C, A>& map, const K& key)
+    {
+        return map.insert(
+            typename flat_map<K, T, C, A>::value_type(key, bond::make_value(map))).first->second;
+    }
+
+    /// @brief Returns the value mapped to a key, throwing if there is none.
+    template <typename K, typename T, typename C, typename A>
+    inline const T& mapped_at(const flat_map<K, T, C, A>& map, const K& key)
+    {
+        typename flat_map<K, T, C, A>::const_iterator it = map.find(key);
+
+        if (it == map.end())
+            bond::ElementNotFoundException(key);
+
+        return it->second;
+    }
+
+#if BOOST_VERSION >= 106600
+    /// @brief Inserts the elements read into a flat_map.
+    ///
+    /// @remarks The elements are appended to the underlying vector, which is
+    /// then sorted once by key, keeping one of the elements with the same
+    /// key. Payloads written from ordered containers are already sorted and
+    /// only checked.
+    template <typename K, typename T, typename C, typename A, typename F, typename G>
+    inline void insert_map_elements(flat_map<K, T, C, A>& map, uint32_t size, F deserialize_key, G deserialize_value)
+    {
+        typedef typename flat_map<K, T, C, A>::value_type value_type;
+
+        typename flat_map<K, T, C, A>::sequence_type elements(map.extract_sequence());
+        typename flat_map<K, T, C, A>::value_compare less = map.value_comp();
+
+        elements.reserve(elements.size() + size);
+
+        while (size--)
+        {
+            elements.push_back(value_type(bond::make_key(map), bond::make_value(map)));
+            deserialize_key(elements.back().first);
+            deserialize_value(elements.back().second);
+        }
+
+        if (std::adjacent_find(elements.begin(), elements.end(),
+                [&less](const value_type& x, const value_type& y) { return !less(x, y); }) == elements.end())
+        {
+            map.adopt_sequence(ordered_unique_range, boost::move(elements));
+        }
+        else
+        {
+            map.adopt_sequence(boost::move(elements));
+        }
+    }
+#endif
+
+} } // namespace boost::container
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#ifdef _MSC_VER
+    #pragma warning (push)
+    #pragma warning (disable: 4100 4702)
+#endif
+
+#include <grpcpp/impl/codegen/status.h>
+
+#ifdef _MSC_VER
+    #pragma warning (pop)
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace bond { namespace ext { namespace grpc
+{
+    /// @brief Limits enforced by \ref admission_control.
+    ///
+    /// A default-constructed instance imposes no concurrency or queue-time
+    /// limits and only drops calls whose deadline has already expired.
+    struct admission_options
+    {
+        /// @brief Maximum number of calls that may be in flight at the same
+        /// time. Calls received beyond this limit are rejected with
+        /// RESOURCE_EXHAUSTED. Zero means unlimited.
+        size_t max_concurrent_calls = 0;
+
+        /// @brief Maximum time a call may wait in the scheduler between
+        /// being received and its handler being invoked. Calls that wait
+        /// longer are rejected with RESOURCE_EXHAUSTED. Zero means
+        /// unlimited.
+        std::chrono::steady_clock::duration max_queue_delay = std::chrono::steady_clock::duration::zero();
+
+        /// @brief Whether calls whose deadline has already expired are
+        /// rejected with DEADLINE_EXCEEDED instead of being handled.
+        bool drop_expired_calls = true;
+    };
+
+    /// @brief Server-side admission control and load shedding.
+    ///
+    /// Tracks the number of calls in flight across all the services of a
+    /// \ref server and decides whether a call should be handled or shed
+    /// without invoking the handler or deserializing the request. A call is
+    /// in flight from the moment it is admitted until its response has been
+    /// sent.
+    ///
+    /// Use \ref server::Start with an \ref admission_options argument to
+    /// enable admission control for a server.
+    class admission_control final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit admission_control(const admission_options& options = {})
+            : _options(options)
+        {}
+
+        admission_control(const admission_control& other) = delete;
+        admission_control& operator=(const admission_control& other) = delete;
+
+        /// @brief Decides whether a newly received call is admitted.
+        ///
+        /// If the returned status is OK, the call is counted as in flight
+        /// and \ref leave must be called once its response has been sent.
+        /// Otherwise, the call must be finished with the returned status.
+        ///
+        /// @param deadline the deadline of the call.
+        ::grpc::Status enter(std::chrono::system_clock::time_point deadline)
+        {
+            if (is_expired(deadline))
+            {
+                return reject_expired();
+            }
+
+            const size_t inFlight = _inFlight.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            if (_options.max_concurrent_calls != 0 && inFlight > _options.max_concurrent_calls)
+            {
+                leave();
+                _rejected.fetch_add(1, std::memory_order_relaxed);
+                return { ::grpc::StatusCode::RESOURCE_EXHAUSTED, "Too many concurrent calls." };
+            }
+
+            return ::grpc::Status::OK;
+        }
+
+        /// @brief Decides whether an admitted call that has waited in the
+        /// scheduler since \p received should still have its handler
+        /// invoked.
+        ///
+        /// If the returned status is not OK, the call must be finished with
+        /// the returned status. It remains in flight until its response has
+        /// been sent either way.
+        ::grpc::Status dequeue(std::chrono::system_clock::time_point deadline, clock::time_point received)
+        {
+            if (_options.max_queue_delay != clock::duration::zero()
+                && clock::now() - received > _options.max_queue_delay)
+            {
+                _rejected.fetch_add(1, std::memory_order_relaxed);
+                return { ::grpc::StatusCode::RESOURCE_EXHAUSTED, "The call has been queued for too long." };
+            }
+
+            if (is_expired(deadline))
+            {
+                return reject_expired();
+            }
+
+            return ::grpc::Status::OK;
+        }
+
+        /// @brief Marks an admitted call as no longer in flight.
+        void leave() noexcept
+        {
+            _inFlight.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /// @brief Gets the number of calls currently in flight.
+        size_t in_flight() const noexcept
+        {
+            return _inFlight.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Gets the number of calls rejected with RESOURCE_EXHAUSTED
+        /// so far.
+        size_t rejected() const noexcept
+        {
+            return _rejected.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Gets the number of calls dropped because their deadline
+        /// had expired so far.
+        size_t expired() const noexcept
+        {
+            return _expired.load(std::memory_order_relaxed);
+        }
+
+        const admission_options& options() const noexcept
+        {
+            return _options;
+        }
+
+    private:
+        bool is_expired(std::chrono::system_clock::time_point deadline) const noexcept
+        {
+            return _options.drop_expired_calls
+                && deadline != (std::chrono::system_clock::time_point::max)()
+                && deadline <= std::chrono::system_clock::now();
+        }
+
+        ::grpc::Status reject_expired()
+        {
+            _expired.fetch_add(1, std::memory_order_relaxed);
+            return { ::grpc::StatusCode::DEADLINE_EXCEEDED, "The call deadline has expired." };
+        }
+
+        const admission_options _options;
+        std::atomic<size_t> _inFlight{ 0 };
+        std::atomic<size_t> _rejected{ 0 };
+        std::atomic<size_t> _expired{ 0 };
+    };
+
+} } } // namespace bond::ext::grpc
@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "exception.h"
+
+#ifdef _MSC_VER
+    #pragma warning (push)
+    #pragma warning (disable: 4100 4702)
+#endif
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/impl/codegen/channel_interface.h>
+
+#ifdef _MSC_VER
+    #pragma warning (pop)
+#endif
+
+#include <boost/assert.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bond { namespace ext { namespace grpc
+{
+    /// @brief Policy used by \ref channel_pool to pick a channel for a call.
+    enum class channel_selection
+    {
+        /// @brief Scan all the channels and pick the one with the fewest
+        /// outstanding calls.
+        least_outstanding,
+
+        /// @brief Pick two channels at random and use the one with fewer
+        /// outstanding calls.
+        power_of_two_choices
+    };
+
+    /// @brief A fixed set of channels to the same target that generated
+    /// Bond grpc++ clients spread their calls over.
+    ///
+    /// A single ::grpc::Channel multiplexes all of its calls over one HTTP/2
+    /// connection, which limits the number of concurrent streams and shares
+    /// one flow-control window between them. A client constructed from a
+    /// channel_pool instead picks a channel for every call based on the
+    /// number of calls outstanding on each channel.
+    ///
+    /// @note Channels created with identical arguments may share the same
+    /// underlying connection. Use \ref Create, which gives every channel a
+    /// distinct argument, or make sure the channels are otherwise distinct.
+    class channel_pool final
+    {
+    public:
+        /// @brief Keeps a call counted as outstanding on one of the channels
+        /// of a pool for as long as it is alive.
+        ///
+        /// @warning The pool must outlive all of its leases.
+        class lease
+        {
+        public:
+            lease() = default;
+
+            lease(const lease& other) = delete;
+            lease& operator=(const lease& other) = delete;
+
+            lease(lease&& other) noexcept
+                : _pool{ other._pool },
+                  _index{ other._index }
+            {
+                other._pool = nullptr;
+            }
+
+            lease& operator=(lease&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    _pool = other._pool;
+                    _index = other._index;
+                    other._pool = nullptr;
+                }
+
+                return *this;
+            }
+
+            ~lease()
+            {
+                reset();
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return _pool != nullptr;
+            }
+
+            /// @brief Gets the channel the call should be made on.
+            const std::shared_ptr<::grpc::ChannelInterface>& channel() const noexcept
+            {
+                BOOST_ASSERT(_pool);
+                return _pool->channel(_index);
+            }
+
+            /// @brief Gets the index of the channel in the pool.
+            size_t index() const noexcept
+            {
+                return _index;
+            }
+
+            /// @brief Stops counting the call as outstanding.
+            void reset() noexcept
+            {
+                if (_pool)
+                {
+                    _pool->_outstanding[_index].value.fetch_sub(1, std::memory_order_relaxed);
+                    _pool = nullptr;
+                }
+            }
+
+        private:
+            friend class channel_pool;
+
+            lease(channel_pool& pool, size_t index) noexcept
+                : _pool{ &pool },
+                  _index{ index }
+            {}
+
+            channel_pool* _pool = nullptr;
+            size_t _index = 0;
+        };
+
+        /// @brief Creates a pool over the given channels.
+        ///
+        /// @throws InvalidChannelCount when \p channels is empty.
+        explicit channel_pool(
+            std::vector<std::shared_ptr<::grpc::ChannelInterface>> channels,
+            channel_selection selection = channel_selection::power_of_two_choices)
+            : _channels(std::move(channels)),
+              _outstanding(_channels.size()),
+              _selection(selection)
+        {
+            if (_channels.empty())
+            {
+                throw InvalidChannelCount{};
+            }
+        }
+
+        /// @brief Creates a pool of \p size distinct channels to \p target.
+        ///
+        /// Each channel is given a distinct channel argument so that grpc
+        /// does not share a connection between them.
+        static std::shared_ptr<channel_pool> Create(
+            const std::string& target,
+            const std::shared_ptr<::grpc::ChannelCredentials>& credentials,
+            size_t size,
+            channel_selection selection = channel_selection::power_of_two_choices,
+            const ::grpc::ChannelArguments& args = {})
+        {
+            std::vector<std::shared_ptr<::grpc::ChannelInterface>> channels;
+            channels.reserve(size);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                ::grpc::ChannelArguments channelArgs{ args };
+                channelArgs.SetInt("bond.channel_pool_index", static_cast<int>(i));
+
+                channels.push_back(::grpc::CreateCustomChannel(target, credentials, channelArgs));
+            }
+
+            return std::make_shared<channel_pool>(std::move(channels), selection);
+        }
+
+        channel_pool(const channel_pool& other) = delete;
+        channel_pool& operator=(const channel_pool& other) = delete;
+
+        /// @brief Gets the number of channels in the pool.
+        size_t size() const noexcept
+        {
+            return _channels.size();
+        }
+
+        /// @brief Gets the channel at \p index.
+        const std::shared_ptr<::grpc::ChannelInterface>& channel(size_t index) const noexcept
+        {
+            BOOST_ASSERT(index < _channels.size());
+            return _channels[index];
+        }
+
+        /// @brief Gets the number of calls currently outstanding on the
+        /// channel at \p index.
+        size_t outstanding(size_t index) const noexcept
+        {
+            BOOST_ASSERT(index < _outstanding.size());
+            return _outstanding[index].value.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Picks a channel for a new call and counts the call as
+        /// outstanding on it until the returned lease is destroyed.
+        lease acquire() noexcept
+        {
+            const size_t index = select();
+            _outstanding[index].value.fetch_add(1, std::memory_order_relaxed);
+            return lease{ *this, index };
+        }
+
+    private:
+        // Counters are padded to separate cache lines, as they are updated
+        // concurrently by every call.
+        struct counter
+        {
+            std::atomic<size_t> value{ 0 };
+            char padding[64 - sizeof(std::atomic<size_t>)];
+        };
+
+        size_t select() noexcept
+        {
+            const size_t size = _channels.size();
+            if (size == 1)
+            {
+                return 0;
+            }
+
+            if (_selection == channel_selection::least_outstanding)
+            {
+                size_t best = 0;
+                size_t bestCount = outstanding(0);
+
+                for (size_t i = 1; i < size && bestCount != 0; ++i)
+                {
+                    const size_t count = outstanding(i);
+                    if (count < bestCount)
+                    {
+                        best = i;
+                        bestCount = count;
+                    }
+                }
+
+                return best;
+            }
+
+            // A shared counter mixed with a 64-bit finalizer is random enough
+            // to pick the two candidates and, unlike a PRNG, needs no
+            // per-thread state.
+            uint64_t x = _sequence.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull;
+            x ^= x >> 31;
+            x *= 0xBF58476D1CE4E5B9ull;
+            x ^= x >> 29;
+
+            const size_t first = static_cast<size_t>(x % size);
+            const size_t second = (first + 1 + static_cast<size_t>((x >> 32) % (size - 1))) % size;
+
+            return outstanding(second) < outstanding(first) ? second : first;
+        }
+
+        const std::vector<std::shared_ptr<::grpc::ChannelInterface>> _channels;
+        std::vector<counter> _outstanding;
+        std::atomic<uint64_t> _sequence{ 0 };
+        const channel_selection _selection;
+    };
+
+} } } // namespace bond::ext::grpc
@@ -6,9 +6,12 @@
 #include <bond/core/config.h>
 
 #include "io_manager_tag.h"
+#include "pooled_allocator.h"
 #include "serialization.h"
 
 #include <bond/core/bonded.h>
+#include <bond/ext/grpc/channel_pool.h>
+#include <bond/ext/grpc/exception.h>
 #include <bond/ext/grpc/io_manager.h>
 #include <bond/ext/grpc/scheduler.h>
 #include <bond/ext/grpc/unary_call_result.h>
@@ -31,17 +34,23 @@
 #endif
 
 #include <boost/assert.hpp>
-#include <boost/intrusive_ptr.hpp>
-#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+#include <boost/optional/optional.hpp>
 
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
+#include <utility>
 
 namespace bond { namespace ext { namespace grpc { namespace detail
 {
     /// @brief Helper base class Bond grpc++ clients.
     ///
+    /// The state of each call, including its client context when none is
+    /// provided, its callback and, for the overloads that return a future,
+    /// the shared state of the future, is kept in blocks that are pooled and
+    /// reused across calls.
+    ///
     /// @note This class is for use by generated and helper code only.
     class client
     {
@@ -52,9 +61,23 @@ namespace bond { namespace ext { namespace grpc { namespace detail
             const Scheduler& scheduler)
             : _channel{ std::move(channel) },
               _ioManager{ std::move(ioManager) },
-              _scheduler{ scheduler }
+              _scheduler{ std::make_shared<Scheduler>(scheduler) }
+        {
+            BOOST_ASSERT(*_scheduler);
+        }
+
+        /// @brief Creates a client that spreads its calls over the channels
+        /// of \p channels.
+        client(
+            std::shared_ptr<channel_pool> channels,
+            std::shared_ptr<io_manager> ioManager,
+            const Scheduler& scheduler)
+            : _channel{ channels->channel(0) },
+              _channels{ std::move(channels) },
+              _ioManager{ std::move(ioManager) },
+              _scheduler{ std::make_shared<Scheduler>(scheduler) }
         {
-            BOOST_ASSERT(_scheduler);
+            BOOST_ASSERT(*_scheduler);
         }
 
         client(const client& other) = delete;
@@ -100,28 +123,7 @@ namespace bond { namespace ext { namespace grpc { namespace detail
         std::future<unary_call_result<Response>> dispatch(
             const ::grpc::internal::RpcMethod& method,
             std::shared_ptr<::grpc::ClientContext> context,
-            const bonded<Request>& request)
-        {
-            auto callback = std::make_shared<std::packaged_task<unary_call_result<Response>(unary_call_result<Response>)>>(
-                [](unary_call_result<Response> response)
-                {
-                    return response.status().ok()
-                        ? response
-                        : throw UnaryCallException{ response.status(), response.context() };
-                });
-
-            auto result = callback->get_future();
-
-            std::function<void(unary_call_result<Response>)> copyableCallback =
-                [callback](unary_call_result<Response> response)
-                {
-                    (*callback)(std::move(response));
-                };
-
-            dispatch(method, std::move(context), copyableCallback, request);
-
-            return result;
-        }
+            const bonded<Request>& request);
 
         template <typename Response, typename Request = Void>
         std::future<unary_call_result<Response>> dispatch(
@@ -135,107 +137,272 @@ namespace bond { namespace ext { namespace grpc { namespace detail
     private:
         class unary_call_data;
 
+        template <typename Response>
+        class callback_call_data;
+
+        template <typename Response>
+        class future_call_data;
+
+        template <typename CallData, typename... Args>
+        std::shared_ptr<CallData> make_call(std::shared_ptr<::grpc::ClientContext> context, Args&&... args);
+
+        void start_call(
+            std::shared_ptr<unary_call_data> call,
+            const ::grpc::internal::RpcMethod& method,
+            const ::grpc::ByteBuffer& requestBuffer);
+
         std::shared_ptr<::grpc::ChannelInterface> _channel;
+        std::shared_ptr<channel_pool> _channels;
         std::shared_ptr<io_manager> _ioManager;
-        Scheduler _scheduler;
+        /// Shared by all the calls, as copying a Scheduler may allocate.
+        std::shared_ptr<const Scheduler> _scheduler;
     };
 
 
     /// @brief Implementation class that hold the state associated with
     /// outgoing unary calls.
-    class client::unary_call_data
-        : public boost::intrusive_ref_counter<unary_call_data>,
-          io_manager_tag
+    class client::unary_call_data : io_manager_tag
     {
     public:
-        template <typename Response>
         unary_call_data(
-            const ::grpc::internal::RpcMethod& method,
-            const ::grpc::ByteBuffer& requestBuffer,
             std::shared_ptr<::grpc::CompletionQueue> cq,
             std::shared_ptr<::grpc::ChannelInterface> channel,
             std::shared_ptr<::grpc::ClientContext> context,
-            const Scheduler& scheduler,
-            const std::function<void(unary_call_result<Response>)>& cb)
-            : _cq(std::move(cq)),
-              _channel(std::move(channel)),
-              _context(std::move(context)),
-              _responseReader(
-                  ::grpc::internal::ClientAsyncResponseReaderFactory<::grpc::ByteBuffer>::Create(
-                      _channel.get(),
-                      _cq.get(),
-                      method,
-                      _context.get(),
-                      requestBuffer,
-                      /* start */ true)),
-              _scheduler(scheduler),
+            std::shared_ptr<const Scheduler> scheduler,
+            std::shared_ptr<channel_pool> channels,
+            channel_pool::lease lease)
+            : _scheduler(std::move(scheduler)),
               _responseBuffer(),
               _status(),
-              _self(this)
+              _self(),
+              _channels(std::move(channels)),
+              _lease(std::move(lease)),
+              _cq(std::move(cq)),
+              _channel(std::move(channel)),
+              _context(std::move(context)),
+              _ownContext(),
+              _responseReader()
         {
-            BOOST_ASSERT(_scheduler);
+            BOOST_ASSERT(*_scheduler);
 
-            if (cb)
+            if (!_context)
             {
-                _invoke = std::bind(&unary_call_data::invoke<Response>, this, cb);
+                _ownContext.emplace();
             }
+        }
+
+        /// @brief Sends the request and waits for the response.
+        ///
+        /// @param self a pointer to this instance that is held until the
+        /// response has been received. The caller must hold it too until
+        /// this method returns.
+        void start(
+            const std::shared_ptr<unary_call_data>& self,
+            const ::grpc::internal::RpcMethod& method,
+            const ::grpc::ByteBuffer& requestBuffer)
+        {
+            BOOST_ASSERT(self.get() == this);
+            _self = self;
+
+            _responseReader.reset(
+                ::grpc::internal::ClientAsyncResponseReaderFactory<::grpc::ByteBuffer>::Create(
+                    _channel.get(),
+                    _cq.get(),
+                    method,
+                    _context ? _context.get() : _ownContext.get_ptr(),
+                    requestBuffer,
+                    /* start */ true));
 
-            auto self = _self; // Make sure `this` will outlive the below call.
             _responseReader->Finish(&_responseBuffer, &_status, tag());
         }
 
-    private:
-        template <typename Response>
-        void invoke(const std::function<void(unary_call_result<Response>)>& callback)
+    protected:
+        /// @brief Invoked after the response has been received. Must
+        /// eventually release \ref _self.
+        virtual void complete() = 0;
+
+        /// @brief Gets the client context under which the request was
+        /// executed.
+        ///
+        /// An own context is returned as an alias of \p self, so that the
+        /// state of the call is freed along with the last reference to it.
+        std::shared_ptr<::grpc::ClientContext> context(const std::shared_ptr<unary_call_data>& self)
         {
-            // TODO: Use lambda with move-capture when allowed to use C++14.
-            _scheduler(std::bind(
-                [](decltype(callback)& cb,
-                    ::grpc::ByteBuffer& responseBuffer,
-                    ::grpc::Status& status,
-                    std::shared_ptr<::grpc::ClientContext>& context)
-                {
-                    cb(unary_call_result<Response>{ std::move(responseBuffer), status, std::move(context) });
-                },
-                callback,
-                std::move(_responseBuffer),
-                std::move(_status),
-                std::move(_context)));
+            return _context ? std::move(_context) : std::shared_ptr<::grpc::ClientContext>(self, _ownContext.get_ptr());
         }
 
+        /// The scheduler in which to invoke the callback.
+        std::shared_ptr<const Scheduler> _scheduler;
+        /// @brief The response buffer received from the service.
+        /*::grpc::*/ByteBuffer _responseBuffer;
+        /// @brief The status of the request.
+        ::grpc::Status _status;
+        /// A pointer to ourselves used to keep us alive while waiting to
+        /// receive the response.
+        std::shared_ptr<unary_call_data> _self;
+
+    private:
         /// @brief Invoked after the response has been received.
         void invoke(bool ok) override
         {
-            if (ok && _invoke)
+            // The call is no longer outstanding, even though its state may
+            // be kept alive by the client context.
+            _lease.reset();
+
+            if (ok)
             {
-                _invoke();
+                complete();
+            }
+            else
+            {
+                _self.reset();
             }
-
-            _self.reset();
         }
 
+        /// The pool the channel was picked from, if any.
+        std::shared_ptr<channel_pool> _channels;
+        /// Keeps the call counted as outstanding on its pooled channel.
+        channel_pool::lease _lease;
         /// The completion port to post IO operations to.
         std::shared_ptr<::grpc::CompletionQueue> _cq;
         /// The channel to send the request on.
         std::shared_ptr<::grpc::ChannelInterface> _channel;
-        /// @brief The client context under which the request was executed.
+        /// @brief The client context provided by the caller, if any.
         std::shared_ptr<::grpc::ClientContext> _context;
-        /// A response reader.
+        /// @brief The client context used when the caller provided none.
+        boost::optional<::grpc::ClientContext> _ownContext;
+        /// A response reader. It is allocated in the arena of the call.
         std::unique_ptr<::grpc::ClientAsyncResponseReader<::grpc::ByteBuffer>> _responseReader;
-        /// The scheduler in which to invoke the callback.
-        Scheduler _scheduler;
-        /// @brief The response buffer received from the service.
-        /*::grpc::*/ByteBuffer _responseBuffer;
-        /// @brief The status of the request.
-        ::grpc::Status _status;
-        /// @brief Type-erased function to invoke user-callback for a response.
-        std::function<void()> _invoke;
-        /// A pointer to ourselves used to keep us alive while waiting to
-        /// receive the response.
-        boost::intrusive_ptr<unary_call_data> _self;
     };
 
 
+    /// @brief State of a call whose response is passed to a callback
+    /// invoked in the scheduler.
+    template <typename Response>
+    class client::callback_call_data final : public client::unary_call_data
+    {
+    public:
+        template <typename... Args>
+        callback_call_data(const std::function<void(unary_call_result<Response>)>& cb, Args&&... args)
+            : unary_call_data(std::forward<Args>(args)...),
+              _callback(cb)
+        {}
+
+    private:
+        void complete() override
+        {
+            if (!_callback)
+            {
+                _self.reset();
+                return;
+            }
+
+            // Capturing nothing but `this` lets the functor fit in the small
+            // buffer of std::function.
+            (*_scheduler)([this]
+            {
+                std::shared_ptr<unary_call_data> self = std::move(_self);
+
+                // The callback is not kept past its invocation, even though
+                // the state of the call may be.
+                std::function<void(unary_call_result<Response>)> callback = std::move(_callback);
+                callback(unary_call_result<Response>{ _responseBuffer, _status, context(self) });
+            });
+        }
+
+        /// @brief The user callback to invoke with the response.
+        std::function<void(unary_call_result<Response>)> _callback;
+    };
+
+
+    /// @brief State of a call whose response is returned through a future.
+    template <typename Response>
+    class client::future_call_data final : public client::unary_call_data
+    {
+    public:
+        template <typename... Args>
+        explicit future_call_data(Args&&... args)
+            : unary_call_data(std::forward<Args>(args)...),
+              _promise(std::allocator_arg, pooled_allocator<unary_call_result<Response>>{})
+        {}
+
+        std::future<unary_call_result<Response>> get_future()
+        {
+            return _promise.get_future();
+        }
+
+    private:
+        void complete() override
+        {
+            std::shared_ptr<unary_call_data> self = std::move(_self);
+
+            // Fulfilling a promise runs no user code, so it is done right
+            // away instead of in the scheduler. The promise is released
+            // first, as its result references the state of the call.
+            std::promise<unary_call_result<Response>> promise = std::move(_promise);
+
+            if (_status.ok())
+            {
+                promise.set_value(unary_call_result<Response>{ _responseBuffer, _status, context(self) });
+            }
+            else
+            {
+                promise.set_exception(std::make_exception_ptr(UnaryCallException{ _status, context(self) }));
+            }
+        }
+
+        std::promise<unary_call_result<Response>> _promise;
+    };
+
+
+    template <typename CallData, typename... Args>
+    std::shared_ptr<CallData> client::make_call(std::shared_ptr<::grpc::ClientContext> context, Args&&... args)
+    {
+        channel_pool::lease lease;
+        std::shared_ptr<::grpc::ChannelInterface> channel;
+
+        if (_channels)
+        {
+            lease = _channels->acquire();
+            channel = lease.channel();
+        }
+        else
+        {
+            channel = _channel;
+        }
+
+        // The state of the call and its reference count are allocated
+        // together in a pooled block.
+        return std::allocate_shared<CallData>(
+            pooled_allocator<CallData>{},
+            std::forward<Args>(args)...,
+            _ioManager->shared_cq(),
+            std::move(channel),
+            std::move(context),
+            _scheduler,
+            _channels,
+            std::move(lease));
+    }
+
+    inline void client::start_call(
+        std::shared_ptr<unary_call_data> call,
+        const ::grpc::internal::RpcMethod& method,
+        const ::grpc::ByteBuffer& requestBuffer)
+    {
+        // `call` makes sure the state outlives the below calls, even if the
+        // response is received before they return.
+        if (_channels)
+        {
+            // The method is registered with the first channel only, so
+            // calls on pooled channels are made by name.
+            call->start(call, ::grpc::internal::RpcMethod{ method.name(), method.method_type() }, requestBuffer);
+        }
+        else
+        {
+            call->start(call, method, requestBuffer);
+        }
+    }
+
     template <typename Response, typename Request>
     void client::dispatch(
         const ::grpc::internal::RpcMethod& method,
@@ -243,14 +410,24 @@ namespace bond { namespace ext { namespace grpc { namespace detail
         const std::function<void(unary_call_result<Response>)>& cb,
         const bonded<Request>& request)
     {
-        new unary_call_data{
-            method,
-            Serialize(request),
-            _ioManager->shared_cq(),
-            _channel,
-            context ? std::move(context) : std::make_shared<::grpc::ClientContext>(),
-            _scheduler,
-            cb };
+        start_call(make_call<callback_call_data<Response>>(std::move(context), cb), method, Serialize(request));
+    }
+
+    template <typename Response, typename Request>
+    std::future<unary_call_result<Response>> client::dispatch(
+        const ::grpc::internal::RpcMethod& method,
+        std::shared_ptr<::grpc::ClientContext> context,
+        const bonded<Request>& request)
+    {
+        std::shared_ptr<future_call_data<Response>> call = make_call<future_call_data<Response>>(std::move(context));
+
+        // The future is retrieved before the call is started, as the
+        // promise is released as soon as the response is received.
+        std::future<unary_call_result<Response>> result = call->get_future();
+
+        start_call(std::move(call), method, Serialize(request));
+
+        return result;
     }
 
 } } } } // namespace bond::ext::grpc::detail
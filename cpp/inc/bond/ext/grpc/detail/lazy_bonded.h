@@ -23,6 +23,11 @@ namespace bond { namespace ext { namespace grpc { namespace detail
               _buffer{ buffer }
         {}
 
+        explicit lazy_bonded(const bonded<T>& value)
+            : _value{ value },
+              _buffer{}
+        {}
+
         const bonded<T>& get() const
         {
             TryDeserialize();
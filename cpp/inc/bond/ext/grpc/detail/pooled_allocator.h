@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include <boost/lockfree/stack.hpp>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace bond { namespace ext { namespace grpc { namespace detail
+{
+    /// @brief A process-wide cache of free memory blocks of \p BlockSize
+    /// bytes.
+    ///
+    /// Up to \p Capacity freed blocks are kept for reuse instead of being
+    /// returned to the global heap. Both allocation and deallocation are
+    /// lock-free and may happen on different threads.
+    template <std::size_t BlockSize, std::size_t Capacity = 256>
+    class block_pool
+    {
+    public:
+        static void* allocate()
+        {
+            void* block;
+            if (!free_blocks().pop(block))
+            {
+                block = ::operator new(BlockSize);
+            }
+
+            return block;
+        }
+
+        static void deallocate(void* block) noexcept
+        {
+            if (!free_blocks().bounded_push(block))
+            {
+                ::operator delete(block);
+            }
+        }
+
+    private:
+        using stack = boost::lockfree::stack<void*, boost::lockfree::capacity<Capacity>>;
+
+        static stack& free_blocks()
+        {
+            // Intentionally never destroyed, as blocks may be freed by
+            // threads that outlive static destruction.
+            static stack* blocks = new stack;
+            return *blocks;
+        }
+    };
+
+
+    /// @brief Standard allocator that allocates single objects from a
+    /// \ref block_pool shared by all the types of similar size.
+    ///
+    /// Used to keep the per-call state of clients off the global heap.
+    template <typename T>
+    class pooled_allocator
+    {
+    public:
+        using value_type = T;
+
+        pooled_allocator() = default;
+
+        template <typename U>
+        pooled_allocator(const pooled_allocator<U>& /*other*/) noexcept
+        {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(n == 1 ? pool::allocate() : ::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (n == 1)
+            {
+                pool::deallocate(p);
+            }
+            else
+            {
+                ::operator delete(p);
+            }
+        }
+
+        template <typename U>
+        bool operator==(const pooled_allocator<U>& /*other*/) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const pooled_allocator<U>& /*other*/) const noexcept
+        {
+            return false;
+        }
+
+    private:
+        static_assert(std::alignment_of<T>::value <= std::alignment_of<std::max_align_t>::value,
+            "Over-aligned types are not supported.");
+
+        // Round sizes up to 64 bytes so that the state of calls with
+        // different response and callback types shares the same blocks.
+        using pool = block_pool<(sizeof(T) + 63) / 64 * 64>;
+    };
+
+} } } } // namespace bond::ext::grpc::detail
@@ -8,6 +8,7 @@
 #include "io_manager_tag.h"
 
 #include <bond/ext/grpc/abstract_service.h>
+#include <bond/ext/grpc/admission_control.h>
 #include <bond/ext/grpc/scheduler.h>
 #include <bond/ext/grpc/unary_call.h>
 
@@ -62,6 +63,13 @@ namespace detail
             return _scheduler;
         }
 
+        /// @brief Gets the admission control used by the hosting server, if
+        /// any.
+        const std::shared_ptr<admission_control>& admission() const noexcept
+        {
+            return _admission;
+        }
+
         template <typename ServiceT, typename Request, typename Response>
         std::function<void(unary_call<Request, Response>)>
         static make_callback(void (ServiceT::*callback)(unary_call<Request, Response>), ServiceT& svc)
@@ -144,8 +152,15 @@ namespace detail
             _cq = cq;
         }
 
+        void SetAdmissionControl(std::shared_ptr<admission_control> admission)
+        {
+            BOOST_ASSERT(!_admission);
+            _admission = std::move(admission);
+        }
+
         Scheduler _scheduler;
         ::grpc::ServerCompletionQueue* _cq;
+        std::shared_ptr<admission_control> _admission;
     };
 
     /// @brief Implementation class that hold the state associated with
@@ -177,14 +192,54 @@ namespace detail
         template <typename Request, typename Response>
         void invoke(const std::function<void(unary_call<Request, Response>)>& callback)
         {
-            // TODO: Use lambda with move-capture when allowed to use C++14.
+            boost::intrusive_ptr<unary_call_impl> receivedCall = queue_receive();
+
+            const std::shared_ptr<admission_control>& admission = _service.admission();
+            if (!admission)
+            {
+                // TODO: Use lambda with move-capture when allowed to use C++14.
+                _service.scheduler()(std::bind(
+                    [](const decltype(callback)& cb, boost::intrusive_ptr<unary_call_impl>& call)
+                    {
+                        cb(unary_call<Request, Response>{ std::move(call) });
+                    },
+                    callback,
+                    std::move(receivedCall)));
+
+                return;
+            }
+
+            // Shed the call before it is queued, so that neither the
+            // scheduler nor the request deserialization spend any time on it.
+            ::grpc::Status status = admission->enter(receivedCall->context().deadline());
+            if (!status.ok())
+            {
+                receivedCall->Finish(status);
+                return;
+            }
+
+            receivedCall->admitted(admission);
+
             _service.scheduler()(std::bind(
-                [](const decltype(callback)& cb, boost::intrusive_ptr<unary_call_impl>& receivedCall)
+                [](const decltype(callback)& cb,
+                    boost::intrusive_ptr<unary_call_impl>& call,
+                    const std::shared_ptr<admission_control>& ac,
+                    admission_control::clock::time_point received)
                 {
-                    cb(unary_call<Request, Response>{ std::move(receivedCall) });
+                    ::grpc::Status dequeueStatus = ac->dequeue(call->context().deadline(), received);
+                    if (dequeueStatus.ok())
+                    {
+                        cb(unary_call<Request, Response>{ std::move(call) });
+                    }
+                    else
+                    {
+                        call->Finish(dequeueStatus);
+                    }
                 },
                 callback,
-                queue_receive()));
+                std::move(receivedCall),
+                admission,
+                admission_control::clock::now()));
         }
 
         void invoke(bool ok) override
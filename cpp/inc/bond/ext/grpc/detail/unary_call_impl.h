@@ -10,6 +10,7 @@
 #include "serialization.h"
 
 #include <bond/core/bonded.h>
+#include <bond/ext/grpc/admission_control.h>
 
 #ifdef _MSC_VER
     #pragma warning (push)
@@ -35,6 +36,7 @@
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include <atomic>
+#include <memory>
 #include <utility>
 
 namespace bond { namespace ext { namespace grpc { namespace detail
@@ -78,6 +80,15 @@ namespace bond { namespace ext { namespace grpc { namespace detail
             return _responder;
         }
 
+        /// @brief Associates an admitted call with the \ref
+        /// admission_control that admitted it, so that the call stops
+        /// being counted as in flight once its response has been sent.
+        void admitted(std::shared_ptr<admission_control> admission) noexcept
+        {
+            BOOST_ASSERT(!_admission);
+            _admission = std::move(admission);
+        }
+
         template <typename T = Void>
         void Finish(const T& response = {})
         {
@@ -106,6 +117,11 @@ namespace bond { namespace ext { namespace grpc { namespace detail
     private:
         void invoke(bool /* ok */) override
         {
+            if (_admission)
+            {
+                _admission->leave();
+            }
+
             // The response has been sent, so we no longer need to keep
             // ourselves alive: release the implicit initial refcount that
             // this instance was constructed with.
@@ -167,6 +183,8 @@ namespace bond { namespace ext { namespace grpc { namespace detail
         // sent, regardless of whether there are any outstanding user
         // references still alive.
         std::atomic<size_t> _refCount{ 1 };
+        // Set when the call has been admitted by admission control.
+        std::shared_ptr<admission_control> _admission;
     };
 
 
@@ -32,6 +32,16 @@ namespace bond { namespace ext { namespace grpc
         {}
     };
 
+    /// @brief %Exception thrown when a \ref channel_pool is created without
+    /// any channels.
+    class InvalidChannelCount : public Exception
+    {
+    public:
+        InvalidChannelCount()
+            : Exception{ "Invalid number of channels." }
+        {}
+    };
+
     /// @brief %Exception thrown when gRPC APIs return failure.
     class GrpcException : public Exception
     {
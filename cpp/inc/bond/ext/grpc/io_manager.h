@@ -37,6 +37,9 @@ namespace bond { namespace ext { namespace grpc
 
     } // namespace detail
 
+    template <typename Request, typename Response>
+    class request_batcher;
+
     /// @brief Manages a pool of threads polling for work from the same
     /// %::grpc::CompletionQueue
     ///
@@ -149,6 +152,9 @@ namespace bond { namespace ext { namespace grpc
     private:
         friend class detail::client;
 
+        template <typename Request, typename Response>
+        friend class request_batcher;
+
         const std::shared_ptr<::grpc::CompletionQueue>& shared_cq() const
         {
             return _cq;
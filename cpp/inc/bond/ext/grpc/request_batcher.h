@@ -0,0 +1,398 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "detail/io_manager_tag.h"
+#include "exception.h"
+#include "io_manager.h"
+#include "unary_call_result.h"
+
+#include <bond/core/bond_reflection.h>
+#include <bond/core/bonded.h>
+
+#ifdef _MSC_VER
+    #pragma warning (push)
+    #pragma warning (disable: 4100 4702)
+#endif
+
+#include <grpcpp/alarm.h>
+#include <grpcpp/impl/codegen/status.h>
+
+#ifdef _MSC_VER
+    #pragma warning (pop)
+#endif
+
+#include <boost/assert.hpp>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace bond { namespace ext { namespace grpc
+{
+    /// @brief Limits of the batches sent by \ref request_batcher.
+    struct batching_options
+    {
+        /// @brief Maximum number of requests sent in one batch. A batch is
+        /// sent as soon as it is full.
+        size_t max_batch_size = 64;
+
+        /// @brief Maximum time the first request of a batch waits for more
+        /// requests to join it. Zero sends every request on its own.
+        std::chrono::steady_clock::duration max_delay = std::chrono::milliseconds(1);
+    };
+
+    /// @brief Coalesces unary calls to the same method into batch calls.
+    ///
+    /// Requests passed to \ref Async are collected until either
+    /// \ref batching_options::max_batch_size of them are pending or the
+    /// first of them has waited for \ref batching_options::max_delay. They
+    /// are then sent in a single call to a batch method of the service that
+    /// accepts all the requests and returns one response per request, in
+    /// the same order:
+    ///
+    /// @code
+    /// service Backend
+    /// {
+    ///     Result Lookup(Query);
+    ///     bond.Box<list<bonded<Result>>> LookupBatch(bond.Box<list<bonded<Query>>>);
+    /// }
+    /// @endcode
+    ///
+    /// The callback of each request is invoked with its own response and
+    /// the status and client context of the batch call. When the batch call
+    /// fails, all of its callbacks are invoked with its status.
+    template <typename Request, typename Response>
+    class request_batcher final
+    {
+    public:
+        using batch_request = Box<std::list<bonded<Request>>>;
+        using batch_response = Box<std::list<bonded<Response>>>;
+
+        /// @brief Sends a batch, typically by calling the asynchronous
+        /// batch method of a generated client.
+        using batch_dispatcher = std::function<void(
+            const batch_request& request,
+            const std::function<void(unary_call_result<batch_response>)>& cb)>;
+
+        /// @brief Creates a batcher that sends batches using \p dispatch.
+        ///
+        /// @param ioManager the io_manager whose threads send the batches
+        /// that are due because of \ref batching_options::max_delay.
+        request_batcher(
+            const std::shared_ptr<io_manager>& ioManager,
+            batch_dispatcher dispatch,
+            const batching_options& options = {})
+            : _ioManager{ ioManager },
+              _state{ std::make_shared<state>(ioManager->shared_cq(), std::move(dispatch), options) }
+        {}
+
+        request_batcher(const request_batcher& other) = delete;
+        request_batcher& operator=(const request_batcher& other) = delete;
+
+        /// @brief Sends the pending requests and cancels the batch timer.
+        ~request_batcher()
+        {
+            _state->flush();
+        }
+
+        /// @brief Queues a request to be sent in the next batch.
+        void Async(const Request& request, const std::function<void(unary_call_result<Response>)>& cb)
+        {
+            Async(bonded<Request>{ request }, cb);
+        }
+
+        /// @brief Queues a request to be sent in the next batch.
+        void Async(const bonded<Request>& request, const std::function<void(unary_call_result<Response>)>& cb)
+        {
+            _state->add(request, cb);
+        }
+
+        /// @brief Queues a request to be sent in the next batch.
+        ///
+        /// @return a future that throws UnaryCallException if the batch
+        /// call fails.
+        std::future<unary_call_result<Response>> Async(const Request& request)
+        {
+            auto promise = std::make_shared<std::promise<unary_call_result<Response>>>();
+            auto result = promise->get_future();
+
+            Async(
+                request,
+                [promise](unary_call_result<Response> response)
+                {
+                    if (response.status().ok())
+                    {
+                        promise->set_value(std::move(response));
+                    }
+                    else
+                    {
+                        promise->set_exception(std::make_exception_ptr(
+                            UnaryCallException{ response.status(), response.context() }));
+                    }
+                });
+
+            return result;
+        }
+
+        /// @brief Sends the pending requests without waiting for the batch
+        /// to fill up.
+        void Flush()
+        {
+            _state->flush();
+        }
+
+        /// @brief Gets the number of requests waiting to be sent.
+        size_t pending() const
+        {
+            return _state->pending();
+        }
+
+    private:
+        using callback = std::function<void(unary_call_result<Response>)>;
+
+        class timer;
+
+        struct batch
+        {
+            std::list<bonded<Request>> requests;
+            std::vector<callback> callbacks;
+        };
+
+        class state : public std::enable_shared_from_this<state>
+        {
+        public:
+            state(
+                std::shared_ptr<::grpc::CompletionQueue> cq,
+                batch_dispatcher dispatch,
+                const batching_options& options)
+                : _cq(std::move(cq)),
+                  _dispatch(std::move(dispatch)),
+                  _options(options)
+            {
+                BOOST_ASSERT(_dispatch);
+                BOOST_ASSERT(_options.max_batch_size != 0);
+            }
+
+            void add(const bonded<Request>& request, const callback& cb)
+            {
+                batch due;
+
+                {
+                    std::lock_guard<std::mutex> lock{ _mutex };
+
+                    _pending.requests.push_back(request);
+                    _pending.callbacks.push_back(cb);
+
+                    if (_pending.callbacks.size() >= _options.max_batch_size
+                        || _options.max_delay == std::chrono::steady_clock::duration::zero())
+                    {
+                        take(due);
+                    }
+                    else if (_pending.callbacks.size() == 1)
+                    {
+                        _timer = new timer{ this->shared_from_this(), _cq, _options.max_delay };
+                    }
+                }
+
+                send(std::move(due));
+            }
+
+            void flush()
+            {
+                batch due;
+
+                {
+                    std::lock_guard<std::mutex> lock{ _mutex };
+                    take(due);
+                }
+
+                send(std::move(due));
+            }
+
+            /// @brief Sends the pending batch if \p expired is the timer
+            /// that was started for it and has not been cancelled.
+            void expire(const timer* expired, bool ok)
+            {
+                batch due;
+
+                {
+                    std::lock_guard<std::mutex> lock{ _mutex };
+
+                    if (expired == _timer)
+                    {
+                        _timer = nullptr;
+
+                        if (ok)
+                        {
+                            take(due);
+                        }
+                    }
+                }
+
+                send(std::move(due));
+            }
+
+            size_t pending() const
+            {
+                std::lock_guard<std::mutex> lock{ _mutex };
+                return _pending.callbacks.size();
+            }
+
+        private:
+            void take(batch& due)
+            {
+                std::swap(due, _pending);
+
+                if (_timer)
+                {
+                    // The timer is alive until it has been delivered and
+                    // has seen that it is no longer current, which needs
+                    // the lock held here.
+                    _timer->cancel();
+                    _timer = nullptr;
+                }
+            }
+
+            void send(batch due)
+            {
+                if (due.callbacks.empty())
+                {
+                    return;
+                }
+
+                batch_request request;
+                request.value.swap(due.requests);
+
+                auto callbacks = std::make_shared<std::vector<callback>>(std::move(due.callbacks));
+
+                _dispatch(
+                    request,
+                    [callbacks](unary_call_result<batch_response> result)
+                    {
+                        complete(*callbacks, result);
+                    });
+            }
+
+            static void complete(std::vector<callback>& callbacks, const unary_call_result<batch_response>& result)
+            {
+                if (!result.status().ok())
+                {
+                    for (callback& cb : callbacks)
+                    {
+                        if (cb)
+                        {
+                            cb(unary_call_result<Response>{ bonded<Response>{}, result.status(), result.context() });
+                        }
+                    }
+
+                    return;
+                }
+
+                batch_response responses;
+
+                try
+                {
+                    result.response().Deserialize(responses);
+                }
+                catch (const std::exception& ex)
+                {
+                    const ::grpc::Status status{ ::grpc::StatusCode::INTERNAL, ex.what() };
+
+                    for (callback& cb : callbacks)
+                    {
+                        if (cb)
+                        {
+                            cb(unary_call_result<Response>{ bonded<Response>{}, status, result.context() });
+                        }
+                    }
+
+                    return;
+                }
+
+                auto response = responses.value.begin();
+
+                for (callback& cb : callbacks)
+                {
+                    const bool missing = response == responses.value.end();
+
+                    if (cb)
+                    {
+                        if (missing)
+                        {
+                            cb(unary_call_result<Response>{
+                                bonded<Response>{},
+                                { ::grpc::StatusCode::INTERNAL, "The batch response has fewer responses than requests." },
+                                result.context() });
+                        }
+                        else
+                        {
+                            cb(unary_call_result<Response>{ *response, result.status(), result.context() });
+                        }
+                    }
+
+                    if (!missing)
+                    {
+                        ++response;
+                    }
+                }
+            }
+
+            const std::shared_ptr<::grpc::CompletionQueue> _cq;
+            const batch_dispatcher _dispatch;
+            const batching_options _options;
+            mutable std::mutex _mutex;
+            batch _pending;
+            /// The timer started for the pending batch, if any.
+            timer* _timer = nullptr;
+        };
+
+        /// @brief Sends the pending batch once it has waited for the
+        /// maximum delay. Deletes itself when it fires or is cancelled.
+        class timer final : detail::io_manager_tag
+        {
+        public:
+            timer(
+                std::shared_ptr<state> owner,
+                const std::shared_ptr<::grpc::CompletionQueue>& cq,
+                std::chrono::steady_clock::duration delay)
+                : _owner(std::move(owner))
+            {
+                _alarm.Set(
+                    cq.get(),
+                    std::chrono::system_clock::now()
+                        + std::chrono::duration_cast<std::chrono::system_clock::duration>(delay),
+                    tag());
+            }
+
+            void cancel()
+            {
+                _alarm.Cancel();
+            }
+
+        private:
+            void invoke(bool ok) override
+            {
+                std::unique_ptr<timer> self{ this };
+                _owner->expire(this, ok);
+            }
+
+            const std::shared_ptr<state> _owner;
+            ::grpc::Alarm _alarm;
+        };
+
+        /// Keeps the completion queue the timers are posted to polled. It
+        /// is destroyed last, after the timer has been cancelled.
+        std::shared_ptr<io_manager> _ioManager;
+        std::shared_ptr<state> _state;
+    };
+
+} } } // namespace bond::ext::grpc
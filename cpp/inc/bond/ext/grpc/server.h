@@ -38,6 +38,7 @@
 
 #include <bond/core/config.h>
 
+#include "admission_control.h"
 #include "detail/service.h"
 #include "exception.h"
 #include "io_manager.h"
@@ -85,34 +86,20 @@ namespace bond { namespace ext { namespace grpc
         /// for the provided services.
         static server Start(::grpc::ServerBuilder& builder, service_collection services)
         {
-            auto cq = builder.AddCompletionQueue();
-
-            for (const auto& item : boost::combine(services.services(), services.names()))
-            {
-                auto& service = item.get<0>();
-
-                if (const auto& host = item.get<1>())
-                {
-                    builder.RegisterService(host.value(), service->grpc_service());
-                }
-                else
-                {
-                    builder.RegisterService(service->grpc_service());
-                }
-
-                service->SetCompletionQueue(cq.get());
-            }
-
-            if (auto svr = builder.BuildAndStart())
-            {
-                return server{
-                    std::move(svr),
-                    std::move(services.services()),
-                    std::unique_ptr<io_manager>{ new io_manager{
-                        std::thread::hardware_concurrency(), /*delay=*/ false, std::move(cq) } } };
-            }
+            return Build(builder, std::move(services), nullptr);
+        }
 
-            throw ServerBuildException{};
+        /// @brief Builds and returns a running server which is ready to process calls
+        /// for the provided services and sheds load according to \p options.
+        ///
+        /// Calls that are not admitted are failed with RESOURCE_EXHAUSTED or
+        /// DEADLINE_EXCEEDED without invoking the service method.
+        static server Start(
+            ::grpc::ServerBuilder& builder,
+            service_collection services,
+            const admission_options& options)
+        {
+            return Build(builder, std::move(services), std::make_shared<admission_control>(options));
         }
 
         static server Start(::grpc::ServerBuilder& builder) = delete;
@@ -129,6 +116,22 @@ namespace bond { namespace ext { namespace grpc
             }
         }
 
+        /// @brief Gets the admission control of this server, or nullptr if
+        /// the server was started without one.
+        const admission_control* admission() const noexcept
+        {
+            return _admission.get();
+        }
+
+        /// @brief Creates a channel to this server that bypasses the network.
+        ///
+        /// Useful to measure the cost of calls without that of the
+        /// transport, or to call services hosted in the same process.
+        std::shared_ptr<::grpc::Channel> InProcessChannel(const ::grpc::ChannelArguments& args = {})
+        {
+            return _server->InProcessChannel(args);
+        }
+
         /// @brief Shutdown the server, blocking until all rpc processing
         /// finishes.
         ///
@@ -158,13 +161,56 @@ namespace bond { namespace ext { namespace grpc
         }
 
     private:
+        static server Build(
+            ::grpc::ServerBuilder& builder,
+            service_collection services,
+            std::shared_ptr<admission_control> admission)
+        {
+            auto cq = builder.AddCompletionQueue();
+
+            for (const auto& item : boost::combine(services.services(), services.names()))
+            {
+                auto& service = item.get<0>();
+
+                if (const auto& host = item.get<1>())
+                {
+                    builder.RegisterService(host.value(), service->grpc_service());
+                }
+                else
+                {
+                    builder.RegisterService(service->grpc_service());
+                }
+
+                service->SetCompletionQueue(cq.get());
+
+                if (admission)
+                {
+                    service->SetAdmissionControl(admission);
+                }
+            }
+
+            if (auto svr = builder.BuildAndStart())
+            {
+                return server{
+                    std::move(svr),
+                    std::move(services.services()),
+                    std::unique_ptr<io_manager>{ new io_manager{
+                        std::thread::hardware_concurrency(), /*delay=*/ false, std::move(cq) } },
+                    std::move(admission) };
+            }
+
+            throw ServerBuildException{};
+        }
+
         server(
             std::unique_ptr<::grpc::Server> server,
             std::vector<std::unique_ptr<detail::service>> services,
-            std::unique_ptr<io_manager> ioManager)
+            std::unique_ptr<io_manager> ioManager,
+            std::shared_ptr<admission_control> admission)
             : _server{ std::move(server) },
               _services{ std::move(services) },
-              _ioManager{ std::move(ioManager) }
+              _ioManager{ std::move(ioManager) },
+              _admission{ std::move(admission) }
         {
             BOOST_ASSERT(_server);
             BOOST_ASSERT(_ioManager);
@@ -183,6 +229,7 @@ namespace bond { namespace ext { namespace grpc
         std::unique_ptr<::grpc::Server> _server;
         std::vector<std::unique_ptr<detail::service>> _services;
         std::unique_ptr<io_manager> _ioManager;
+        std::shared_ptr<admission_control> _admission;
     };
 
 } } } //namespace bond::ext::grpc
@@ -78,6 +78,20 @@ namespace bond { namespace ext { namespace grpc
               _response{ responseBuffer }
         {}
 
+        /// @brief Create a unary_call_result with an already received
+        /// response.
+        ///
+        /// @param response The response.
+        /// @param status The status.
+        /// @param context the context under which the request is being executed.
+        unary_call_result(
+            const bonded<Response>& response,
+            const ::grpc::Status& status,
+            std::shared_ptr<::grpc::ClientContext> context)
+            : unary_call_result<void>(::grpc::ByteBuffer{}, status, std::move(context)),
+              _response{ response }
+        {}
+
         /// @brief The response received from the service.
         ///
         /// @note Depending on the implementation of the service, this may or
@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+namespace bond { namespace ext
+{
+    /// @brief Thread pool which runs the callbacks on the calling thread.
+    struct inline_thread_pool
+    {
+        template <typename Callback>
+        void operator()(Callback&& callback)
+        {
+            callback();
+        }
+    };
+
+} } // namespace bond::ext
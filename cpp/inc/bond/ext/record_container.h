@@ -0,0 +1,519 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "block_codec.h"
+#include "inline_thread_pool.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/exception.h>
+#include <bond/protocol/compact_binary.h>
+#include <bond/stream/input_buffer.h>
+#include <bond/stream/output_buffer.h>
+
+#include <boost/crc.hpp>
+#include <boost/make_shared.hpp>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/*
+    Record container
+    ================
+
+                     .-------.   .-------.-------.--------.
+   container         | block |...| block | index | footer |
+                     '-------'   '-------'-------'--------'
+
+                     .-------.---------.--------------.--------.----------.------.
+   block             | codec | records | uncompressed | stored | checksum | data |
+                     '-------'---------'--------------'--------'----------'------'
+
+   codec             uint8 id of the codec which compressed the data, 0 if the
+                     data is not compressed
+
+   records           uint32 count of records in the block
+
+   uncompressed      uint32 length of the decompressed data
+
+   stored            uint32 length of the data
+
+   checksum          uint32 CRC-32 of the data
+
+   data              records compressed with the codec:
+
+                     .--------.--------.   .--------.--------.
+                     | length | record |...| length | record |
+                     '--------'--------'   '--------'--------'
+
+                     variable encoded uint32 length of each record, which is
+                     marshaled using any protocol
+
+                     .--------.---------.   .--------.---------.
+   index             | offset | records |...| offset | records |
+                     '--------'---------'   '--------'---------'
+
+                     uint64 offset and uint32 count of records of each block
+
+                     .--------.--------.-------.
+   footer            | offset | blocks | magic |
+                     '--------'--------'-------'
+
+                     uint64 offset of the index, uint32 count of blocks and
+                     uint32 magic 0x43524e42 ("BNRC")
+
+   Integers of fixed size are little endian.
+*/
+
+namespace bond { namespace ext
+{
+    namespace detail
+    {
+        const uint32_t record_container_magic = 0x43524e42;
+        const uint32_t block_header_length = 1 + 4 + 4 + 4 + 4;
+        const uint32_t block_index_entry_length = 8 + 4;
+        const uint32_t record_container_footer_length = 8 + 4 + 4;
+
+        inline uint32_t block_checksum(const char* data, uint32_t length)
+        {
+            boost::crc_32_type crc;
+            crc.process_bytes(data, length);
+            return crc.checksum();
+        }
+
+    } // namespace detail
+
+
+    /// @brief Writes records into blocks of a record container.
+    ///
+    /// Each record is marshaled and appended to the current block. Once the
+    /// block holds \p block_size bytes of records it is compressed and
+    /// written to the output.
+    ///
+    /// @tparam Buffer output buffer/stream.
+    ///
+    /// @tparam Writer protocol writer used to marshal the records.
+    template <typename Buffer, typename Writer = CompactBinaryWriter<OutputBuffer>>
+    class record_container_writer
+    {
+        static_assert(std::is_same<typename Writer::Buffer, OutputBuffer>::value,
+            "Records are marshaled to an OutputBuffer");
+
+    public:
+        /// @brief Constructs a writer.
+        ///
+        /// @param output output buffer/stream, which must be empty.
+        ///
+        /// @param codec codec used to compress the blocks, \ref lz_codec if
+        /// null. The codec must outlive the writer.
+        ///
+        /// @param block_size size of the records in a block, after which
+        /// the block is written.
+        explicit record_container_writer(
+            Buffer& output,
+            const block_codec* codec = nullptr,
+            uint32_t block_size = 64 * 1024)
+            : _output(output),
+              _codec(codec ? codec : &_lz),
+              _block_size{ block_size },
+              _block{ block_size + block_size / 8 },
+              _block_records{ 0 },
+              _block_length{ 0 },
+              _offset{ 0 },
+              _scratch{ boost::make_shared_noinit<char[]>(scratch_size) }
+        {
+            BOOST_ASSERT(_codec->id() != 0);
+        }
+
+        record_container_writer(const record_container_writer&) = delete;
+        record_container_writer& operator=(const record_container_writer&) = delete;
+
+        /// @brief Writes a record, which can be an object or bonded<T>.
+        template <typename T>
+        void write(const T& record)
+        {
+            OutputBuffer output{ _scratch, scratch_size };
+            Writer writer{ output };
+
+            Marshal(record, writer);
+
+            // The data is copied because the scratch buffer is reused
+            const blob data = output.GetBuffer();
+
+            WriteVariableUnsigned(_block, data.length());
+            _block.Write(data.content(), data.length());
+
+            ++_block_records;
+            _block_length += data.length();
+
+            if (_block_length >= _block_size)
+            {
+                flush();
+            }
+        }
+
+        /// @brief Writes the last block and the index. No records can be
+        /// written after this call.
+        void close()
+        {
+            flush();
+
+            const uint64_t index_offset = _offset;
+
+            for (const block_entry& entry : _index)
+            {
+                _output.Write(entry.offset);
+                _output.Write(entry.records);
+            }
+
+            _output.Write(index_offset);
+            _output.Write(static_cast<uint32_t>(_index.size()));
+            _output.Write(detail::record_container_magic);
+        }
+
+    private:
+        static const uint32_t scratch_size = 4096;
+
+        struct block_entry
+        {
+            uint64_t offset;
+            uint32_t records;
+        };
+
+        void flush()
+        {
+            if (_block_records == 0)
+            {
+                return;
+            }
+
+            const blob data = _block.GetBuffer();
+
+            _compressed.resize(_codec->max_compressed_length(data.length()));
+
+            uint8_t codec = _codec->id();
+            uint32_t length = _codec->compress(data.content(), data.length(), _compressed.data());
+            const char* stored = _compressed.data();
+
+            if (length >= data.length())
+            {
+                codec = 0;
+                length = data.length();
+                stored = data.content();
+            }
+
+            _output.Write(codec);
+            _output.Write(_block_records);
+            _output.Write(data.length());
+            _output.Write(length);
+            _output.Write(detail::block_checksum(stored, length));
+            _output.Write(stored, length);
+
+            _index.push_back(block_entry{ _offset, _block_records });
+            _offset += detail::block_header_length + length;
+
+            _block = OutputBuffer{ _block_size + _block_size / 8 };
+            _block_records = 0;
+            _block_length = 0;
+        }
+
+        Buffer& _output;
+        lz_codec _lz;
+        const block_codec* _codec;
+        uint32_t _block_size;
+        OutputBuffer _block;
+        uint32_t _block_records;
+        uint32_t _block_length;
+        uint64_t _offset;
+        boost::shared_ptr<char[]> _scratch;
+        std::vector<char> _compressed;
+        std::vector<block_entry> _index;
+    };
+
+
+    /// @brief Reads the records of a record container.
+    ///
+    /// Blocks are verified and decompressed on the thread pool, a number of
+    /// blocks ahead of the record being read, and records are returned as
+    /// bonded<T> which reference the decompressed block.
+    ///
+    /// @tparam ThreadPool thread pool type, such as
+    /// \ref bond::ext::grpc::basic_thread_pool, with an operator() which
+    /// schedules a callback.
+    template <typename ThreadPool = inline_thread_pool>
+    class record_container_reader
+    {
+    public:
+        /// @brief Constructs a reader and starts decompressing the first blocks.
+        ///
+        /// @param data the container.
+        ///
+        /// @param thread_pool thread pool on which the blocks are decompressed.
+        ///
+        /// @param prefetch number of blocks decompressed ahead.
+        ///
+        /// @param codecs codecs of the blocks in addition to \ref lz_codec.
+        /// The codecs must outlive the reader.
+        ///
+        /// @throws StreamException if the footer or the index is malformed.
+        explicit record_container_reader(
+            const blob& data,
+            ThreadPool thread_pool = {},
+            uint32_t prefetch = 4,
+            std::initializer_list<const block_codec*> codecs = {})
+            : _data(data),
+              _thread_pool(std::move(thread_pool)),
+              _prefetch{ prefetch != 0 ? prefetch : 1 },
+              _codecs(),
+              _next{ 0 },
+              _scheduled{ 0 }
+        {
+            _codecs[_lz.id()] = &_lz;
+
+            for (const block_codec* codec : codecs)
+            {
+                _codecs[codec->id()] = codec;
+            }
+
+            read_index();
+            schedule();
+        }
+
+        record_container_reader(const record_container_reader&) = delete;
+        record_container_reader& operator=(const record_container_reader&) = delete;
+
+        ~record_container_reader()
+        {
+            wait();
+        }
+
+        /// @brief Number of blocks in the container.
+        uint32_t block_count() const
+        {
+            return static_cast<uint32_t>(_index.size());
+        }
+
+        /// @brief Number of records in the container.
+        uint64_t record_count() const
+        {
+            uint64_t count = 0;
+
+            for (const block_entry& entry : _index)
+            {
+                count += entry.records;
+            }
+
+            return count;
+        }
+
+        /// @brief Continues reading with the first record of \p block.
+        void seek(uint32_t block)
+        {
+            BOOST_ASSERT(block <= _index.size());
+
+            wait();
+            _pending.clear();
+            _records = InputBuffer();
+            _next = _scheduled = block;
+            schedule();
+        }
+
+        /// @brief Reads the next record.
+        ///
+        /// @return false after the last record.
+        ///
+        /// @throws StreamException if the block is corrupted.
+        template <typename T>
+        bool read(bonded<T>& record)
+        {
+            while (_records.IsEof())
+            {
+                if (_pending.empty())
+                {
+                    return false;
+                }
+
+                std::future<blob> block = std::move(_pending.front());
+
+                _pending.pop_front();
+                ++_next;
+                schedule();
+
+                _records = InputBuffer(block.get());
+            }
+
+            uint32_t length;
+            blob data;
+
+            ReadVariableUnsigned(_records, length);
+            _records.Read(data, length);
+
+            Unmarshal(InputBuffer(data), record);
+            return true;
+        }
+
+    private:
+        struct block_entry
+        {
+            uint64_t offset;
+            uint32_t records;
+        };
+
+        void read_index()
+        {
+            using namespace detail;
+
+            if (_data.length() < record_container_footer_length)
+            {
+                MalformedRecordContainerException("missing footer");
+            }
+
+            InputBuffer footer(_data.range(_data.length() - record_container_footer_length));
+            uint64_t index_offset;
+            uint32_t count, magic;
+
+            footer.Read(index_offset);
+            footer.Read(count);
+            footer.Read(magic);
+
+            if (magic != record_container_magic)
+            {
+                MalformedRecordContainerException("invalid magic");
+            }
+
+            // The index ends at the footer. The offset is checked on its own
+            // first, since adding the length of the index to it can overflow.
+            if (index_offset > _data.length() - record_container_footer_length
+                || index_offset + static_cast<uint64_t>(count) * block_index_entry_length
+                    != _data.length() - record_container_footer_length)
+            {
+                MalformedRecordContainerException("invalid index");
+            }
+
+            InputBuffer index(_data.range(static_cast<uint32_t>(index_offset)));
+            uint64_t end = 0;
+
+            _index.resize(count);
+
+            for (block_entry& entry : _index)
+            {
+                index.Read(entry.offset);
+                index.Read(entry.records);
+
+                // Blocks follow one another and precede the index. The length
+                // of the header is subtracted from the index offset, since
+                // adding it to the block offset can overflow.
+                if (entry.offset < end
+                    || index_offset < block_header_length
+                    || entry.offset > index_offset - block_header_length)
+                {
+                    MalformedRecordContainerException("invalid block offset");
+                }
+
+                end = entry.offset + block_header_length;
+            }
+
+            _index_offset = index_offset;
+        }
+
+        void schedule()
+        {
+            for (; _scheduled < _index.size() && _scheduled - _next < _prefetch; ++_scheduled)
+            {
+                const uint64_t offset = _index[_scheduled].offset;
+                const uint64_t end = _scheduled + 1 < _index.size()
+                    ? _index[_scheduled + 1].offset
+                    : _index_offset;
+
+                const blob data = _data.range(static_cast<uint32_t>(offset), static_cast<uint32_t>(end - offset));
+                const std::array<const block_codec*, 256>* codecs = &_codecs;
+
+                std::shared_ptr<std::packaged_task<blob()>> task =
+                    std::make_shared<std::packaged_task<blob()>>(
+                        [data, offset, codecs]
+                        {
+                            return decompress(data, offset, *codecs);
+                        });
+
+                _pending.push_back(task->get_future());
+                _thread_pool([task] { (*task)(); });
+            }
+        }
+
+        static blob decompress(const blob& block, uint64_t offset, const std::array<const block_codec*, 256>& codecs)
+        {
+            InputBuffer input(block);
+            uint8_t id;
+            uint32_t records, uncompressed, length, checksum;
+
+            input.Read(id);
+            input.Read(records);
+            input.Read(uncompressed);
+            input.Read(length);
+            input.Read(checksum);
+
+            if (length != block.length() - detail::block_header_length)
+            {
+                MalformedRecordContainerException("invalid block length");
+            }
+
+            const blob data = block.range(detail::block_header_length);
+
+            if (detail::block_checksum(data.content(), length) != checksum)
+            {
+                BlockChecksumException(offset);
+            }
+
+            if (id == 0)
+            {
+                if (uncompressed != length)
+                {
+                    MalformedRecordContainerException("invalid block length");
+                }
+
+                return data;
+            }
+
+            if (!codecs[id])
+            {
+                UnknownBlockCodecException(id);
+            }
+
+            boost::shared_ptr<char[]> buffer = boost::make_shared_noinit<char[]>(uncompressed);
+            codecs[id]->decompress(data.content(), length, buffer.get(), uncompressed);
+
+            return blob(buffer, uncompressed);
+        }
+
+        // Waits for the blocks being decompressed, which reference the codecs
+        void wait()
+        {
+            for (std::future<blob>& block : _pending)
+            {
+                block.wait();
+            }
+        }
+
+        blob _data;
+        ThreadPool _thread_pool;
+        uint32_t _prefetch;
+        lz_codec _lz;
+        std::array<const block_codec*, 256> _codecs;
+        std::vector<block_entry> _index;
+        uint64_t _index_offset;
+        std::deque<std::future<blob>> _pending;
+        InputBuffer _records;
+        uint32_t _next;
+        uint32_t _scheduled;
+    };
+
+} } // namespace bond::ext
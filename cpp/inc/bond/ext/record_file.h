@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "inline_thread_pool.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/box.h>
+#include <bond/core/exception.h>
+#include <bond/protocol/compact_binary.h>
+#include <bond/stream/input_buffer.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/*
+    Record file
+    ===========
+
+                     .--------.   .--------.
+   file              | record |...| record |
+                     '--------'   '--------'
+
+                     structs serialized one after another using Compact
+                     Binary v2 or later, each starting with its length
+
+                     .--------.   .--------.
+   index             | length |...| length |
+                     '--------'   '--------'
+
+                     list<uint32> of the lengths of the records, including
+                     the length prefixes, serialized as bond::Box using
+                     Compact Binary v3
+*/
+
+namespace bond { namespace ext
+{
+    /// @brief Scans the boundaries of the records of a record file.
+    ///
+    /// Only the length prefix of each record is read, so the scan is a
+    /// single pass which doesn't look at the fields.
+    ///
+    /// @return offsets of the records followed by the length of the file.
+    ///
+    /// @throws StreamException if the last record is truncated.
+    inline std::vector<uint32_t> index_records(const blob& data)
+    {
+        std::vector<uint32_t> index;
+        InputBuffer input(data);
+
+        while (!input.IsEof())
+        {
+            index.push_back(data.length() - GetCurrentBuffer(input).length());
+
+            uint32_t length;
+            blob record;
+
+            ReadVariableUnsigned(input, length);
+            input.Read(record, length);
+        }
+
+        index.push_back(data.length());
+        return index;
+    }
+
+
+    /// @brief Writes the index of a record file, which can be stored next to
+    /// the file so that readers don't have to scan it.
+    template <typename Buffer>
+    void write_record_index(Buffer& output, const std::vector<uint32_t>& index)
+    {
+        BOOST_ASSERT(!index.empty());
+
+        Box<std::vector<uint32_t>> lengths;
+
+        lengths.value.reserve(index.size() - 1);
+
+        for (size_t i = 1; i < index.size(); ++i)
+        {
+            lengths.value.push_back(index[i] - index[i - 1]);
+        }
+
+        CompactBinaryWriter<Buffer> writer(output, v3);
+        Serialize(lengths, writer);
+    }
+
+
+    /// @brief Reads an index written by \ref write_record_index.
+    ///
+    /// @return offsets of the records followed by the length of the file.
+    inline std::vector<uint32_t> read_record_index(const blob& data)
+    {
+        Box<std::vector<uint32_t>> lengths;
+        Deserialize(CompactBinaryReader<InputBuffer>(data, v3), lengths);
+
+        std::vector<uint32_t> index;
+        uint64_t offset = 0;
+
+        index.reserve(lengths.value.size() + 1);
+        index.push_back(0);
+
+        for (uint32_t length : lengths.value)
+        {
+            offset += length;
+
+            if (offset > (std::numeric_limits<uint32_t>::max)())
+            {
+                RecordIndexException(static_cast<uint32_t>(index.size() - 1));
+            }
+
+            index.push_back(static_cast<uint32_t>(offset));
+        }
+
+        return index;
+    }
+
+
+    /// @brief Deserializes the records of a record file in parallel.
+    ///
+    /// The file is partitioned into slices of consecutive records with about
+    /// the same length. The first slice is deserialized on the calling thread
+    /// and the others on the thread pool, each into its own range of
+    /// \p records, so that the records keep their order in the file.
+    ///
+    /// @param data the record file.
+    ///
+    /// @param index offsets of the records followed by the length of the
+    /// file, from \ref index_records or \ref read_record_index.
+    ///
+    /// @param records receives the records.
+    ///
+    /// @param thread_pool thread pool, such as
+    /// \ref bond::ext::grpc::basic_thread_pool, with an operator() which
+    /// schedules a callback.
+    ///
+    /// @param slices number of slices, usually the number of threads.
+    ///
+    /// @param version Compact Binary version of the records.
+    ///
+    /// @throws StreamException if the index doesn't match the file or a
+    /// record is malformed, after all the slices have completed. Records
+    /// which don't end where the next one starts are detected.
+    template <typename T, typename ThreadPool = inline_thread_pool>
+    void deserialize_records(
+        const blob& data,
+        const std::vector<uint32_t>& index,
+        std::vector<T>& records,
+        ThreadPool thread_pool = {},
+        uint32_t slices = 1,
+        uint16_t version = v2)
+    {
+        BOOST_ASSERT(v2 <= version);
+
+        const uint32_t count = index.empty() ? 0 : static_cast<uint32_t>(index.size() - 1);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (index[i + 1] < index[i])
+            {
+                RecordIndexException(i);
+            }
+        }
+
+        if (count != 0 && index[count] > data.length())
+        {
+            RecordIndexException(count - 1);
+        }
+
+        records.clear();
+        records.resize(count);
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        slices = (std::max)(1u, (std::min)(slices, count));
+
+        const uint64_t first = index.front();
+        const uint64_t length = index.back() - first;
+        std::vector<std::future<void>> pending;
+        std::packaged_task<void()> inline_slice;
+
+        for (uint32_t slice = 0, begin = 0; slice < slices; ++slice)
+        {
+            const uint32_t end = slice + 1 == slices
+                ? count
+                : static_cast<uint32_t>(std::lower_bound(
+                    index.begin() + begin, index.end() - 1,
+                    first + length * (slice + 1) / slices) - index.begin());
+
+            if (begin == end)
+            {
+                continue;
+            }
+
+            T* const output = &records[0];
+
+            auto task = [&data, &index, output, begin, end, version]
+            {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    using Reader = CompactBinaryReader<InputBuffer>;
+
+                    Reader reader(data.range(index[i], index[i + 1] - index[i]), version);
+
+                    bonded<T, Reader&>(reader).Deserialize(output[i]);
+
+                    // Each record ends where the next one starts
+                    if (!reader.GetBuffer().IsEof())
+                    {
+                        RecordIndexException(i);
+                    }
+                }
+            };
+
+            if (pending.empty())
+            {
+                inline_slice = std::packaged_task<void()>(task);
+                pending.push_back(inline_slice.get_future());
+            }
+            else
+            {
+                auto scheduled = std::make_shared<std::packaged_task<void()>>(task);
+
+                pending.push_back(scheduled->get_future());
+                thread_pool([scheduled] { (*scheduled)(); });
+            }
+
+            begin = end;
+        }
+
+        if (inline_slice.valid())
+        {
+            inline_slice();
+        }
+
+        // The slices reference the records, so all of them must complete
+        // before an exception is propagated
+        for (std::future<void>& slice : pending)
+        {
+            slice.wait();
+        }
+
+        for (std::future<void>& slice : pending)
+        {
+            slice.get();
+        }
+    }
+
+} } // namespace bond::ext
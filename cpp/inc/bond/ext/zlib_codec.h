@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "block_codec.h"
+
+#include <zlib.h>
+
+namespace bond { namespace ext
+{
+    /// @brief Codec using zlib, with id 2.
+    ///
+    /// The application must link with zlib to use this codec.
+    class zlib_codec : public block_codec
+    {
+    public:
+        /// @brief Constructs the codec.
+        ///
+        /// @param level zlib compression level, from 1 (fastest) to 9 (best
+        /// compression).
+        explicit zlib_codec(int level = Z_DEFAULT_COMPRESSION)
+            : _level{ level }
+        {}
+
+        uint8_t id() const override
+        {
+            return 2;
+        }
+
+        uint32_t max_compressed_length(uint32_t length) const override
+        {
+            return static_cast<uint32_t>(::compressBound(length));
+        }
+
+        uint32_t compress(const char* data, uint32_t length, char* output) const override
+        {
+            uLongf output_length = max_compressed_length(length);
+
+            if (::compress2(reinterpret_cast<Bytef*>(output), &output_length,
+                            reinterpret_cast<const Bytef*>(data), length, _level) != Z_OK)
+            {
+                BOND_THROW(StreamException, "zlib compression failed");
+            }
+
+            return static_cast<uint32_t>(output_length);
+        }
+
+        void decompress(const char* data, uint32_t length, char* output, uint32_t output_length) const override
+        {
+            uLongf decompressed = output_length;
+
+            if (::uncompress(reinterpret_cast<Bytef*>(output), &decompressed,
+                             reinterpret_cast<const Bytef*>(data), length) != Z_OK
+                || decompressed != output_length)
+            {
+                MalformedBlockException(id());
+            }
+        }
+
+    private:
+        int _level;
+    };
+
+} } // namespace bond::ext
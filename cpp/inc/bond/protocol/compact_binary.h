@@ -5,19 +5,26 @@
 
 #include <bond/core/config.h>
 
+#include "detail/packed_containers.h"
 #include "detail/simple_array.h"
+#include "detail/string_dictionary.h"
 #include "encoding.h"
 
+#include <bond/core/bond_types.h>
 #include <bond/core/bond_version.h>
 #include <bond/core/detail/checked.h>
+#include <bond/core/exception.h>
 #include <bond/core/traits.h>
+#include <bond/stream/input_buffer.h>
 #include <bond/stream/output_counter.h>
 
 #include <boost/call_traits.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/static_assert.hpp>
 
 #include <cstring>
+#include <limits>
 
 /*
 
@@ -26,7 +33,7 @@
                      '----------'--------------'   '----------'---------'
 
                      .----------.----------.--------------.   .----------.---------.
-   struct (v2)       |  length  |  fields  | BT_STOP_BASE |...|  fields  | BT_STOP |
+   struct (v2, v3)   |  length  |  fields  | BT_STOP_BASE |...|  fields  | BT_STOP |
                      '----------'----------'--------------'   '----------'---------'
 
    length             variable int encoded uint32 length of following fields, up to and
@@ -86,6 +93,11 @@
                                             and then encoded as unsigned integer
 
 
+                     fixed uint32,          little endian, in v3 for fields with the
+                     uint64, int32,         fixed attribute, which have types 19 (uint32),
+                     int64                  20 (uint64), 21 (int32) and 22 (int64)
+
+
                      float, double          little endian
 
 
@@ -100,6 +112,11 @@
                            characters       1-byte UTF-8 code units (for string) or 2-byte
                                             UTF-16LE code units (for wstring)
 
+                                            in record streams the count of a string is
+                                            shifted left by 1, or the string is replaced by
+                                            a reference to an earlier string, see
+                                            bond/core/record_stream.h
+
 
                                             .-------.-------.-------.
                      blob, list, set,       | type  | count | items |
@@ -111,7 +128,7 @@
                                                           4               0
 
                                             .---.---.---.---.---.---.---.---.
-                           type (v2)        | c | c | c | t | t | t | t | t |
+                           type (v2, v3)    | c | c | c | t | t | t | t | t |
                                             '---'---'---'---'---'---'---'---'
                                               2       0   4               0
 
@@ -119,9 +136,61 @@
                                             otherwise 'c' bits are 0.
 
                            count            variable encoded uint32 count of items
-                                            omitted in v2 if 'c' bits within type byte are not 0
+                                            omitted in v2 and v3 if 'c' bits within type byte
+                                            are not 0
+
+                           items            each item encoded according to its type, except
+                                            in v3 for more than one item of type bool,
+                                            uint16, uint32, uint64, int16, int32 or int64,
+                                            which are packed
+
+
+                                            .---.---.---.---.---.---.---.---.   .---.
+                     packed bools (v3)      | v | v | v | v | v | v | v | v |...| v |
+                                            '---'---'---'---'---'---'---'---'   '---'
+                                              7                           0
+
+                                            ceil(count / 8) bytes, item i is bit (i % 8) of
+                                            byte (i / 8), unused bits of the last byte are 0
+
+
+                                            .--------.-------.   .-------.
+                     packed items (v3)      | length | block |...| block |
+                                            '--------'-------'   '-------'
 
-                           items            each item encoded according to its type
+                                            .--------.------.   .------.
+                                            | length | item |...| item |
+                                            '--------'------'   '------'
+
+                           length           variable encoded uint64 length of following bytes
+                                            shifted left by 1, plus 1 if they are blocks;
+                                            otherwise they are items encoded as in v2,
+                                            which is used when blocks wouldn't be smaller
+
+                           block            up to 128 items, every block except the last has
+                                            128 items
+
+                                            .-------.-----.-------.------.
+                           block            | first | min | width | bits |
+                                            '-------'-----'-------'------'
+
+                           first            zig zag encoded delta of the first item in the
+                                            block from the last item of the previous block,
+                                            or from 0 for the first block
+
+                           min              zig zag encoded smallest delta of each following
+                                            item in the block from the preceding item
+
+                           width            uint8 count of bits, up to 64, of each packed
+                                            delta
+
+                           bits             packed (delta - min) of each following item in
+                                            ceil(width * (items - 1) / 8) bytes, least
+                                            significant bit first
+
+                                            min, width and bits are omitted for blocks of 1
+                                            item; items are sign extended to 64 bits and
+                                            deltas are computed modulo 2^64
 
 
                                             .----------.------------.-------.-----.-------.
@@ -142,6 +211,23 @@
 namespace bond
 {
 
+namespace detail
+{
+    // Compact Binary v3 types of integer fields written as little endian
+    // words, for fields with the fixed attribute
+    const uint8_t compact_fixed_uint32 = 19;
+    const uint8_t compact_fixed_uint64 = 20;
+    const uint8_t compact_fixed_int32 = 21;
+    const uint8_t compact_fixed_int64 = 22;
+
+    inline bool HasFixedAttribute(const Metadata& metadata)
+    {
+        return !metadata.attributes.empty()
+            && metadata.attributes.find("fixed") != metadata.attributes.end();
+    }
+
+} // namespace detail
+
 
 template <typename BufferT>
 class CompactBinaryWriter;
@@ -156,13 +242,19 @@ public:
     typedef CompactBinaryWriter<Buffer>         Writer;
 
     BOND_STATIC_CONSTEXPR uint16_t magic = COMPACT_PROTOCOL;
-    BOND_STATIC_CONSTEXPR uint16_t version = v2;
+    BOND_STATIC_CONSTEXPR uint16_t version = v3;
 
     /// @brief Construct from input buffer/stream containing serialized data.
     CompactBinaryReader(typename boost::call_traits<Buffer>::param_type input,
                         uint16_t version_value = default_version<CompactBinaryReader>::value)
         : _input(input),
-          _version(version_value)
+          _version(version_value),
+          _fixed(0),
+          _packed(0),
+          _packed_type(BT_STOP),
+          _varints(false),
+          _next(NULL),
+          _end(NULL)
     {
         BOOST_ASSERT(protocol_has_multiple_versions<CompactBinaryReader>::value
             ? _version <= CompactBinaryReader::version
@@ -176,7 +268,16 @@ public:
     /// @brief Copy constructor
     CompactBinaryReader(const CompactBinaryReader& that) BOND_NOEXCEPT
         : _input(that._input),
-          _version(that._version)
+          _version(that._version),
+          _fixed(that._fixed),
+          _packed(that._packed),
+          _packed_type(that._packed_type),
+          _varints(that._varints),
+          _items(that._items),
+          _next(that._next),
+          _end(that._end),
+          _block(that._block),
+          _strings(that._strings)
     {}
 
 
@@ -220,7 +321,7 @@ public:
     // ReadStructBegin
     void ReadStructBegin(bool base = false)
     {
-        if (!base && v2 == _version)
+        if (!base && v2 <= _version)
         {
             uint32_t length;
             Read(length);
@@ -241,6 +342,12 @@ public:
         type = static_cast<BondDataType>(raw & 0x1f);
         id = static_cast<uint16_t>(raw & (0x07 << 5));
 
+        // Versions before v3 don't define the types of fixed fields
+        if (type >= detail::compact_fixed_uint32 && v3 <= _version)
+        {
+            type = FixedFieldType(type);
+        }
+
         if (id == (0x07 << 5))
         {
             // ID is in (0xff, 0xffff] and is in the next two bytes
@@ -267,15 +374,26 @@ public:
     // ReadContainerBegin
     void ReadContainerBegin(uint32_t& size, BondDataType& type)
     {
-        uint8_t raw;
+        ReadContainerHeader(size, type);
 
-        _input.Read(raw);
-        type = static_cast<BondDataType>(raw & 0x1f);
+        if (IsPacked(size, type))
+        {
+            if (type != BT_BOOL)
+            {
+                // Items are decoded from their own buffer so that
+                // ReadContainerEnd can check that all of it was used
+                bool blocks;
+                blob items;
+
+                _input.Read(items, ReadPackedLength(blocks));
+                _items = InputBuffer(items);
+                _varints = !blocks;
+            }
 
-        if (v2 == _version && (raw & (0x07 << 5)))
-            size = (raw >> 5) - 1;
-        else
-            Read(size);
+            _packed = size;
+            _packed_type = type;
+            _next = _end = NULL;
+        }
     }
 
 
@@ -296,7 +414,14 @@ public:
 
     // ReadContainerEnd
     void ReadContainerEnd()
-    {}
+    {
+        if (_packed_type != BT_STOP && _packed_type != BT_BOOL && !_items.IsEof())
+        {
+            PackedIntegersLengthException();
+        }
+
+        _packed_type = BT_STOP;
+    }
 
 
     // Read for floating point
@@ -312,7 +437,18 @@ public:
     typename boost::enable_if<std::is_unsigned<T> >::type
     Read(T& value)
     {
-        ReadVariableUnsigned(_input, value);
+        if (_packed)
+        {
+            value = static_cast<T>(ReadPacked());
+        }
+        else if (_fixed)
+        {
+            value = static_cast<T>(ReadFixed());
+        }
+        else
+        {
+            ReadVariableUnsigned(_input, value);
+        }
     }
 
     // Read for signed integers
@@ -320,10 +456,21 @@ public:
     typename boost::enable_if<is_signed_int<T> >::type
     Read(T& value)
     {
-        typename std::make_unsigned<T>::type unsigned_value;
+        if (_packed)
+        {
+            value = static_cast<T>(ReadPacked());
+        }
+        else if (_fixed)
+        {
+            value = static_cast<T>(ReadFixed());
+        }
+        else
+        {
+            typename std::make_unsigned<T>::type unsigned_value;
 
-        ReadVariableUnsigned(_input, unsigned_value);
-        value = DecodeZigZag(unsigned_value);
+            ReadVariableUnsigned(_input, unsigned_value);
+            value = DecodeZigZag(unsigned_value);
+        }
     }
 
 
@@ -356,13 +503,80 @@ public:
     // Read for bool
     void Read(bool& value)
     {
-        _input.Read(value);
+        if (_packed)
+        {
+            value = ReadPacked() != 0;
+        }
+        else
+        {
+            _input.Read(value);
+        }
+    }
+
+
+    // Read for list of bools, following ReadContainerBegin. std::vector<bool>
+    // doesn't expose its words, so a bitmap is unpacked one bit at a time.
+    template <typename A>
+    void Read(std::vector<bool, A>& value, uint32_t size)
+    {
+        value.assign(size, false);
+
+        if (_packed)
+        {
+            BOOST_ASSERT(_packed_type == BT_BOOL && _packed == size && !_end);
+            blob bits;
+
+            _input.Read(bits, size / 8 + (size % 8 != 0));
+            _packed = 0;
+
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(bits.content());
+            typename std::vector<bool, A>::iterator it = value.begin();
+
+            for (uint32_t i = 0; i < size; ++i, ++it)
+            {
+                *it = (data[i >> 3] >> (i & 7)) & 1;
+            }
+        }
+        else
+        {
+            for (typename std::vector<bool, A>::iterator it = value.begin(); it != value.end(); ++it)
+            {
+                bool item;
+
+                _input.Read(item);
+                *it = item;
+            }
+        }
     }
 
 
     // Read for strings
     template <typename T>
-    typename boost::enable_if<is_string_type<T> >::type
+    typename boost::enable_if<is_string<T> >::type
+    Read(T& value)
+    {
+        uint32_t length = 0;
+
+        Read(length);
+
+        if (_strings)
+        {
+            if (length & 1)
+            {
+                detail::AssignStringData(value, _strings->Get(length >> 1));
+                return;
+            }
+
+            length >>= 1;
+        }
+
+        detail::ReadStringData(_input, value, length);
+    }
+
+
+    // Read for wstrings
+    template <typename T>
+    typename boost::enable_if<is_wstring<T> >::type
     Read(T& value)
     {
         uint32_t length = 0;
@@ -404,11 +618,182 @@ protected:
     using BT = BondDataType;
 #endif
 
+    void ReadContainerHeader(uint32_t& size, BondDataType& type)
+    {
+        uint8_t raw;
+
+        _input.Read(raw);
+        type = static_cast<BondDataType>(raw & 0x1f);
+
+        if (v2 <= _version && (raw & (0x07 << 5)))
+            size = (raw >> 5) - 1;
+        else
+            Read(size);
+    }
+
+    // Returns the type of a field with the fixed attribute, whose value is
+    // read by the following call to Read or Skip
+    BondDataType FixedFieldType(BondDataType type)
+    {
+        _fixed = static_cast<uint8_t>(type);
+
+        switch (_fixed)
+        {
+            case detail::compact_fixed_uint32:
+                return BT_UINT32;
+
+            case detail::compact_fixed_uint64:
+                return BT_UINT64;
+
+            case detail::compact_fixed_int32:
+                return BT_INT32;
+
+            case detail::compact_fixed_int64:
+                return BT_INT64;
+
+            default:
+                _fixed = 0;
+                return type;
+        }
+    }
+
+    // Returns the value of a field with the fixed attribute, sign extended
+    // to 64 bits
+    uint64_t ReadFixed()
+    {
+        const uint8_t type = _fixed;
+
+        _fixed = 0;
+
+        if (type == detail::compact_fixed_uint32 || type == detail::compact_fixed_int32)
+        {
+            uint32_t value;
+
+            _input.Read(value);
+
+            return type == detail::compact_fixed_int32
+                ? static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(value)))
+                : value;
+        }
+
+        uint64_t value;
+
+        _input.Read(value);
+        return value;
+    }
+
+    bool IsPacked(uint32_t size, BondDataType type) const
+    {
+        return v3 <= _version && size > 1
+            && (type == BT_BOOL
+                || type == BT_UINT16 || type == BT_UINT32 || type == BT_UINT64
+                || type == BT_INT16 || type == BT_INT32 || type == BT_INT64);
+    }
+
+    // Returns the length of packed items, which is written shifted left by 1,
+    // plus 1 if the items are encoded in blocks
+    uint32_t ReadPackedLength(bool& blocks)
+    {
+        uint64_t length;
+
+        ReadVariableUnsigned(_input, length);
+        blocks = (length & 1) != 0;
+
+        if ((length >> 1) > (std::numeric_limits<uint32_t>::max)())
+        {
+            PackedIntegersLengthException();
+        }
+
+        return static_cast<uint32_t>(length >> 1);
+    }
+
+    // Returns the next item of a packed container, sign extended to 64 bits
+    uint64_t ReadPacked()
+    {
+        if (_next == _end)
+        {
+            ReadPackedBlock();
+        }
+
+        --_packed;
+        return *_next++;
+    }
+
+    void ReadPackedBlock()
+    {
+        const uint64_t last = _end ? _end[-1] : 0;
+        const uint32_t size = (std::min)(_packed, detail::packed_block_size);
+
+        // Blocks are decoded in place unless the buffer is shared with a copy of the reader
+        if (!_block || !_block.unique())
+        {
+            _block = boost::make_shared<uint64_t[]>(detail::packed_block_size);
+        }
+
+        uint64_t* items = _block.get();
+        uint64_t raw;
+
+        _next = items;
+        _end = items + size;
+
+        if (_packed_type == BT_BOOL)
+        {
+            blob bits;
+
+            _input.Read(bits, size / 8 + (size % 8 != 0));
+            detail::DecodePackedBools(bits, items, size);
+            return;
+        }
+
+        if (_varints)
+        {
+            const bool zigzag = _packed_type == BT_INT16 || _packed_type == BT_INT32 || _packed_type == BT_INT64;
+
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                ReadVariableUnsigned(_items, raw);
+                items[i] = zigzag ? static_cast<uint64_t>(DecodeZigZag(raw)) : raw;
+            }
+
+            return;
+        }
+
+        ReadVariableUnsigned(_items, raw);
+        items[0] = last + static_cast<uint64_t>(DecodeZigZag(raw));
+
+        if (size > 1)
+        {
+            uint8_t width;
+            blob bits;
+
+            ReadVariableUnsigned(_items, raw);
+            _items.Read(width);
+
+            if (width > 64)
+            {
+                PackedIntegersWidthException(width);
+            }
+
+            _items.Read(bits, ((size - 1) * width + 7) / 8);
+            detail::DecodePackedDeltas(bits, width, static_cast<uint64_t>(DecodeZigZag(raw)), items, size);
+        }
+    }
+
     template <BT T>
     typename boost::enable_if_c<(T == BT_BOOL || T == BT_UINT8 || T == BT_INT8)>::type
     SkipType(uint32_t size = 1)
     {
-        _input.Skip(detail::checked_multiply(size, sizeof(uint8_t)));
+        if (_packed)
+        {
+            for (int64_t i = 0; i < size; ++i)
+            {
+                ReadPacked();
+            }
+        }
+        else
+        {
+            _input.Skip(detail::checked_multiply(size, sizeof(uint8_t)));
+        }
     }
 
     template <BT T>
@@ -441,6 +826,12 @@ protected:
         uint32_t length;
 
         Read(length);
+
+        if (_strings)
+        {
+            length = (length & 1) ? 0 : length >> 1;
+        }
+
         _input.Skip(length);
     }
 
@@ -461,8 +852,23 @@ protected:
         BondDataType element_type;
         uint32_t     size;
 
-        ReadContainerBegin(size, element_type);
-        SkipType(element_type, size);
+        ReadContainerHeader(size, element_type);
+
+        if (IsPacked(size, element_type) && element_type == BT_BOOL)
+        {
+            _input.Skip(size / 8 + (size % 8 != 0));
+        }
+        else if (IsPacked(size, element_type))
+        {
+            bool blocks;
+
+            _input.Skip(ReadPackedLength(blocks));
+        }
+        else
+        {
+            SkipType(element_type, size);
+        }
+
         ReadContainerEnd();
     }
 
@@ -509,7 +915,7 @@ protected:
 
     void SkipStructV2()
     {
-        BOOST_ASSERT(v2 == _version);
+        BOOST_ASSERT(v2 <= _version);
 
         uint32_t length;
         Read(length);
@@ -520,7 +926,7 @@ protected:
     typename boost::enable_if_c<(T == BT_STRUCT)>::type
     SkipType()
     {
-        if (v2 == _version)
+        if (v2 <= _version)
         {
             SkipStructV2();
         }
@@ -534,7 +940,7 @@ protected:
     typename boost::enable_if_c<(T == BT_STRUCT)>::type
     SkipType(uint32_t size)
     {
-        if (v2 == _version)
+        if (v2 <= _version)
         {
             for (int64_t i = 0; i < size; ++i)
             {
@@ -620,6 +1026,25 @@ protected:
     Buffer  _input;
     uint16_t _version;
 
+    // Type of the field with the fixed attribute being read
+    uint8_t _fixed;
+
+    // Items left in the packed container being read, their type and encoding,
+    // and the decoded block
+    uint32_t _packed;
+    BondDataType _packed_type;
+    bool _varints;
+    InputBuffer _items;
+    const uint64_t* _next;
+    const uint64_t* _end;
+    boost::shared_ptr<uint64_t[]> _block;
+
+    // Strings of the record stream being read
+    boost::shared_ptr<const detail::StringTable> _strings;
+
+    template <typename Buffer>
+    friend class RecordReader;
+
     template <typename Input, typename Output>
     friend
     bool is_protocol_version_same(const CompactBinaryReader<Input>&,
@@ -673,7 +1098,12 @@ public:
                         uint16_t version = default_version<Reader>::value)
         : _output(output),
           _it(NULL),
-          _version(version)
+          _version(version),
+          _fixed(false),
+          _packing(BT_STOP),
+          _packed_bits(0),
+          _packed_byte(0),
+          _strings(NULL)
     {
         BOOST_ASSERT(protocol_has_multiple_versions<Reader>::value
             ? _version <= Reader::version
@@ -684,7 +1114,12 @@ public:
     CompactBinaryWriter(Counter& output,
                         const CompactBinaryWriter<T>& pass1)
         : _output(output),
-          _version(pass1._version)
+          _version(pass1._version),
+          _fixed(false),
+          _packing(BT_STOP),
+          _packed_bits(0),
+          _packed_byte(0),
+          _strings(pass1._strings)
     {}
 
 
@@ -698,7 +1133,7 @@ public:
 
     bool NeedPass0()
     {
-        return v2 == _version && !_it;
+        return v2 <= _version && !_it;
     }
 
 
@@ -738,17 +1173,28 @@ public:
 
     // WriteField for basic types
     template <typename T>
-    void WriteField(uint16_t id, const bond::Metadata& /*metadata*/, const T& value)
+    void WriteField(uint16_t id, const bond::Metadata& metadata, const T& value)
     {
-        WriteFieldBegin(get_type_id<T>::value, id);
+        WriteFieldBegin(get_type_id<T>::value, id, metadata);
         Write(value);
         WriteFieldEnd();
     }
 
     // WriteFieldBegin
-    void WriteFieldBegin(BondDataType type, uint16_t id, const ::bond::Metadata& /*metadata*/)
+    void WriteFieldBegin(BondDataType type, uint16_t id, const ::bond::Metadata& metadata)
     {
-        WriteFieldBegin(type, id);
+        if (v3 <= _version
+            && (type == BT_UINT32 || type == BT_UINT64 || type == BT_INT32 || type == BT_INT64)
+            && detail::HasFixedAttribute(metadata))
+        {
+            // The value is written as a little endian word by the following Write
+            _fixed = true;
+            WriteFieldBegin(FixedFieldType(type), id);
+        }
+        else
+        {
+            WriteFieldBegin(type, id);
+        }
     }
 
     void WriteFieldBegin(BondDataType type, uint16_t id)
@@ -780,7 +1226,7 @@ public:
     {
         BOOST_ASSERT((type & 0x1f) == type);
 
-        if (v2 == _version && size < 7)
+        if (v2 <= _version && size < 7)
         {
             Write(static_cast<uint8_t>(type | ((size + 1) << 5)));
         }
@@ -789,6 +1235,17 @@ public:
             Write(static_cast<uint8_t>(type));
             Write(size);
         }
+
+        if (v3 <= _version && size > 1
+            && (type == BT_BOOL
+                || type == BT_UINT16 || type == BT_UINT32 || type == BT_UINT64
+                || type == BT_INT16 || type == BT_INT32 || type == BT_INT64))
+        {
+            _packing = type;
+            _packed.clear();
+            _packed_bits = 0;
+            _packed_byte = 0;
+        }
     }
 
     // container of 2-tuples (e.g. map)
@@ -801,7 +1258,13 @@ public:
 
     // WriteContainerEnd
     void WriteContainerEnd()
-    {}
+    {
+        if (_packing != BT_STOP)
+        {
+            WritePacked();
+            _packing = BT_STOP;
+        }
+    }
 
     // Write for floating point
     template <typename T>
@@ -816,7 +1279,19 @@ public:
     typename boost::enable_if<std::is_unsigned<T> >::type
     Write(const T& value)
     {
-        WriteVariableUnsigned(_output, value);
+        if (_packing != BT_STOP)
+        {
+            _packed.push_back(value);
+        }
+        else if (_fixed)
+        {
+            _fixed = false;
+            _output.Write(value);
+        }
+        else
+        {
+            WriteVariableUnsigned(_output, value);
+        }
     }
 
     // Write for signed integers
@@ -824,7 +1299,19 @@ public:
     typename boost::enable_if<is_signed_int<T> >::type
     Write(const T& value)
     {
-        WriteVariableUnsigned(_output, EncodeZigZag(value));
+        if (_packing != BT_STOP)
+        {
+            _packed.push_back(static_cast<uint64_t>(static_cast<int64_t>(value)));
+        }
+        else if (_fixed)
+        {
+            _fixed = false;
+            _output.Write(value);
+        }
+        else
+        {
+            WriteVariableUnsigned(_output, EncodeZigZag(value));
+        }
     }
 
     // Write for enums
@@ -851,12 +1338,54 @@ public:
     // Write for bool
     void Write(const bool& value)
     {
-        _output.Write(value);
+        if (_packing != BT_STOP)
+        {
+            _packed_byte |= static_cast<uint8_t>(value) << (_packed_bits++ & 7);
+
+            if ((_packed_bits & 7) == 0)
+            {
+                _output.Write(_packed_byte);
+                _packed_byte = 0;
+            }
+        }
+        else
+        {
+            _output.Write(value);
+        }
     }
 
     // Write for strings
     template <typename T>
-    typename boost::enable_if<is_string_type<T> >::type
+    typename boost::enable_if<is_string<T> >::type
+    Write(const T& value)
+    {
+        uint32_t length = string_length(value);
+
+        if (_strings)
+        {
+            // Both passes find the same ids, the first adds the new strings
+            uint32_t id;
+
+            if (_strings->Find(string_data(value), length, id))
+            {
+                Write((id << 1) | 1);
+                return;
+            }
+
+            Write(length << 1);
+        }
+        else
+        {
+            Write(length);
+        }
+
+        detail::WriteStringData(_output, value, length);
+    }
+
+
+    // Write for wstrings
+    template <typename T>
+    typename boost::enable_if<is_wstring<T> >::type
     Write(const T& value)
     {
         uint32_t length = string_length(value);
@@ -892,7 +1421,7 @@ protected:
     template<typename T>
     void LengthBegin(T&)
     {
-        if (v2 == _version)
+        if (v2 <= _version)
         {
             Write(*_it++);
         }
@@ -902,12 +1431,70 @@ protected:
     void LengthEnd(T&)
     {}
 
+    static BondDataType FixedFieldType(BondDataType type)
+    {
+        switch (type)
+        {
+            case BT_UINT32:
+                return static_cast<BondDataType>(detail::compact_fixed_uint32);
+
+            case BT_UINT64:
+                return static_cast<BondDataType>(detail::compact_fixed_uint64);
+
+            case BT_INT32:
+                return static_cast<BondDataType>(detail::compact_fixed_int32);
+
+            default:
+                return static_cast<BondDataType>(detail::compact_fixed_int64);
+        }
+    }
+
+    void WritePacked()
+    {
+        if (_packing == BT_BOOL)
+        {
+            // Bools are written as they are packed, except for the last byte
+            if (_packed_bits & 7)
+            {
+                _output.Write(_packed_byte);
+            }
+        }
+        else
+        {
+            const uint32_t size = static_cast<uint32_t>(_packed.size());
+            const bool zigzag = _packing == BT_INT16 || _packing == BT_INT32 || _packing == BT_INT64;
+            uint64_t blocks = 1;
+
+            detail::EncodePackedIntegers(_packed.data(), size, _bytes);
+
+            // Items that don't pack, e.g. random values, are written as in v2
+            if (detail::VariableIntegersLength(_packed.data(), size, zigzag) <= _bytes.size())
+            {
+                detail::EncodeVariableIntegers(_packed.data(), size, zigzag, _bytes);
+                blocks = 0;
+            }
+
+            WriteVariableUnsigned(_output, static_cast<uint64_t>(_bytes.size()) << 1 | blocks);
+            _output.Write(_bytes.data(), static_cast<uint32_t>(_bytes.size()));
+        }
+    }
+
 protected:
     Buffer&                         _output;
     const uint32_t*                 _it;
     uint16_t                        _version;
+    bool                            _fixed;
     detail::SimpleArray<uint32_t>   _stack;
     detail::SimpleArray<uint32_t>   _lengths;
+    BondDataType                    _packing;
+    uint32_t                        _packed_bits;
+    uint8_t                         _packed_byte;
+    std::vector<uint64_t>           _packed;
+    std::vector<uint8_t>            _bytes;
+    detail::StringIds*              _strings;
+
+    template <typename Buffer>
+    friend class RecordWriter;
 
     template <typename Input, typename Output>
     friend
@@ -924,7 +1511,11 @@ inline
 bool is_protocol_version_same(const CompactBinaryReader<Input>& reader,
                               const CompactBinaryWriter<Output>& writer)
 {
-    return reader._version == writer._version;
+    // Strings of record streams are written once per stream, so structs
+    // can't be copied between streams
+    return reader._version == writer._version
+        && !reader._strings
+        && !writer._strings;
 }
 
 } // namespace bond
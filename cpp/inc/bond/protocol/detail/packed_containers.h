@@ -0,0 +1,227 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include <bond/core/blob.h>
+
+#include "../encoding.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace bond
+{
+namespace detail
+{
+
+// Number of items in a block of packed integers: the first item followed by
+// up to packed_block_size - 1 bit-packed deltas.
+BOND_CONSTEXPR_OR_CONST uint32_t packed_block_size = 128;
+
+// Upper bound of the encoded size of a block
+BOND_CONSTEXPR_OR_CONST uint32_t packed_block_max_length = 10 + 10 + 1 + (packed_block_size - 1) * 8;
+
+
+inline uint8_t BitWidth(uint64_t value)
+{
+    uint8_t width = 0;
+
+    for (; value; value >>= 1)
+        ++width;
+
+    return width;
+}
+
+
+inline uint8_t* EncodeVariableUnsigned(uint8_t* output, uint64_t value)
+{
+    for (; value >= 0x80; value >>= 7)
+        *output++ = static_cast<uint8_t>(value | 0x80);
+
+    *output++ = static_cast<uint8_t>(value);
+    return output;
+}
+
+
+inline uint8_t* EncodeBytes(uint8_t* output, uint64_t word, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, word >>= 8)
+        *output++ = static_cast<uint8_t>(word);
+
+    return output;
+}
+
+
+// Write items, each less than 2^width, as a little endian bit stream, least
+// significant bit first.
+inline uint8_t* PackBits(const uint64_t* items, uint32_t count, uint8_t width, uint8_t* output)
+{
+    uint64_t word = 0;
+    uint32_t bits = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        word |= items[i] << bits;
+        bits += width;
+
+        if (bits >= 64)
+        {
+            output = EncodeBytes(output, word, 8);
+            bits -= 64;
+            word = bits ? items[i] >> (width - bits) : 0;
+        }
+    }
+
+    return EncodeBytes(output, word, (bits + 7) / 8);
+}
+
+
+// Extract the width-bit item at bit offset within the bit stream. The item
+// must lie within the data, which is read a word at a time when possible.
+inline uint64_t UnpackBits(const uint8_t* data, uint32_t length, uint32_t offset, uint8_t width)
+{
+    const uint32_t available = length - (offset >> 3);
+    const uint32_t shift = offset & 7;
+    uint64_t word = 0;
+
+    data += offset >> 3;
+
+    if (available >= 8)
+    {
+        // Like the rest of the protocol implementation this assumes a little
+        // endian platform.
+        std::memcpy(&word, data, sizeof(word));
+    }
+    else
+    {
+        for (uint32_t i = 0; i < available; ++i)
+            word |= static_cast<uint64_t>(data[i]) << (i * 8);
+    }
+
+    uint64_t value = word >> shift;
+
+    if (shift + width > 64)
+        value |= static_cast<uint64_t>(data[8]) << (64 - shift);
+
+    return width < 64 ? value & ((uint64_t(1) << width) - 1) : value;
+}
+
+
+// Encode integers, sign extended to 64 bits, in blocks of packed_block_size
+// items. Each block has the delta of its first item from the last item of
+// the previous block, followed by the remaining deltas as bit-packed offsets
+// from the smallest delta in the block. See compact_binary.h for the layout.
+inline void EncodePackedIntegers(const uint64_t* items, uint32_t count, std::vector<uint8_t>& output)
+{
+    output.resize((count / packed_block_size + 1) * packed_block_max_length);
+
+    uint8_t* data = output.data();
+    uint64_t deltas[packed_block_size - 1];
+    uint64_t last = 0;
+
+    for (uint32_t i = 0; i < count;)
+    {
+        data = EncodeVariableUnsigned(data, EncodeZigZag(static_cast<int64_t>(items[i] - last)));
+        last = items[i++];
+
+        const uint32_t size = (std::min)(count - i, packed_block_size - 1);
+
+        if (size == 0)
+            break;
+
+        int64_t min = (std::numeric_limits<int64_t>::max)();
+
+        for (uint32_t j = 0; j < size; ++j)
+        {
+            deltas[j] = items[i + j] - items[i + j - 1];
+            min = (std::min)(min, static_cast<int64_t>(deltas[j]));
+        }
+
+        uint64_t bits = 0;
+
+        for (uint32_t j = 0; j < size; ++j)
+        {
+            deltas[j] -= static_cast<uint64_t>(min);
+            bits |= deltas[j];
+        }
+
+        const uint8_t width = BitWidth(bits);
+
+        data = EncodeVariableUnsigned(data, EncodeZigZag(min));
+        *data++ = width;
+        data = PackBits(deltas, size, width, data);
+
+        i += size;
+        last = items[i - 1];
+    }
+
+    output.resize(data - output.data());
+}
+
+
+// Length of items, sign extended to 64 bits, written as variable integers as
+// outside of packed containers, zig zag encoded if they are signed.
+inline uint64_t VariableIntegersLength(const uint64_t* items, uint32_t count, bool zigzag)
+{
+    uint64_t length = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint64_t value = zigzag ? EncodeZigZag(static_cast<int64_t>(items[i])) : items[i];
+        length += (std::max)(1, (BitWidth(value) + 6) / 7);
+    }
+
+    return length;
+}
+
+
+inline void EncodeVariableIntegers(const uint64_t* items, uint32_t count, bool zigzag, std::vector<uint8_t>& output)
+{
+    output.resize(static_cast<size_t>(count) * 10);
+
+    uint8_t* data = output.data();
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        data = EncodeVariableUnsigned(data, zigzag ? EncodeZigZag(static_cast<int64_t>(items[i])) : items[i]);
+    }
+
+    output.resize(data - output.data());
+}
+
+
+// Decode the bit-packed deltas following the first item of a block
+inline void DecodePackedDeltas(const blob& bits, uint8_t width, uint64_t min, uint64_t* items, uint32_t count)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bits.content());
+    const uint32_t length = bits.length();
+
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        items[i] = min + UnpackBits(data, length, (i - 1) * width, width);
+    }
+
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        items[i] += items[i - 1];
+    }
+}
+
+// Decode up to packed_block_size bools, one bit each, least significant bit first
+inline void DecodePackedBools(const blob& bits, uint64_t* items, uint32_t count)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bits.content());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        items[i] = (data[i >> 3] >> (i & 7)) & 1;
+    }
+}
+
+} // namespace detail
+} // namespace bond
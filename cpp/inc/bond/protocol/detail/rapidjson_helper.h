@@ -291,7 +291,7 @@ typename boost::enable_if<is_string<T> >::type
 Read(const rapidjson::Value& value, T& var)
 {
     const uint32_t length = value.GetStringLength();
-    resize_string(var, length);
+    resize_string_for_overwrite(var, length);
 
     std::copy(make_checked_array_iterator(value.GetString(), length),
               make_checked_array_iterator(value.GetString(), length, length),
@@ -309,7 +309,7 @@ Read(const rapidjson::Value& value, T& var)
         value.GetString() + value.GetStringLength());
 
     const size_t length = str.size();
-    resize_string(var, static_cast<uint32_t>(length));
+    resize_string_for_overwrite(var, static_cast<uint32_t>(length));
 
     std::copy(
         str.begin(),
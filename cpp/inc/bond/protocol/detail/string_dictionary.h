@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include <bond/core/blob.h>
+#include <bond/core/exception.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <cstring>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bond
+{
+namespace detail
+{
+
+// Ids of the strings written since the last reset, up to a maximum number of
+// strings. Each string is added the first time it is written and the strings
+// added since the last call to Added() are defined after the record.
+class StringIds
+{
+    struct Key
+    {
+        const char* data;
+        uint32_t length;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return boost::hash_range(key.data, key.data + key.length);
+        }
+    };
+
+    struct KeyEqual
+    {
+        bool operator()(const Key& x, const Key& y) const
+        {
+            return x.length == y.length && 0 == std::memcmp(x.data, y.data, x.length);
+        }
+    };
+
+public:
+    explicit StringIds(uint32_t max_size)
+        : _max_size(max_size),
+          _added(0)
+    {}
+
+    // Returns false if the string is not in the dictionary and can't be added
+    bool Find(const char* data, uint32_t length, uint32_t& id)
+    {
+        const Key key = { data, length };
+        const std::unordered_map<Key, uint32_t, KeyHash, KeyEqual>::const_iterator it = _ids.find(key);
+
+        if (it != _ids.end())
+        {
+            id = it->second;
+            return true;
+        }
+
+        if (length == 0 || _strings.size() == _max_size)
+        {
+            return false;
+        }
+
+        // Key references the copy of the string, which doesn't move in a deque
+        _strings.push_back(std::string(data, length));
+
+        const Key copy = { _strings.back().data(), length };
+        id = static_cast<uint32_t>(_strings.size() - 1);
+        _ids.insert(std::make_pair(copy, id));
+        return true;
+    }
+
+    // Returns the strings added since the previous call
+    std::deque<std::string>::const_iterator Added()
+    {
+        std::deque<std::string>::const_iterator it = _strings.begin() + _added;
+
+        _added = _strings.size();
+        return it;
+    }
+
+    std::deque<std::string>::const_iterator End() const
+    {
+        return _strings.end();
+    }
+
+    void Clear()
+    {
+        _ids.clear();
+        _strings.clear();
+        _added = 0;
+    }
+
+private:
+    uint32_t _max_size;
+    size_t _added;
+    std::deque<std::string> _strings;
+    std::unordered_map<Key, uint32_t, KeyHash, KeyEqual> _ids;
+};
+
+
+// Strings defined since the last reset, referencing the input buffer
+class StringTable
+{
+public:
+    void Add(const blob& data)
+    {
+        _strings.push_back(data);
+    }
+
+    const blob& Get(uint32_t id) const
+    {
+        if (id >= _strings.size())
+        {
+            StringIdException(id, static_cast<uint32_t>(_strings.size()));
+        }
+
+        return _strings[id];
+    }
+
+private:
+    std::vector<blob> _strings;
+};
+
+} // namespace detail
+
+} // namespace bond
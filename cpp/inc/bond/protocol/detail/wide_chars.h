@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BOND_WIDE_CHARS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace bond
+{
+namespace detail
+{
+
+// Number of code units converted at a time by ReadStringData and
+// WriteStringData for strings with characters wider than the code units.
+const uint32_t wide_chars_block = 256;
+
+
+// Zero-extends code units to wider characters, e.g. UTF-16 code units to
+// 4-byte wchar_t.
+template <typename U, typename C>
+inline void WidenChars(const U* src, C* dst, uint32_t count)
+{
+    uint32_t i = 0;
+
+#ifdef BOND_WIDE_CHARS_SSE2
+    if (sizeof(U) == sizeof(uint16_t) && sizeof(C) == sizeof(uint32_t))
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(units, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(units, zero));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+        dst[i] = static_cast<C>(src[i]);
+}
+
+
+// Truncates wider characters to code units, keeping the low bits.
+template <typename C, typename U>
+inline void NarrowChars(const C* src, U* dst, uint32_t count)
+{
+    uint32_t i = 0;
+
+#ifdef BOND_WIDE_CHARS_SSE2
+    if (sizeof(U) == sizeof(uint16_t) && sizeof(C) == sizeof(uint32_t))
+    {
+        for (; i + 8 <= count; i += 8)
+        {
+            // Sign-extend the low 16 bits so that the saturating pack
+            // doesn't change them.
+            const __m128i lo = _mm_srai_epi32(_mm_slli_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), 16), 16);
+            const __m128i hi = _mm_srai_epi32(_mm_slli_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)), 16), 16);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+        dst[i] = static_cast<U>(src[i]);
+}
+
+} // namespace detail
+} // namespace bond
@@ -8,6 +8,9 @@
 #include <bond/core/blob.h>
 #include <bond/core/containers.h>
 
+#include "detail/wide_chars.h"
+
+#include <cstring>
 #include <exception>
 #include <stdio.h>
 
@@ -184,25 +187,57 @@ string_char_int_type<T, typename boost::enable_if<is_wstring<T> >::type>
 };
 
 template <typename Buffer, typename T>
-typename boost::enable_if_c<(sizeof(typename element_type<T>::type) == sizeof(typename string_char_int_type<T>::type))>::type
+typename boost::enable_if_c<(sizeof(typename element_type<T>::type) == sizeof(typename string_char_int_type<T>::type))
+                         && !use_blob_for_string<T>::value>::type
 inline ReadStringData(Buffer& input, T& value, uint32_t length)
 {
-    resize_string(value, length);
+    resize_string_for_overwrite(value, length);
     input.Read(string_data(value), length * sizeof(typename element_type<T>::type));
 }
 
+template <typename Buffer, typename T>
+typename boost::enable_if<use_blob_for_string<T> >::type
+inline ReadStringData(Buffer& input, T& value, uint32_t length)
+{
+    blob data;
+    input.Read(data, length);
+    value = T(data);
+}
+
+template <typename T>
+typename boost::disable_if<use_blob_for_string<T> >::type
+inline AssignStringData(T& value, const blob& data)
+{
+    resize_string_for_overwrite(value, data.length());
+    std::memcpy(string_data(value), data.content(), data.length());
+}
+
+template <typename T>
+typename boost::enable_if<use_blob_for_string<T> >::type
+inline AssignStringData(T& value, const blob& data)
+{
+    value = T(data);
+}
+
 template <typename Buffer, typename T>
 typename boost::enable_if_c<(sizeof(typename element_type<T>::type) > sizeof(typename string_char_int_type<T>::type))>::type
 inline ReadStringData(Buffer& input, T& value, uint32_t length)
 {
-    resize_string(value, length);
+    resize_string_for_overwrite(value, length);
     typename element_type<T>::type* data = string_data(value);
-    typename element_type<T>::type* const data_end = data + length;
-    typename string_char_int_type<T>::type ch;
-    for (; data != data_end; ++data)
+    typename string_char_int_type<T>::type units[wide_chars_block];
+
+    // Read the code units in blocks and widen them, rather than reading one
+    // code unit at a time.
+    while (length)
     {
-        input.Read(ch);
-        *data = static_cast<typename element_type<T>::type>(ch);
+        const uint32_t count = length < wide_chars_block ? length : wide_chars_block;
+
+        input.Read(units, count * sizeof(units[0]));
+        WidenChars(units, data, count);
+
+        data += count;
+        length -= count;
     }
 }
 
@@ -218,12 +253,17 @@ typename boost::enable_if_c<(sizeof(typename element_type<T>::type) > sizeof(typ
 inline WriteStringData(Buffer& output, const T& value, uint32_t length)
 {
     const typename element_type<T>::type* data = string_data(value);
-    const typename element_type<T>::type* const data_end = data + length;
-    typename string_char_int_type<T>::type ch;
-    for (; data != data_end; ++data)
+    typename string_char_int_type<T>::type units[wide_chars_block];
+
+    while (length)
     {
-        ch = static_cast<typename string_char_int_type<T>::type>(*data);
-        output.Write(ch);
+        const uint32_t count = length < wide_chars_block ? length : wide_chars_block;
+
+        NarrowChars(data, units, count);
+        output.Write(units, count * sizeof(units[0]));
+
+        data += count;
+        length -= count;
     }
 }
 
@@ -5,18 +5,31 @@
 
 #include <bond/core/config.h>
 
+#include "detail/simple_array.h"
 #include "encoding.h"
 
 #include <bond/core/bond_version.h>
 #include <bond/core/detail/checked.h>
+#include <bond/core/detail/mpl.h>
+#include <bond/core/exception.h>
+#include <bond/core/traits.h>
 
 #include <boost/call_traits.hpp>
 #include <boost/noncopyable.hpp>
 
+#include <cstring>
+
 /*
                      .----------.--------------.   .----------.---------.
    struct hierarchy  |  struct  | BT_STOP_BASE |...|  struct  | BT_STOP |
-                     '----------'--------------'   '----------'---------'
+   (v1)              '----------'--------------'   '----------'---------'
+
+                     .----------.----------.--------------.   .----------.---------.
+   struct hierarchy  |  length  |  struct  | BT_STOP_BASE |...|  struct  | BT_STOP |
+   (v2)              '----------'----------'--------------'   '----------'---------'
+
+   length            little endian uint32 length of following structs, up to and
+                     including BT_STOP but excluding length itself
 
                      .----------.----------.   .----------.
    struct            |  field   |  field   |...|  field   |
@@ -111,12 +124,18 @@ public:
     typedef FastBinaryWriter<Buffer>           Writer;
 
     BOND_STATIC_CONSTEXPR uint16_t magic = FAST_PROTOCOL;
-    BOND_STATIC_CONSTEXPR uint16_t version = v1;
+    BOND_STATIC_CONSTEXPR uint16_t version = v2;
 
     /// @brief Construct from input buffer/stream containing serialized data.
-    FastBinaryReader(typename boost::call_traits<Buffer>::param_type buffer)
-       : _input(buffer)
-    {}
+    FastBinaryReader(typename boost::call_traits<Buffer>::param_type buffer,
+                     uint16_t version_value = default_version<FastBinaryReader>::value)
+       : _input(buffer),
+         _version(version_value)
+    {
+        BOOST_ASSERT(protocol_has_multiple_versions<FastBinaryReader>::value
+            ? _version <= FastBinaryReader::version
+            : _version == default_version<FastBinaryReader>::value);
+    }
 
 
     // This identical to compiler generated ctor except for noexcept declaration.
@@ -124,7 +143,8 @@ public:
     // to use optimized code path.
     /// @brief Copy constructor
     FastBinaryReader(const FastBinaryReader& that) BOND_NOEXCEPT
-        : _input(that._input)
+        : _input(that._input),
+          _version(that._version)
     {}
 
 
@@ -153,13 +173,15 @@ public:
 
     bool ReadVersion()
     {
-        uint16_t magic_value, version_value;
+        uint16_t magic_value;
 
         _input.Read(magic_value);
-        _input.Read(version_value);
+        _input.Read(_version);
 
         return magic_value == FastBinaryReader::magic
-            && version_value <= FastBinaryReader::version;
+            && (protocol_has_multiple_versions<FastBinaryReader>::value
+                ? _version <= FastBinaryReader::version
+                : _version == default_version<FastBinaryReader>::value);
     }
 
 
@@ -190,11 +212,17 @@ public:
         _input.Read(value, size);
     }
 
-    void ReadStructBegin()
-    {}
+    void ReadStructBegin(bool base = false)
+    {
+        if (!base && v2 <= _version)
+        {
+            uint32_t length;
+            Read(length);
+        }
+    }
 
 
-    void ReadStructEnd()
+    void ReadStructEnd(bool = false)
     {}
 
 
@@ -329,10 +357,10 @@ protected:
         _input.Skip(detail::checked_multiply(size, sizeof(uint16_t)));
     }
 
-    template <BT T>
-    typename boost::enable_if_c<(T == BT_STRUCT)>::type
-    SkipType()
+    void SkipStructV1()
     {
+        BOOST_ASSERT(v1 == _version);
+
         for (;;)
         {
             ReadStructBegin();
@@ -354,6 +382,29 @@ protected:
         }
     }
 
+    void SkipStructV2()
+    {
+        BOOST_ASSERT(v2 <= _version);
+
+        uint32_t length;
+        Read(length);
+        _input.Skip(length);
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_STRUCT)>::type
+    SkipType()
+    {
+        if (v2 <= _version)
+        {
+            SkipStructV2();
+        }
+        else
+        {
+            SkipStructV1();
+        }
+    }
+
     template <BT T>
     typename boost::enable_if_c<(T == BT_SET || T == BT_LIST)>::type
     SkipType()
@@ -454,6 +505,12 @@ protected:
     }
 
     Buffer _input;
+    uint16_t _version;
+
+    template <typename Input, typename Output>
+    friend
+    bool is_protocol_version_same(const FastBinaryReader<Input>&,
+                                  const FastBinaryWriter<Output>&);
 };
 
 template <typename Buffer>
@@ -463,6 +520,27 @@ template <typename Buffer>
 BOND_CONSTEXPR_OR_CONST uint16_t FastBinaryReader<Buffer>::version;
 
 
+namespace detail
+{
+
+// Output buffers which can reserve space for a value written later
+template <typename Buffer, typename Enable = void> struct
+implements_reserve
+    : std::false_type {};
+
+
+template <typename Buffer> struct
+implements_reserve<Buffer,
+#ifdef BOND_NO_SFINAE_EXPR
+    typename boost::enable_if<check_method<char* (Buffer::*)(uint32_t), &Buffer::Reserve> >::type>
+#else
+    detail::mpl::void_t<decltype(std::declval<Buffer>().Reserve(std::declval<uint32_t>()))>>
+#endif
+    : std::true_type {};
+
+} // namespace detail
+
+
 /// @brief Writer for Fast Binary protocol
 template <typename BufferT>
 class FastBinaryWriter
@@ -473,9 +551,24 @@ public:
     typedef FastBinaryReader<Buffer>   Reader;
 
     /// @brief Construct from output buffer/stream.
-    FastBinaryWriter(Buffer& buffer)
-        : _output(buffer)
-    {
+    ///
+    /// Version 2 writes the length of structs in a single pass, by reserving
+    /// space for the length and writing it once the struct is written, which
+    /// requires an output buffer with Reserve and GetCount methods such as
+    /// bond::OutputBuffer.
+    FastBinaryWriter(Buffer& buffer,
+                     uint16_t version = default_version<Reader>::value)
+        : _output(buffer),
+          _version(version)
+    {
+        BOOST_ASSERT(protocol_has_multiple_versions<Reader>::value
+            ? _version <= Reader::version
+            : _version == default_version<Reader>::value);
+
+        if (v2 <= _version && !detail::implements_reserve<Buffer>::value)
+        {
+            OutputReserveException();
+        }
     }
 
     /// @brief Access to underlying buffer
@@ -488,18 +581,28 @@ public:
     void WriteVersion()
     {
         _output.Write(Reader::magic);
-        _output.Write(Reader::version);
+        _output.Write(_version);
     }
 
     //
     // Write methods
     //
-    void WriteStructBegin(const Metadata& /*metadata*/, bool /*base*/)
-    {}
+    void WriteStructBegin(const Metadata& /*metadata*/, bool base)
+    {
+        if (!base && v2 <= _version)
+        {
+            LengthBegin(_output);
+        }
+    }
 
     void WriteStructEnd(bool base = false)
     {
         WriteType(base ? BT_STOP_BASE : BT_STOP);
+
+        if (!base && v2 <= _version)
+        {
+            LengthEnd(_output);
+        }
     }
 
     template <typename T>
@@ -572,8 +675,59 @@ protected:
         _output.Write(static_cast<uint8_t>(type));
     }
 
+    template <typename T>
+    typename boost::enable_if<detail::implements_reserve<T> >::type
+    LengthBegin(T& output)
+    {
+        _slots.push(output.Reserve(sizeof(uint32_t)));
+        _starts.push(output.GetCount());
+    }
+
+    template <typename T>
+    typename boost::enable_if<detail::implements_reserve<T> >::type
+    LengthEnd(T& output)
+    {
+        const uint32_t length = output.GetCount() - _starts.pop();
+
+        std::memcpy(_slots.pop(), &length, sizeof(length));
+    }
+
+    template <typename T>
+    typename boost::disable_if<detail::implements_reserve<T> >::type
+    LengthBegin(T&)
+    {
+        BOOST_ASSERT(false);
+    }
+
+    template <typename T>
+    typename boost::disable_if<detail::implements_reserve<T> >::type
+    LengthEnd(T&)
+    {
+        BOOST_ASSERT(false);
+    }
+
     Buffer& _output;
+    uint16_t _version;
+    detail::SimpleArray<char*> _slots;
+    detail::SimpleArray<uint32_t> _starts;
+
+    template <typename Input, typename Output>
+    friend
+    bool is_protocol_version_same(const FastBinaryReader<Input>&,
+                                  const FastBinaryWriter<Output>&);
 };
 
+template <typename Input> struct
+protocol_has_multiple_versions<FastBinaryReader<Input> >
+    : enable_protocol_versions<FastBinaryReader<Input> > {};
+
+template <typename Input, typename Output>
+inline
+bool is_protocol_version_same(const FastBinaryReader<Input>& reader,
+                              const FastBinaryWriter<Output>& writer)
+{
+    return reader._version == writer._version;
+}
+
 
 } // namespace bond
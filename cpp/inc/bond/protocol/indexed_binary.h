@@ -0,0 +1,817 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "detail/simple_array.h"
+#include "encoding.h"
+
+#include <bond/core/bond_version.h>
+#include <bond/core/detail/checked.h>
+#include <bond/core/exception.h>
+#include <bond/stream/output_counter.h>
+
+#include <boost/call_traits.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+
+/*
+                     .--------.-------.-------.-------------------------.   .----------.---------.
+   struct hierarchy  | length | count | index |  struct  | BT_STOP_BASE |...|  struct  | BT_STOP |
+                     '--------'-------'-------'-------------------------'   '----------'---------'
+
+                                      .--------.
+                     length           | uint32 | little endian count of bytes following the length
+                                      '--------'
+
+                                      .--------.
+                     count            | uint32 | little endian count of index entries
+                                      '--------'
+
+                                      .-------.-------.   .-------.
+                     index            | entry | entry |...| entry |
+                                      '-------'-------'   '-------'
+
+                                      .--------.--------.--------.
+                           entry      |   id   | level  | offset |
+                                      '--------'--------'--------'
+
+                           id         uint16 id of the field
+
+                           level      uint16 level of the struct in the hierarchy the field
+                                      belongs to, 0 for the top-most base struct
+
+                           offset     uint32 offset of the field relative to the first byte
+                                      following the index
+
+                                      entries are sorted by level and id
+
+                     .----------.----------.   .----------.
+   struct            |  field   |  field   |...|  field   |
+                     '----------'----------'   '----------'
+
+                     .------.----.----------.
+   field             | type | id |  value   |
+                     '------'----'----------'
+
+                     .---.---.---.---.---.---.---.---.                           i - id bits
+   type              | 0 | 0 | 0 | t | t | t | t | t |                           t - type bits
+                     '---'---'---'---'---'---'---'---'                           v - value bits
+                                   4               0
+
+   id                .---.   .---.---.   .---.
+                     | i |...| i | i |...| i |
+                     '---'   '---'---'   '---'
+                       7       0   15      8
+
+   value             encoded the same way as in Fast Binary protocol
+*/
+
+namespace bond
+{
+
+template <typename BufferT>
+class IndexedBinaryWriter;
+
+namespace detail
+{
+    // Size of an entry in the index of a struct
+    const uint32_t indexed_binary_entry_size = 8;
+
+} // namespace detail
+
+
+/// @brief Reader for Indexed Binary protocol
+///
+/// Indexed Binary protocol encodes values the same way as Fast Binary
+/// protocol. In addition every struct starts with an index of offsets of its
+/// fields, which allows reading individual fields without parsing the ones
+/// preceding them (see bond::GetField) and skipping structs in constant time.
+template <typename BufferT>
+class IndexedBinaryReader
+{
+public:
+    typedef BufferT                             Buffer;
+    typedef DynamicParser<IndexedBinaryReader&> Parser;
+    typedef IndexedBinaryWriter<Buffer>         Writer;
+
+    BOND_STATIC_CONSTEXPR uint16_t magic = INDEXED_PROTOCOL;
+    BOND_STATIC_CONSTEXPR uint16_t version = v1;
+
+    /// @brief Construct from input buffer/stream containing serialized data.
+    IndexedBinaryReader(typename boost::call_traits<Buffer>::param_type buffer)
+       : _input(buffer)
+    {}
+
+
+    // This identical to compiler generated ctor except for noexcept declaration.
+    // Copy ctor that is explicitly declared throw() is needed for boost::variant
+    // to use optimized code path.
+    /// @brief Copy constructor
+    IndexedBinaryReader(const IndexedBinaryReader& that) BOND_NOEXCEPT
+        : _input(that._input)
+    {}
+
+
+    /// @brief Comparison operator
+    bool operator==(const IndexedBinaryReader& rhs) const
+    {
+        return _input == rhs._input;
+    }
+
+
+    /// @brief Access to underlying buffer
+    typename boost::call_traits<Buffer>::const_reference
+    GetBuffer() const
+    {
+        return _input;
+    }
+
+
+    /// @brief Access to underlying buffer
+    typename boost::call_traits<Buffer>::reference
+    GetBuffer()
+    {
+        return _input;
+    }
+
+
+    bool ReadVersion()
+    {
+        uint16_t magic_value, version_value;
+
+        _input.Read(magic_value);
+        _input.Read(version_value);
+
+        return magic_value == IndexedBinaryReader::magic
+            && version_value <= IndexedBinaryReader::version;
+    }
+
+
+    // Read for primitive types
+    template <typename T>
+    typename boost::disable_if<is_string_type<T> >::type
+    Read(T& value)
+    {
+        _input.Read(value);
+    }
+
+
+    // Read for strings
+    template <typename T>
+    typename boost::enable_if<is_string_type<T> >::type
+    Read(T& value)
+    {
+        uint32_t length = 0;
+
+        ReadVariableUnsigned(_input, length);
+        detail::ReadStringData(_input, value, length);
+    }
+
+
+    // Read for blob
+    void Read(blob& value, uint32_t size)
+    {
+        _input.Read(value, size);
+    }
+
+
+    void ReadStructBegin(bool base = false)
+    {
+        if (!base)
+        {
+            uint32_t length, count;
+
+            Read(length);
+            Read(count);
+
+            if (length < sizeof(count) || (length - sizeof(count)) / detail::indexed_binary_entry_size < count)
+            {
+                MalformedStructIndexException(length, count);
+            }
+
+            _input.Skip(count * detail::indexed_binary_entry_size);
+        }
+    }
+
+
+    void ReadStructEnd(bool = false)
+    {}
+
+
+    void ReadFieldBegin(BondDataType& type, uint16_t& id)
+    {
+        ReadType(type);
+
+        if (type != BT_STOP && type != BT_STOP_BASE)
+            Read(id);
+        else
+            id = 0;
+    }
+
+
+    void ReadFieldEnd()
+    {}
+
+
+    void ReadContainerBegin(uint32_t& size, BondDataType& type)
+    {
+        ReadType(type);
+        ReadVariableUnsigned(_input, size);
+    }
+
+
+    // container of 2-tuple (e.g. map)
+    void ReadContainerBegin(uint32_t& size, std::pair<BondDataType, BondDataType>& type)
+    {
+        ReadType(type.first);
+        ReadType(type.second);
+        ReadVariableUnsigned(_input, size);
+    }
+
+
+    void ReadContainerEnd()
+    {}
+
+
+    /// @brief Position the reader at the value of a field of the struct
+    /// starting at the current position
+    ///
+    /// Returns false if the struct doesn't contain the field. Otherwise sets
+    /// `type` to the type of the field and returns true.
+    bool FindField(uint16_t level, uint16_t id, BondDataType& type)
+    {
+        uint32_t length, count;
+
+        Read(length);
+        Read(count);
+
+        const uint32_t size = detail::checked_multiply(count, detail::indexed_binary_entry_size);
+
+        if (length < sizeof(count) || length - sizeof(count) < size)
+        {
+            MalformedStructIndexException(length, count);
+        }
+
+        blob index;
+        _input.Read(index, size);
+
+        const uint32_t key = (static_cast<uint32_t>(level) << 16) | id;
+        const uint8_t* entries = reinterpret_cast<const uint8_t*>(index.content());
+
+        // Binary search of the sorted index
+        for (uint32_t low = 0, high = count; low < high;)
+        {
+            const uint32_t middle = low + (high - low) / 2;
+            const uint8_t* entry = entries + middle * detail::indexed_binary_entry_size;
+            const uint32_t entry_key = (static_cast<uint32_t>(ReadUInt16(entry + 2)) << 16) | ReadUInt16(entry);
+
+            if (entry_key < key)
+            {
+                low = middle + 1;
+            }
+            else if (key < entry_key)
+            {
+                high = middle;
+            }
+            else
+            {
+                const uint32_t offset = ReadUInt16(entry + 4) | (static_cast<uint32_t>(ReadUInt16(entry + 6)) << 16);
+                uint16_t field_id;
+
+                if (offset >= length - sizeof(count) - size)
+                {
+                    MalformedStructIndexException(length, count);
+                }
+
+                _input.Skip(offset);
+                ReadFieldBegin(type, field_id);
+
+                if (field_id != id || type == BT_STOP || type == BT_STOP_BASE)
+                {
+                    MalformedStructIndexException(length, count);
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    template <typename T>
+    void Skip()
+    {
+        SkipType<get_type_id<T>::value>();
+    }
+
+
+    template <typename T>
+    void Skip(const bonded<T, IndexedBinaryReader&>&)
+    {
+        SkipType<BT_STRUCT>();
+    }
+
+    void Skip(BondDataType type)
+    {
+        SkipType(type);
+    }
+
+protected:
+    void ReadType(BondDataType& type)
+    {
+        uint8_t byte;
+
+        Read(byte);
+        type = static_cast<BondDataType>(byte);
+    }
+
+    static uint16_t ReadUInt16(const uint8_t* p)
+    {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+    // Using BondDataType directly in non-trivial boolean template checks fails on VC12.
+    using BT = std::underlying_type<BondDataType>::type;
+#else
+    using BT = BondDataType;
+#endif
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_BOOL || T == BT_UINT8 || T == BT_INT8)>::type
+    SkipType(uint32_t size = 1)
+    {
+        _input.Skip(detail::checked_multiply(size, sizeof(uint8_t)));
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_UINT16 || T == BT_INT16)>::type
+    SkipType(uint32_t size = 1)
+    {
+        _input.Skip(detail::checked_multiply(size, sizeof(uint16_t)));
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_UINT32 || T == BT_INT32)>::type
+    SkipType(uint32_t size = 1)
+    {
+        _input.Skip(detail::checked_multiply(size, sizeof(uint32_t)));
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_UINT64 || T == BT_INT64)>::type
+    SkipType(uint32_t size = 1)
+    {
+        _input.Skip(detail::checked_multiply(size, sizeof(uint64_t)));
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_FLOAT)>::type
+    SkipType(uint32_t size = 1)
+    {
+        _input.Skip(detail::checked_multiply(size, sizeof(float)));
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_DOUBLE)>::type
+    SkipType(uint32_t size = 1)
+    {
+        _input.Skip(detail::checked_multiply(size, sizeof(double)));
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_STRING)>::type
+    SkipType()
+    {
+        uint32_t size = 0;
+
+        ReadVariableUnsigned(_input, size);
+        _input.Skip(size);
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_WSTRING)>::type
+    SkipType()
+    {
+        uint32_t size = 0;
+
+        ReadVariableUnsigned(_input, size);
+        _input.Skip(detail::checked_multiply(size, sizeof(uint16_t)));
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_STRUCT)>::type
+    SkipType()
+    {
+        uint32_t length;
+
+        Read(length);
+        _input.Skip(length);
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_SET || T == BT_LIST)>::type
+    SkipType()
+    {
+        BondDataType element_type;
+        uint32_t size;
+
+        ReadContainerBegin(size, element_type);
+        SkipType(element_type, size);
+        ReadContainerEnd();
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_MAP)>::type
+    SkipType()
+    {
+        std::pair<BondDataType, BondDataType> element_type;
+        uint32_t size;
+
+        ReadContainerBegin(size, element_type);
+        for (int64_t i = 0; i < size; ++i)
+        {
+            SkipType(element_type.first);
+            SkipType(element_type.second);
+        }
+        ReadContainerEnd();
+    }
+
+    template <BT T>
+    typename boost::enable_if_c<(T == BT_STRING || T == BT_WSTRING || T == BT_STRUCT
+                                || T == BT_SET || T == BT_LIST || T == BT_MAP)>::type
+    SkipType(uint32_t size)
+    {
+        for (int64_t i = 0; i < size; ++i)
+        {
+            SkipType<T>();
+        }
+    }
+
+    template <typename... Args>
+    void SkipType(BondDataType type, Args&&... args)
+    {
+        switch (type)
+        {
+            case BT_BOOL:
+            case BT_UINT8:
+            case BT_INT8:
+                SkipType<BT_BOOL>(std::forward<Args>(args)...);
+                break;
+
+            case BT_UINT16:
+            case BT_INT16:
+                SkipType<BT_UINT16>(std::forward<Args>(args)...);
+                break;
+
+            case BT_UINT32:
+            case BT_INT32:
+                SkipType<BT_UINT32>(std::forward<Args>(args)...);
+                break;
+
+            case BT_UINT64:
+            case BT_INT64:
+                SkipType<BT_UINT64>(std::forward<Args>(args)...);
+                break;
+
+            case BT_FLOAT:
+                SkipType<BT_FLOAT>(std::forward<Args>(args)...);
+                break;
+
+            case BT_DOUBLE:
+                SkipType<BT_DOUBLE>(std::forward<Args>(args)...);
+                break;
+
+            case BT_STRING:
+                SkipType<BT_STRING>(std::forward<Args>(args)...);
+                break;
+
+            case BT_WSTRING:
+                SkipType<BT_WSTRING>(std::forward<Args>(args)...);
+                break;
+
+            case BT_SET:
+            case BT_LIST:
+                SkipType<BT_SET>(std::forward<Args>(args)...);
+                break;
+
+            case BT_MAP:
+                SkipType<BT_MAP>(std::forward<Args>(args)...);
+                break;
+
+            case BT_STRUCT:
+                SkipType<BT_STRUCT>(std::forward<Args>(args)...);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    Buffer _input;
+};
+
+template <typename Buffer>
+BOND_CONSTEXPR_OR_CONST uint16_t IndexedBinaryReader<Buffer>::magic;
+
+template <typename Buffer>
+BOND_CONSTEXPR_OR_CONST uint16_t IndexedBinaryReader<Buffer>::version;
+
+
+class IndexedBinaryCounter
+{
+    template <typename Buffer>
+    friend class IndexedBinaryWriter;
+
+private:
+    struct type : OutputCounter // Must be a new type and not an alias.
+    {};
+};
+
+
+/// @brief Writer for Indexed Binary protocol
+///
+/// The writer always serializes in two passes: the first pass computes the
+/// lengths and the indexes of structs, which the second pass writes before
+/// the fields.
+template <typename BufferT>
+class IndexedBinaryWriter
+    : boost::noncopyable
+{
+    struct Pass1
+    {
+        Pass1(IndexedBinaryWriter* writer)
+            : writer(writer)
+        {}
+
+        ~Pass1()
+        {
+            writer->_it = NULL;
+            writer->_index = NULL;
+        }
+
+        IndexedBinaryWriter* writer;
+    };
+
+    using Counter = IndexedBinaryCounter::type;
+
+public:
+    typedef BufferT                         Buffer;
+    typedef IndexedBinaryReader<Buffer>     Reader;
+    typedef IndexedBinaryWriter<Counter>    Pass0;
+
+    /// @brief Construct from output buffer/stream.
+    IndexedBinaryWriter(Buffer& output)
+        : _output(output),
+          _it(NULL),
+          _index(NULL)
+    {}
+
+    template<typename T>
+    IndexedBinaryWriter(Counter& output,
+                        const IndexedBinaryWriter<T>& /*pass1*/)
+        : _output(output),
+          _it(NULL),
+          _index(NULL)
+    {}
+
+
+    /// @brief Access to underlying buffer
+    typename boost::call_traits<Buffer>::reference
+    GetBuffer()
+    {
+        return _output;
+    }
+
+
+    bool NeedPass0()
+    {
+        return !_it;
+    }
+
+
+    Pass1 WithPass0(Pass0& pass0)
+    {
+        _it = pass0._structs.begin();
+        _index = pass0._entries.begin();
+        return this;
+    }
+
+    void WriteVersion()
+    {
+        _output.Write(Reader::magic);
+        _output.Write(Reader::version);
+    }
+
+    //
+    // Write methods
+    //
+    void WriteStructBegin(const Metadata& /*metadata*/, bool base)
+    {
+        if (!base)
+        {
+            IndexBegin(_output);
+        }
+    }
+
+    void WriteStructEnd(bool base = false)
+    {
+        if (base)
+        {
+            WriteType(BT_STOP_BASE);
+            BaseEnd(_output);
+        }
+        else
+        {
+            WriteType(BT_STOP);
+            IndexEnd(_output);
+        }
+    }
+
+    template <typename T>
+    void WriteField(uint16_t id, const bond::Metadata& /*metadata*/, const T& value)
+    {
+        WriteFieldBegin(get_type_id<T>::value, id);
+        Write(value);
+        WriteFieldEnd();
+    }
+
+    void WriteFieldBegin(BondDataType type, uint16_t id, const bond::Metadata& /*metadata*/)
+    {
+        WriteFieldBegin(type, id);
+    }
+
+    void WriteFieldBegin(BondDataType type, uint16_t id)
+    {
+        IndexField(_output, id);
+        WriteType(type);
+        Write(id);
+    }
+
+    void WriteFieldEnd()
+    {}
+
+    void WriteContainerBegin(uint32_t size, BondDataType type)
+    {
+        WriteType(type);
+        WriteVariableUnsigned(_output, size);
+    }
+
+    // container of 2-tuples (e.g. map)
+    void WriteContainerBegin(uint32_t size, std::pair<BondDataType, BondDataType> type)
+    {
+        WriteType(type.first);
+        WriteType(type.second);
+        WriteVariableUnsigned(_output, size);
+    }
+
+    void WriteContainerEnd()
+    {}
+
+    // Write for primitive types
+    template<typename T>
+    typename boost::disable_if<is_string_type<T> >::type
+    Write(const T& value)
+    {
+        _output.Write(value);
+    }
+
+    // Write for strings
+    template <typename T>
+    typename boost::enable_if<is_string_type<T> >::type
+    Write(const T& value)
+    {
+        uint32_t length = string_length(value);
+
+        WriteVariableUnsigned(_output, length);
+        detail::WriteStringData(_output, value, length);
+    }
+
+    // Write for blob
+    void Write(const blob& value)
+    {
+        _output.Write(value);
+    }
+
+protected:
+    template <typename Buffer>
+    friend class IndexedBinaryWriter;
+
+    void WriteType(BondDataType type)
+    {
+        _output.Write(static_cast<uint8_t>(type));
+    }
+
+    // Pass 0 records for every struct, in the order in which the structs
+    // begin, its length, the position of its index in _entries and the
+    // count of index entries. Each entry is packed into uint64_t so that
+    // sorting the entries orders them by level, id.
+    void IndexBegin(Counter& counter)
+    {
+        _stack.push(_structs.size());
+        _stack.push(_fields.size());
+        _stack.push(0); // level
+
+        _structs.push(0);
+        _structs.push(0);
+        _structs.push(0);
+
+        counter.Write(uint32_t()); // length
+        counter.Write(uint32_t()); // count
+
+        _stack.push(counter.GetCount());
+    }
+
+    void BaseEnd(Counter& /*counter*/)
+    {
+        ++_stack[_stack.size() - 2];
+    }
+
+    void IndexField(Counter& counter, uint16_t id)
+    {
+        const uint32_t top = _stack.size();
+
+        _fields.push((static_cast<uint64_t>(_stack[top - 2]) << 48)
+                   | (static_cast<uint64_t>(id) << 32)
+                   | (counter.GetCount() - _stack[top - 1]));
+    }
+
+    void IndexEnd(Counter& counter)
+    {
+        const uint32_t start = _stack.pop();
+        _stack.pop();
+        const uint32_t first = _stack.pop();
+        const uint32_t index = _stack.pop();
+
+        const uint32_t count = _fields.size() - first;
+        uint64_t* fields = &_fields[first];
+
+        std::sort(fields, fields + count);
+
+        _structs[index] = static_cast<uint32_t>(sizeof(uint32_t)
+            + count * detail::indexed_binary_entry_size
+            + (counter.GetCount() - start));
+        _structs[index + 1] = _entries.size();
+        _structs[index + 2] = count;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _entries.push(fields[i]);
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _fields.pop();
+        }
+
+        counter.Write(fields, count * detail::indexed_binary_entry_size);
+    }
+
+    template<typename T>
+    void IndexBegin(T&)
+    {
+        BOOST_ASSERT(_it);
+
+        const uint32_t length = *_it++;
+        const uint64_t* entry = _index + *_it++;
+        const uint32_t count = *_it++;
+
+        Write(length);
+        Write(count);
+
+        for (const uint64_t* end = entry + count; entry != end; ++entry)
+        {
+            Write(static_cast<uint16_t>(*entry >> 32)); // id
+            Write(static_cast<uint16_t>(*entry >> 48)); // level
+            Write(static_cast<uint32_t>(*entry));       // offset
+        }
+    }
+
+    template<typename T>
+    void BaseEnd(T&)
+    {}
+
+    template<typename T>
+    void IndexField(T&, uint16_t /*id*/)
+    {}
+
+    template<typename T>
+    void IndexEnd(T&)
+    {}
+
+protected:
+    Buffer&                         _output;
+    const uint32_t*                 _it;
+    const uint64_t*                 _index;
+    detail::SimpleArray<uint32_t>   _stack;
+    detail::SimpleArray<uint32_t>   _structs;
+    detail::SimpleArray<uint64_t>   _fields;
+    detail::SimpleArray<uint64_t>   _entries;
+};
+
+} // namespace bond
@@ -0,0 +1,556 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file */
+#pragma once
+
+#include <bond/core/config.h>
+
+#include "indexed_binary.h"
+
+#include <bond/core/blob.h>
+#include <bond/core/bond.h>
+#include <bond/core/string_ref.h>
+#include <bond/stream/input_buffer.h>
+
+#include <iterator>
+#include <utility>
+
+namespace bond
+{
+
+class struct_view;
+
+namespace detail
+{
+
+typedef IndexedBinaryReader<InputBuffer> ViewReader;
+
+
+template <typename T, typename Enable = void> struct
+view_traits;
+
+
+// Metadata passed to the transform reading basic values, which doesn't use it
+inline const Metadata& view_metadata()
+{
+    static const Metadata metadata;
+    return metadata;
+}
+
+
+// Basic types are read with the same type promotions as during deserialization
+template <typename T> struct
+view_traits<T, typename boost::enable_if_c<std::is_arithmetic<T>::value
+                                        || std::is_enum<T>::value
+                                        || is_string_type<T>::value>::type>
+{
+    static bool Matches(BondDataType type)
+    {
+        return type >= BT_BOOL && type <= BT_WSTRING
+            && type != BT_STRUCT && type != BT_LIST && type != BT_SET && type != BT_MAP
+            && IsMatching<T>(type);
+    }
+
+    static void Read(ViewReader& input, BondDataType type, T& var)
+    {
+        BasicTypeField(0, view_metadata(), type, FieldValueReader<T>(var), input);
+    }
+};
+
+
+// Blob references the serialized list<int8> in the input
+template <> struct
+view_traits<blob>
+{
+    static bool Matches(BondDataType type)
+    {
+        return type == BT_LIST;
+    }
+
+    static void Read(ViewReader& input, BondDataType type, blob& var)
+    {
+        ViewReader list(input);
+        input.Skip(type);
+
+        uint32_t size;
+        BondDataType element_type;
+        list.ReadContainerBegin(size, element_type);
+
+        if (element_type == BT_INT8 || element_type == BT_UINT8)
+        {
+            list.Read(var, size);
+        }
+    }
+};
+
+
+// Struct views reference the serialized struct, including its index
+template <typename T> struct
+view_traits<T, typename boost::enable_if<std::is_base_of<struct_view, T> >::type>
+{
+    static bool Matches(BondDataType type)
+    {
+        return type == BT_STRUCT;
+    }
+
+    static void Read(ViewReader& input, BondDataType /*type*/, T& var)
+    {
+        InputBuffer start(input.GetBuffer());
+        uint32_t length;
+        blob data;
+
+        input.Read(length);
+        input.Read(data, length);
+
+        start.Read(data, length + sizeof(length));
+        var = T(data);
+    }
+};
+
+} // namespace detail
+
+
+/// @brief Read-only view of a struct serialized using Indexed Binary protocol
+///
+/// The view references the serialized data and reads fields on demand using
+/// the index of the struct, without deserializing the struct. Generated
+/// `FooView` classes, see the `--views` option of gbc, derive from
+/// struct_view and have an accessor for each field of struct `Foo`.
+///
+/// A view constructed from an empty blob, e.g. for a struct field which is
+/// missing from the payload, returns the default values of all fields.
+class struct_view
+{
+public:
+    /// @brief Default constructor
+    struct_view()
+    {}
+
+    /// @brief Construct from a blob containing a struct serialized using
+    /// IndexedBinaryWriter
+    explicit struct_view(const blob& data)
+        : _data(data)
+    {}
+
+    /// @brief Serialized data of the struct
+    const blob& data() const
+    {
+        return _data;
+    }
+
+    /// @brief Deserialize the whole struct
+    template <typename T>
+    void Deserialize(T& var) const
+    {
+        if (!_data.empty())
+        {
+            bond::Deserialize(detail::ViewReader(_data), var);
+        }
+    }
+
+protected:
+    /// @brief Read a field of the struct or one of its bases
+    ///
+    /// Returns `var` unchanged if the field is missing from the payload or
+    /// has a different type.
+    template <typename Field, typename X>
+    X get(X var) const
+    {
+        if (!_data.empty())
+        {
+            detail::ViewReader input(_data);
+            ReadField<Field>(input, var);
+        }
+
+        return var;
+    }
+
+private:
+    template <typename Field, typename X>
+    static typename boost::enable_if<is_basic_type<typename Field::field_type> >::type
+    ReadField(detail::ViewReader& input, X& var)
+    {
+        detail::GetField<Field, typename Field::struct_type, BuiltInProtocols>(input, var);
+    }
+
+    template <typename Field, typename X>
+    static typename boost::disable_if<is_basic_type<typename Field::field_type> >::type
+    ReadField(detail::ViewReader& input, X& var)
+    {
+        const uint16_t level = detail::hierarchy_depth<typename schema<typename Field::struct_type>::type>::value - 1;
+        BondDataType type;
+
+        if (input.FindField(level, Field::id, type)
+            && type == get_type_id<typename Field::field_type>::value)
+        {
+            detail::view_traits<X>::Read(input, type, var);
+        }
+    }
+
+    blob _data;
+};
+
+
+/// @brief Read-only view of a serialized list, vector or set
+///
+/// Elements are read when the view is iterated. Element types which don't
+/// match T are treated as an empty list.
+template <typename T>
+class list_view
+{
+public:
+    typedef T value_type;
+
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef T                           value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef const T*                    pointer;
+        typedef const T&                    reference;
+
+        const_iterator()
+            : _input(InputBuffer()),
+              _type(BT_STOP),
+              _size(0),
+              _value()
+        {}
+
+        const_iterator(const detail::ViewReader& input, BondDataType type, uint32_t size)
+            : _input(input),
+              _type(type),
+              _size(size),
+              _value()
+        {
+            if (_size)
+                detail::view_traits<T>::Read(_input, _type, _value);
+        }
+
+        reference operator*() const
+        {
+            return _value;
+        }
+
+        pointer operator->() const
+        {
+            return &_value;
+        }
+
+        const_iterator& operator++()
+        {
+            if (--_size)
+            {
+                _value = T();
+                detail::view_traits<T>::Read(_input, _type, _value);
+            }
+
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator it(*this);
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return _size == rhs._size;
+        }
+
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        detail::ViewReader _input;
+        BondDataType _type;
+        uint32_t _size;
+        T _value;
+    };
+
+    typedef const_iterator iterator;
+
+    /// @brief Default constructor, creates an empty list
+    list_view()
+        : _input(InputBuffer()),
+          _type(BT_STOP),
+          _size(0)
+    {}
+
+    /// @brief Number of elements
+    uint32_t size() const
+    {
+        return _size;
+    }
+
+    /// @brief Check if the list is empty
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(_input, _type, _size);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+private:
+    friend struct detail::view_traits<list_view>;
+
+    detail::ViewReader _input;
+    BondDataType _type;
+    uint32_t _size;
+};
+
+
+/// @brief Read-only view of a serialized map
+///
+/// Key/value pairs are read when the view is iterated. Key or value types
+/// which don't match K or V are treated as an empty map.
+template <typename K, typename V>
+class map_view
+{
+public:
+    typedef std::pair<K, V> value_type;
+
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef std::pair<K, V>             value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef const value_type*           pointer;
+        typedef const value_type&           reference;
+
+        const_iterator()
+            : _input(InputBuffer()),
+              _type(BT_STOP, BT_STOP),
+              _size(0),
+              _value()
+        {}
+
+        const_iterator(const detail::ViewReader& input, std::pair<BondDataType, BondDataType> type, uint32_t size)
+            : _input(input),
+              _type(type),
+              _size(size),
+              _value()
+        {
+            if (_size)
+                Read();
+        }
+
+        reference operator*() const
+        {
+            return _value;
+        }
+
+        pointer operator->() const
+        {
+            return &_value;
+        }
+
+        const_iterator& operator++()
+        {
+            if (--_size)
+            {
+                _value = value_type();
+                Read();
+            }
+
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator it(*this);
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return _size == rhs._size;
+        }
+
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        void Read()
+        {
+            detail::view_traits<K>::Read(_input, _type.first, _value.first);
+            detail::view_traits<V>::Read(_input, _type.second, _value.second);
+        }
+
+        detail::ViewReader _input;
+        std::pair<BondDataType, BondDataType> _type;
+        uint32_t _size;
+        value_type _value;
+    };
+
+    typedef const_iterator iterator;
+
+    /// @brief Default constructor, creates an empty map
+    map_view()
+        : _input(InputBuffer()),
+          _type(BT_STOP, BT_STOP),
+          _size(0)
+    {}
+
+    /// @brief Number of key/value pairs
+    uint32_t size() const
+    {
+        return _size;
+    }
+
+    /// @brief Check if the map is empty
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(_input, _type, _size);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+private:
+    friend struct detail::view_traits<map_view>;
+
+    detail::ViewReader _input;
+    std::pair<BondDataType, BondDataType> _type;
+    uint32_t _size;
+};
+
+
+/// @brief Read-only view of a serialized nullable value
+template <typename T>
+class nullable_view
+{
+public:
+    typedef T value_type;
+
+    /// @brief Default constructor, creates a null value
+    nullable_view()
+        : _hasvalue(false),
+          _value()
+    {}
+
+    /// @brief Check if the value is not null
+    bool hasvalue() const
+    {
+        return _hasvalue;
+    }
+
+    /// @brief Check if the value is null
+    bool empty() const
+    {
+        return !_hasvalue;
+    }
+
+    /// @brief Return the value, which must not be null
+    const T& value() const
+    {
+        BOOST_ASSERT(_hasvalue);
+        return _value;
+    }
+
+private:
+    friend struct detail::view_traits<nullable_view>;
+
+    bool _hasvalue;
+    T _value;
+};
+
+
+namespace detail
+{
+
+template <typename T> struct
+view_traits<list_view<T> >
+{
+    static bool Matches(BondDataType type)
+    {
+        return type == BT_LIST || type == BT_SET;
+    }
+
+    static void Read(ViewReader& input, BondDataType type, list_view<T>& var)
+    {
+        var._input = input;
+        input.Skip(type);
+
+        var._input.ReadContainerBegin(var._size, var._type);
+
+        if (!view_traits<T>::Matches(var._type))
+        {
+            var._size = 0;
+        }
+    }
+};
+
+
+template <typename K, typename V> struct
+view_traits<map_view<K, V> >
+{
+    static bool Matches(BondDataType type)
+    {
+        return type == BT_MAP;
+    }
+
+    static void Read(ViewReader& input, BondDataType type, map_view<K, V>& var)
+    {
+        var._input = input;
+        input.Skip(type);
+
+        var._input.ReadContainerBegin(var._size, var._type);
+
+        if (!view_traits<K>::Matches(var._type.first) || !view_traits<V>::Matches(var._type.second))
+        {
+            var._size = 0;
+        }
+    }
+};
+
+
+template <typename T> struct
+view_traits<nullable_view<T> >
+{
+    static bool Matches(BondDataType type)
+    {
+        return type == BT_LIST;
+    }
+
+    static void Read(ViewReader& input, BondDataType type, nullable_view<T>& var)
+    {
+        list_view<T> list;
+        view_traits<list_view<T> >::Read(input, type, list);
+
+        var._hasvalue = !list.empty();
+
+        if (var._hasvalue)
+        {
+            var._value = *list.begin();
+        }
+    }
+};
+
+} // namespace detail
+
+} // namespace bond
@@ -163,7 +163,7 @@ public:
         length %= _max_string_length;
         length = length ? length : 1;
 
-        resize_string(value, length);
+        resize_string_for_overwrite(value, length);
 
         typename element_type<T>::type* p = string_data(value);
         typename element_type<T>::type* const p_end = p + length;
@@ -120,6 +120,7 @@ DeserializeContainer(X& var, const T& element, SimpleJsonReader<Buffer>& reader)
                                   GetTypeId(element),
                                   std::is_enum<typename element_type<X>::type>::value);
     clear_set(var);
+    reserve_set(var, reader.ArraySize());
 
     typename element_type<X>::type e(make_element(var));
 
@@ -150,6 +151,7 @@ DeserializeMap(X& var, BondDataType keyType, const T& element, SimpleJsonReader<
         std::is_enum<typename element_type<X>::type::second_type>::value);
 
     clear_map(var);
+    reserve_map(var, reader.ArraySize() / 2);
 
     typename element_type<X>::type::first_type key(make_key(var));
 
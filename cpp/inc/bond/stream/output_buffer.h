@@ -93,6 +93,7 @@ public:
         : _allocator(allocator),
           _buffer(),
           _bufferSize(0),
+          _blobsSize(0),
           _rangeSize(0),
           _rangeOffset(0),
           _minChainningSize(32),
@@ -112,6 +113,7 @@ public:
         : _allocator(allocator),
           _buffer(buffer),
           _bufferSize(size),
+          _blobsSize(0),
           _rangeSize(0),
           _rangeOffset(0),
           _minChainningSize(minChanningSize),
@@ -133,6 +135,7 @@ public:
         : _allocator(allocator),
           _buffer(boost::allocate_shared_noinit<char[]>(_allocator, reserveSize)),
           _bufferSize(reserveSize),
+          _blobsSize(0),
           _rangeSize(0),
           _rangeOffset(0),
           _minChainningSize(minChanningSize),
@@ -244,41 +247,15 @@ public:
             size -= sizePart;
             buffer += sizePart;
 
-            //
-            // snap current range to internal list of blobs, if not empty
-            //
-            if (_rangeSize > 0)
-            {
-                _blobs.emplace_back(_buffer, _rangeOffset, _rangeSize);
-            }
-
-            // cap buffer to prevent overflow
-            if (_bufferSize > ((std::numeric_limits<uint32_t>::max)() >> 1))
-            {
-                throw std::bad_alloc();
-            }
-
-            //
-            // grow buffer by 50% (at least 4096 bytes for initial buffer)
-            // and enough to store left overs of specified buffer
-            //
-            _bufferSize += _bufferSize ? _bufferSize / 2 : 4096;
-            _bufferSize = (std::max)(_bufferSize, size);
-
-            _buffer = boost::allocate_shared_noinit<char[]>(_allocator, _bufferSize);
-
-            //
-            // init range
-            //
-            _rangeOffset = 0;
-            _rangePtr = _buffer.get();
-            _rangeSize = size;
+            NewBuffer(size);
 
             //
             // copy to the tail of current range
             std::memcpy(_rangePtr,
                         buffer,
                         size);
+
+            _rangeSize = size;
         }
     }
 
@@ -299,6 +276,7 @@ public:
         if (_rangeSize > 0)
         {
             _blobs.emplace_back(_buffer, _rangeOffset, _rangeSize);
+            _blobsSize += _rangeSize;
 
             _rangeOffset += _rangeSize;
             _rangePtr += _rangeSize;
@@ -313,6 +291,32 @@ public:
         // attach specified blob to the end of the list
         //
         _blobs.push_back(buffer);
+        _blobsSize += buffer.size();
+    }
+
+    /// @brief Reserve contiguous space of the specified size, to be written
+    /// later through the returned pointer.
+    ///
+    /// The pointer stays valid for the lifetime of the stream, which allows
+    /// writers to back-patch values, such as lengths, which are known only
+    /// after more data has been written.
+    char* Reserve(uint32_t size)
+    {
+        if (size > _bufferSize - _rangeSize - _rangeOffset)
+        {
+            NewBuffer(size);
+        }
+
+        char* ptr = _rangePtr + _rangeSize;
+        _rangeSize += size;
+
+        return ptr;
+    }
+
+    /// @brief Get the number of bytes written to the stream
+    uint32_t GetCount() const
+    {
+        return _blobsSize + _rangeSize;
     }
 
     void Flush()
@@ -337,6 +341,42 @@ public:
     }
 
 protected:
+    // snap current range, if not empty, and allocate a new buffer with room
+    // for at least the specified number of bytes
+    void NewBuffer(uint32_t size)
+    {
+        //
+        // snap current range to internal list of blobs, if not empty
+        //
+        if (_rangeSize > 0)
+        {
+            _blobs.emplace_back(_buffer, _rangeOffset, _rangeSize);
+            _blobsSize += _rangeSize;
+        }
+
+        // cap buffer to prevent overflow
+        if (_bufferSize > ((std::numeric_limits<uint32_t>::max)() >> 1))
+        {
+            throw std::bad_alloc();
+        }
+
+        //
+        // grow buffer by 50% (at least 4096 bytes for initial buffer)
+        // and enough to store left overs of specified buffer
+        //
+        _bufferSize += _bufferSize ? _bufferSize / 2 : 4096;
+        _bufferSize = (std::max)(_bufferSize, size);
+
+        _buffer = boost::allocate_shared_noinit<char[]>(_allocator, _bufferSize);
+
+        //
+        // init range
+        //
+        _rangeOffset = 0;
+        _rangePtr = _buffer.get();
+        _rangeSize = 0;
+    }
+
     // allocator instance
     A _allocator;
 
@@ -346,6 +386,9 @@ protected:
     // size of current buffer
     uint32_t _bufferSize;
 
+    // total size of the blobs in the list
+    uint32_t _blobsSize;
+
     // size of current buffer range
     uint32_t _rangeSize;
 
@@ -91,6 +91,13 @@ public:
 
     // Write a memory blob
     void Write(const bond::blob& blob);
+
+    // Optional, required by Fast Binary v2: reserve contiguous space for a
+    // value written later through the returned pointer
+    char* Reserve(uint32_t size);
+
+    // Optional, required by Fast Binary v2: get number of bytes written
+    uint32_t GetCount() const;
 };
 #endif
 
@@ -0,0 +1,202 @@
+#include "precompiled.h"
+#include "allocators.h"
+
+#include <bond/ext/arena_allocator.h>
+#include <bond/ext/capped_allocator.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <map>
+#include <scoped_allocator>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(ArenaAllocatorTests)
+
+using counter_type = bond::ext::single_threaded_counter<>;
+using counted_allocator = bond::ext::capped_allocator<std::allocator<char>, counter_type&>;
+using counted_arena = bond::ext::monotonic_arena<counted_allocator>;
+
+template <typename T>
+using arena_allocator = bond::ext::arena_allocator<T, counted_allocator>;
+
+template <typename T>
+using scoped_allocator = std::scoped_allocator_adaptor<arena_allocator<T> >;
+
+using string = std::basic_string<char, std::char_traits<char>, scoped_allocator<char> >;
+
+static bool is_aligned(const void* ptr, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+BOOST_AUTO_TEST_CASE(ArenaAlignmentTest)
+{
+    counter_type counter{ 1 << 20 };
+    counted_arena arena{ 256, counted_allocator{ counter } };
+
+    const char* prev = nullptr;
+
+    for (std::size_t alignment : { 1, 8, 2, 16, 4, 64, 1, 8 })
+    {
+        char* ptr = static_cast<char*>(arena.allocate(3, alignment));
+
+        BOOST_CHECK(is_aligned(ptr, alignment));
+        BOOST_CHECK(prev == nullptr || ptr >= prev + 3);
+
+        prev = ptr;
+    }
+
+    BOOST_CHECK_EQUAL(arena.used(), 24u);
+    BOOST_CHECK_EQUAL(arena.capacity(), 256u);
+}
+
+BOOST_AUTO_TEST_CASE(ArenaGrowthTest)
+{
+    counter_type counter{ 1 << 20 };
+
+    {
+        counted_arena arena{ 100, counted_allocator{ counter } };
+
+        arena.allocate(60, 1);
+        BOOST_CHECK_EQUAL(counter.value(), 100u);
+
+        // Doesn't fit the first chunk, the next one is twice as large.
+        arena.allocate(60, 1);
+        BOOST_CHECK_EQUAL(counter.value(), 300u);
+
+        // Larger than the next chunk would be.
+        arena.allocate(1000, 8);
+        BOOST_CHECK_GT(counter.value(), 1300u);
+        BOOST_CHECK_EQUAL(arena.capacity(), counter.value());
+        BOOST_CHECK_EQUAL(arena.used(), 1120u);
+
+        arena.release();
+        BOOST_CHECK_EQUAL(counter.value(), 0u);
+        BOOST_CHECK_EQUAL(arena.capacity(), 0u);
+        BOOST_CHECK_EQUAL(arena.used(), 0u);
+
+        arena.allocate(10, 1);
+        BOOST_CHECK_GT(counter.value(), 0u);
+    }
+
+    BOOST_CHECK_EQUAL(counter.value(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(ArenaResetTest)
+{
+    counter_type counter{ 1 << 20 };
+    counted_arena arena{ 100, counted_allocator{ counter } };
+
+    arena.allocate(60, 1);
+    arena.allocate(60, 1);
+    BOOST_CHECK_EQUAL(counter.value(), 300u);
+
+    arena.reset();
+    BOOST_CHECK_EQUAL(counter.value(), 200u);
+    BOOST_CHECK_EQUAL(arena.capacity(), 200u);
+    BOOST_CHECK_EQUAL(arena.used(), 0u);
+
+    // The kept chunk is large enough now.
+    const void* first = arena.allocate(60, 1);
+    arena.allocate(60, 1);
+    BOOST_CHECK_EQUAL(counter.value(), 200u);
+
+    arena.reset();
+    BOOST_CHECK_EQUAL(first, arena.allocate(60, 1));
+    BOOST_CHECK_EQUAL(counter.value(), 200u);
+}
+
+BOOST_AUTO_TEST_CASE(ArenaUnderlyingAllocatorTest)
+{
+    auto state = std::make_shared<int>();
+
+    {
+        bond::ext::monotonic_arena<allocator_with_state<> > arena{ 64, state };
+        arena.allocate(10, 1);
+        BOOST_CHECK_EQUAL(arena.get_allocator().state, state);
+    }
+
+    BOOST_CHECK(state.unique());
+}
+
+BOOST_AUTO_TEST_CASE(AllocatorComparisonTest)
+{
+    counter_type counter{ 1 << 20 };
+    counted_arena arena1{ 4096, counted_allocator{ counter } };
+    counted_arena arena2{ 4096, counted_allocator{ counter } };
+
+    const arena_allocator<char> a1{ arena1 };
+    const arena_allocator<int> a2{ a1 };
+    const arena_allocator<char> a3{ arena2 };
+
+    BOOST_CHECK_EQUAL(&a2.get_arena(), &arena1);
+    BOOST_CHECK((a1 == a2));
+    BOOST_CHECK((a1 != a3));
+    BOOST_CHECK_EQUAL(a2.max_size(), a1.max_size() / sizeof(int));
+}
+
+BOOST_AUTO_TEST_CASE(ScopedAllocatorTest)
+{
+    counter_type counter{ 1 << 20 };
+    counted_arena arena{ 4096, counted_allocator{ counter } };
+
+    using list_type = std::vector<string, scoped_allocator<string> >;
+    using map_type = std::map<string, list_type, std::less<string>,
+        scoped_allocator<std::pair<const string, list_type> > >;
+
+    std::vector<map_type, scoped_allocator<map_type> > list{ arena_allocator<map_type>{ arena } };
+
+    list.resize(3);
+
+    const string key{ "a key that is too long for small string optimization", list.get_allocator() };
+    list[1][key].emplace_back("a value that is too long for small string optimization");
+
+    const auto& item = *list[1].begin();
+
+    BOOST_CHECK_EQUAL(&item.first.get_allocator().get_arena(), &arena);
+    BOOST_CHECK_EQUAL(&item.second.get_allocator().get_arena(), &arena);
+    BOOST_CHECK_EQUAL(&item.second.front().get_allocator().get_arena(), &arena);
+
+    const std::size_t used = arena.used();
+    BOOST_CHECK_GT(used, 100u);
+
+    list.clear();
+    BOOST_CHECK_EQUAL(arena.used(), used);
+}
+
+BOOST_AUTO_TEST_CASE(BlobTest)
+{
+    counter_type counter{ 1 << 20 };
+    counted_arena arena{ 4096, counted_allocator{ counter } };
+
+    const SimpleStruct from = InitRandom<SimpleStruct>();
+
+    using Output = bond::OutputMemoryStream<arena_allocator<char> >;
+
+    Output output{ arena_allocator<char>{ arena } };
+    bond::CompactBinaryWriter<Output> writer(output);
+    bond::Serialize(from, writer);
+
+    const bond::blob payload = output.GetBuffer();
+    BOOST_CHECK_GE(arena.used(), payload.size());
+
+    SimpleStruct to;
+    bond::Deserialize(bond::CompactBinaryReader<bond::InputBuffer>(payload), to);
+    BOOST_CHECK((from == to));
+
+    const std::size_t used = arena.used();
+    const bond::blob copy = bond::blob_prolong(bond::blob(payload.content(), payload.size()), arena_allocator<char>{ arena });
+
+    BOOST_CHECK(copy == payload);
+    BOOST_CHECK(copy.content() != payload.content());
+    BOOST_CHECK_GE(arena.used(), used + payload.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -1,6 +1,7 @@
 #include "precompiled.h"
 #include <bond/core/container_interface.h>
 #include "container_extensibility.h"
+#include <bond/ext/boost_flat_containers.h>
 
 
 template <typename T>
@@ -20,7 +21,17 @@ struct SimpleSet
     SimpleSet& operator=(const SimpleSet&) = default;
 #endif
 
+    typedef size_t size_type;
+
+    // Records the sizes it is called with, so that tests can check that
+    // reserve_set/reserve_map call it through the has_reserve hook.
+    void reserve(size_type size)
+    {
+        reserved.push_back(size);
+    }
+
     std::set<T> impl;
+    std::vector<size_type> reserved;
 };
 
 
@@ -84,7 +95,17 @@ struct SimpleMap
     SimpleMap& operator=(const SimpleMap&) = default;
 #endif
 
+    typedef size_t size_type;
+
+    // Records the sizes it is called with, so that tests can check that
+    // reserve_set/reserve_map call it through the has_reserve hook.
+    void reserve(size_type size)
+    {
+        reserved.push_back(size);
+    }
+
     std::map<K, T> impl;
+    std::vector<size_type> reserved;
 };
 
 
@@ -173,6 +194,79 @@ struct SimpleMapTests
 };
 
 
+template <typename Reader, typename Writer>
+struct FlatSetTests
+{
+    template <typename T>
+    void operator()(const T&)
+    {
+        {
+            typedef BondStruct<boost::container::flat_set<T> > Flat;
+            typedef BondStruct<std::set<T> >                   Standard;
+
+            AllBindingAndMapping<Reader, Writer, Flat, Standard>();
+            AllBindingAndMapping<Reader, Writer, Standard, Flat>();
+        }
+    }
+};
+
+
+template <typename Reader, typename Writer>
+struct FlatMapTests
+{
+    template <typename T>
+    void operator()(const T&)
+    {
+        {
+            typedef BondStruct<boost::container::flat_map<T, SimpleStruct> > Flat;
+            typedef BondStruct<std::map<T, SimpleStruct> >                   Standard;
+
+            AllBindingAndMapping<Reader, Writer, Flat, Standard>();
+            AllBindingAndMapping<Reader, Writer, Standard, Flat>();
+        }
+    }
+};
+
+
+// Custom containers with a reserve member get it called once, with the
+// number of elements in the payload.
+template <typename Reader, typename Writer>
+struct ReserveTests
+{
+    template <typename T>
+    void operator()(const T&)
+    {
+        {
+            typedef BondStruct<SimpleSet<T> >    Custom;
+            typedef BondStruct<std::set<T> >     Standard;
+
+            const Standard from = InitRandom<Standard>();
+
+            Custom to;
+            GetBonded<Reader, Writer, Standard>(from).Deserialize(to);
+
+            UT_AssertAreEqual(to.field.reserved.size(), 1u);
+            UT_AssertAreEqual(to.field.reserved.front(), from.field.size());
+            UT_AssertAreEqual(to.field.impl.size(), from.field.size());
+        }
+
+        {
+            typedef BondStruct<SimpleMap<T, SimpleStruct> > Custom;
+            typedef BondStruct<std::map<T, SimpleStruct> >  Standard;
+
+            const Standard from = InitRandom<Standard>();
+
+            Custom to;
+            GetBonded<Reader, Writer, Standard>(from).Deserialize(to);
+
+            UT_AssertAreEqual(to.field.reserved.size(), 1u);
+            UT_AssertAreEqual(to.field.reserved.front(), from.field.size());
+            UT_AssertAreEqual(to.field.impl.size(), from.field.size());
+        }
+    }
+};
+
+
 typedef boost::mpl::list
     <
 #ifndef UNIT_TEST_TYPE_SUBSET
@@ -202,6 +296,30 @@ TEST_CASE_BEGIN(SimpleMapTest)
 TEST_CASE_END
 
 
+template <typename Reader, typename Writer>
+TEST_CASE_BEGIN(FlatSetTest)
+{
+    boost::mpl::for_each<Types>(FlatSetTests<Reader, Writer>());
+}
+TEST_CASE_END
+
+
+template <typename Reader, typename Writer>
+TEST_CASE_BEGIN(FlatMapTest)
+{
+    boost::mpl::for_each<Types>(FlatMapTests<Reader, Writer>());
+}
+TEST_CASE_END
+
+
+template <typename Reader, typename Writer>
+TEST_CASE_BEGIN(ReserveTest)
+{
+    boost::mpl::for_each<Types>(ReserveTests<Reader, Writer>());
+}
+TEST_CASE_END
+
+
 template <uint16_t N, typename Reader, typename Writer>
 void AssociativeContainerExtensibilityTests(const char* name)
 {
@@ -212,6 +330,15 @@ void AssociativeContainerExtensibilityTests(const char* name)
 
     AddTestCase<TEST_ID(N), 
         SimpleSetTest, Reader, Writer>(suite, "Custom set tests");
+
+    AddTestCase<TEST_ID(N),
+        FlatMapTest, Reader, Writer>(suite, "boost::container::flat_map tests");
+
+    AddTestCase<TEST_ID(N),
+        FlatSetTest, Reader, Writer>(suite, "boost::container::flat_set tests");
+
+    AddTestCase<TEST_ID(N),
+        ReserveTest, Reader, Writer>(suite, "Custom container reserve tests");
 }
 
 
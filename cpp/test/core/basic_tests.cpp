@@ -130,6 +130,52 @@ TEST_CASE_BEGIN(OutputCounterTests)
 TEST_CASE_END
 
 
+template <typename Reader, typename Writer>
+TEST_CASE_BEGIN(WideStringTests)
+{
+    typedef BondStruct<std::wstring> T;
+
+    // Lengths around the block and vector sizes used to convert the
+    // characters.
+    for (uint32_t length : { 0, 1, 7, 8, 9, 255, 256, 257, 1000 })
+    {
+        T from;
+
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            const wchar_t chars[] = { L'a', 0x7f, 0x80, 0x7fff, 0x8000, 0xfffe, 0xffff };
+            from.field.push_back(chars[i % (sizeof(chars) / sizeof(chars[0]))]);
+        }
+
+        typename Writer::Buffer buffer;
+        Writer writer(buffer);
+        bond::Serialize(from, writer);
+
+        T to;
+        bond::Deserialize(Reader(buffer.GetBuffer()), to);
+
+        UT_Compare(from, to);
+    }
+
+    if (sizeof(wchar_t) > sizeof(uint16_t))
+    {
+        // Only the low 16 bits of wider characters are serialized.
+        T from;
+        from.field.assign(20, static_cast<wchar_t>(0x12345));
+
+        typename Writer::Buffer buffer;
+        Writer writer(buffer);
+        bond::Serialize(from, writer);
+
+        T to;
+        bond::Deserialize(Reader(buffer.GetBuffer()), to);
+
+        UT_AssertIsTrue(to.field == std::wstring(20, static_cast<wchar_t>(0x2345)));
+    }
+}
+TEST_CASE_END
+
+
 template <uint16_t N, typename Reader, typename Writer>
 void BasicTests(const char* name)
 {
@@ -138,6 +184,8 @@ void BasicTests(const char* name)
     AddTestCase<TEST_ID(N), MetaTests, Reader, Writer>(suite, "Meta tests");
 
     AddTestCase<TEST_ID(N), OutputCounterTests, Reader, Writer>(suite, "OutputCounter tests");
+
+    AddTestCase<TEST_ID(N), WideStringTests, Reader, Writer>(suite, "wstring tests");
 }
 
 
@@ -352,6 +352,17 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(BondStructDeserializationTest, Reader, all_protoco
         BOOST_CHECK((from == to));
     }
 
+    // BOOST_TEST_CONTEXT("Deserialize into an existing object")
+    {
+        Reader reader{ buffer };
+
+        decltype(alloc) new_alloc{ max_size };
+        decltype(from) to{ new_alloc };
+        InitRandom(to);
+        BOOST_REQUIRE_NO_THROW(bond::DeserializeExisting(reader, to));
+        BOOST_CHECK((from == to));
+    }
+
     // BOOST_TEST_CONTEXT("Runtime schema deserialize with overflow")
     {
         Reader reader{ buffer };
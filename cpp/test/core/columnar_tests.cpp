@@ -0,0 +1,268 @@
+#include "precompiled.h"
+
+#include <bond/core/box.h>
+#include <bond/core/columnar.h>
+
+#include <columnar_test_reflection.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(ColumnarTests)
+
+using columnar_test::Event;
+using columnar_test::Entry;
+using columnar_test::EventBase;
+using columnar_test::Sample;
+using columnar_test::WideSample;
+
+static std::vector<Event> MakeEvents(uint32_t count)
+{
+    std::vector<Event> events(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Event& event = events[i];
+
+        static_cast<EventBase&>(event).id = 1000 + i;
+        event.timestamp = 1500000000000 + 10 * i;
+        event.level = static_cast<columnar_test::Level>(i % 4);
+        event.message = "message " + std::to_string(i % 3);
+        event.value = i * 0.25;
+        event.flag = (i % 2) != 0;
+        event.tags.assign(i % 3, static_cast<int32_t>(i));
+        event.source.host = "host";
+        event.source.port = static_cast<uint16_t>(i);
+
+        if (i % 3 == 0)
+        {
+            event.origin.set().host = "origin " + std::to_string(i);
+        }
+
+        if (i % 2 == 0)
+        {
+            event.retries.set_value() = i;
+        }
+
+        if (i % 5 == 1)
+        {
+            event.priority.set_value() = columnar_test::Error;
+        }
+    }
+
+    return events;
+}
+
+static bool Equal(const Event& left, const Event& right)
+{
+    return static_cast<const EventBase&>(left).id == static_cast<const EventBase&>(right).id
+        && left.timestamp == right.timestamp
+        && left.level == right.level
+        && left.message == right.message
+        && left.value == right.value
+        && left.flag == right.flag
+        && left.tags == right.tags
+        && left.source == right.source
+        && left.origin == right.origin
+        && left.retries == right.retries
+        && left.priority == right.priority;
+}
+
+template <typename Reader, typename Writer, typename Result, typename Rows>
+static std::vector<Result> Roundtrip(const std::vector<Rows>& rows)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::SerializeColumns(rows, writer);
+
+    std::vector<Result> result;
+    bond::DeserializeColumns(Reader(output.GetBuffer()), result);
+    return result;
+}
+
+template <typename Reader, typename Writer>
+static void RoundtripEvents(uint32_t count)
+{
+    const std::vector<Event> events = MakeEvents(count);
+    const std::vector<Event> result = Roundtrip<Reader, Writer, Event>(events);
+
+    BOOST_REQUIRE_EQUAL(result.size(), events.size());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        BOOST_CHECK(Equal(result[i], events[i]));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(RoundtripTest)
+{
+    typedef bond::CompactBinaryReader<bond::InputBuffer> CompactReader;
+    typedef bond::CompactBinaryWriter<bond::OutputBuffer> CompactWriter;
+    typedef bond::FastBinaryReader<bond::InputBuffer> FastReader;
+    typedef bond::FastBinaryWriter<bond::OutputBuffer> FastWriter;
+
+    for (uint32_t count : { 0, 1, 7, 8, 9, 100 })
+    {
+        RoundtripEvents<CompactReader, CompactWriter>(count);
+        RoundtripEvents<FastReader, FastWriter>(count);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(CompactBinaryV2Test)
+{
+    const std::vector<Event> events = MakeEvents(20);
+
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output, bond::v2);
+    bond::SerializeColumns(events, writer);
+
+    std::vector<Event> result;
+    bond::DeserializeColumns(bond::CompactBinaryReader<bond::InputBuffer>(output.GetBuffer(), bond::v2), result);
+
+    BOOST_REQUIRE_EQUAL(result.size(), events.size());
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        BOOST_CHECK(Equal(result[i], events[i]));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(ReplacesContentTest)
+{
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output);
+    bond::SerializeColumns(MakeEvents(2), writer);
+
+    std::vector<Event> result = MakeEvents(5);
+    result[0].origin.set().host = "stale";
+    result[1].priority.set_value() = columnar_test::Debug;
+
+    bond::DeserializeColumns(bond::CompactBinaryReader<bond::InputBuffer>(output.GetBuffer()), result);
+
+    BOOST_REQUIRE_EQUAL(result.size(), 2u);
+    BOOST_CHECK(Equal(result[0], MakeEvents(2)[0]));
+    BOOST_CHECK(Equal(result[1], MakeEvents(2)[1]));
+}
+
+
+BOOST_AUTO_TEST_CASE(SmallerThanListTest)
+{
+    const std::vector<Event> events = MakeEvents(1000);
+
+    bond::OutputBuffer columns;
+    bond::CompactBinaryWriter<bond::OutputBuffer> columns_writer(columns);
+    bond::SerializeColumns(events, columns_writer);
+
+    bond::OutputBuffer list;
+    bond::CompactBinaryWriter<bond::OutputBuffer> list_writer(list);
+    bond::Serialize(bond::make_box(events), list_writer);
+
+    BOOST_CHECK_LT(columns.GetBuffer().length(), list.GetBuffer().length());
+}
+
+
+BOOST_AUTO_TEST_CASE(MatchingTypesTest)
+{
+    std::vector<Sample> samples(3);
+
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        samples[i].count = -i;
+        samples[i].ratio = i * 0.5f;
+        samples[i].name = "sample";
+    }
+
+    const std::vector<WideSample> result =
+        Roundtrip<bond::CompactBinaryReader<bond::InputBuffer>,
+                  bond::CompactBinaryWriter<bond::OutputBuffer>, WideSample>(samples);
+
+    // Columns are promoted to the types of the fields, columns of unknown
+    // fields are skipped and fields without columns have default values.
+    BOOST_REQUIRE_EQUAL(result.size(), 3u);
+
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK_EQUAL(result[i].count, -i);
+        BOOST_CHECK_EQUAL(result[i].ratio, i * 0.5);
+        BOOST_CHECK_EQUAL(result[i].extra, "extra");
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(SlicingTest)
+{
+    typedef bond::CompactBinaryReader<bond::InputBuffer> Reader;
+    typedef bond::CompactBinaryWriter<bond::OutputBuffer> Writer;
+
+    std::vector<Entry> entries(3);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        static_cast<EventBase&>(entries[i]).id = i + 1;
+        entries[i].sequence = 100 * (i + 1);
+        entries[i].text = "entry";
+    }
+
+    // Columns of the derived struct are skipped, even those with the same
+    // ids and types as fields of the base,
+    const std::vector<EventBase> bases = Roundtrip<Reader, Writer, EventBase>(entries);
+
+    BOOST_REQUIRE_EQUAL(bases.size(), 3u);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK_EQUAL(bases[i].id, i + 1);
+    }
+
+    // and fields of the derived struct missing from the payload have default
+    // values.
+    const std::vector<Entry> result = Roundtrip<Reader, Writer, Entry>(bases);
+
+    BOOST_REQUIRE_EQUAL(result.size(), 3u);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK_EQUAL(static_cast<const EventBase&>(result[i]).id, i + 1);
+        BOOST_CHECK_EQUAL(result[i].sequence, 0u);
+        BOOST_CHECK(result[i].text.empty());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(MalformedColumnTest)
+{
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output);
+
+    // Three rows with a column of two values
+    writer.WriteStructBegin(bond::Metadata(), false);
+    writer.WriteFieldBegin(bond::BT_UINT32, 0);
+    writer.Write(uint32_t(3));
+    writer.WriteFieldEnd();
+    writer.WriteFieldBegin(bond::BT_STRUCT, 1);
+    writer.WriteStructBegin(bond::Metadata(), false);
+    writer.WriteFieldBegin(bond::BT_LIST, 10);
+    writer.WriteContainerBegin(2, bond::BT_INT32);
+    writer.Write(int32_t(1));
+    writer.Write(int32_t(2));
+    writer.WriteContainerEnd();
+    writer.WriteFieldEnd();
+    writer.WriteStructEnd(false);
+    writer.WriteFieldEnd();
+    writer.WriteStructEnd(false);
+
+    std::vector<Sample> result;
+
+    BOOST_CHECK_THROW(
+        bond::DeserializeColumns(bond::CompactBinaryReader<bond::InputBuffer>(output.GetBuffer()), result),
+        bond::StreamException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -2,6 +2,7 @@
 #include "multi_index.h"
 #include "precompiled.h"
 #include "container_extensibility.h"
+#include <bond/ext/boost_flat_containers.h>
 
 
 template <typename Protocols, typename T, size_t N>
@@ -171,6 +172,28 @@ TEST_CASE_BEGIN(MultiIndexTest)
 TEST_CASE_END
 
 
+template <typename Reader, typename Writer>
+TEST_CASE_BEGIN(SmallVectorTest)
+{
+    {
+        typedef BondStruct<std::vector<uint32_t> > Standard;
+        typedef BondStruct<boost::container::small_vector<uint32_t, 4> > Custom;
+
+        AllBindingAndMapping<Reader, Writer, Custom, Standard>();
+        AllBindingAndMapping<Reader, Writer, Standard, Custom>();
+    }
+
+    {
+        typedef BondStruct<std::vector<SimpleStruct> > Standard;
+        typedef BondStruct<boost::container::small_vector<SimpleStruct, 4> > Custom;
+
+        AllBindingAndMapping<Reader, Writer, Custom, Standard>();
+        AllBindingAndMapping<Reader, Writer, Standard, Custom>();
+    }
+}
+TEST_CASE_END
+
+
 template <uint16_t N, typename Reader, typename Writer>
 void ExtensibilityTests(const char* name)
 {
@@ -184,6 +207,9 @@ void ExtensibilityTests(const char* name)
 
     AddTestCase<TEST_ID(N),
         MultiIndexTest, Reader, Writer>(suite, "boost::multi_index_container");
+
+    AddTestCase<TEST_ID(N),
+        SmallVectorTest, Reader, Writer>(suite, "boost::container::small_vector");
 }
 
 
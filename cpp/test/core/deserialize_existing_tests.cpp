@@ -0,0 +1,169 @@
+#include "precompiled.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(DeserializeExistingTests)
+
+using Reader = bond::CompactBinaryReader<bond::InputBuffer>;
+using Writer = bond::CompactBinaryWriter<bond::OutputBuffer>;
+
+template <typename T>
+static bond::blob Serialize(const T& obj)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(obj, writer);
+
+    return output.GetBuffer();
+}
+
+
+static NestedListsStruct MakeNestedLists(int8_t seed)
+{
+    NestedListsStruct obj;
+
+    obj.ll8 = { { seed }, { seed, seed } };
+    obj.lSLS.resize(2);
+    obj.lSLS.front().l_string = { "lSLS" };
+    obj.lSLS.back().m_int8_string = { { seed, "lSLS" } };
+    obj.SLS.v_string = { "SLS", "SLS" };
+    obj.SLS.s_uint64 = { 1, 2, 3 };
+    obj.vf = { static_cast<float>(seed), 0.5f };
+    obj.vvNS = { { NestedStruct() } };
+    obj.vvNS[0][0].n1.s.m_str = "vvNS";
+    obj.vvNS[0][0].m_int32 = seed;
+    obj.m64ls = { { 2, { "two" } }, { 4, { "four" } } };
+
+    return obj;
+}
+
+
+static NestedListsStruct MakeOtherNestedLists()
+{
+    NestedListsStruct obj;
+
+    obj.lvls = { { { "lvls" } } };
+    obj.lSLS.resize(3);
+    obj.lSLS.front().v_double = { 1.0 };
+    obj.lSLS.front().l_string = { "other", "other" };
+    obj.SLS.s_uint64 = { 0, 2, 5 };
+    obj.SLS.m_string_bool = { { "other", true } };
+    obj.vf = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    obj.vvNS = { { NestedStruct(), NestedStruct() } };
+    obj.vvNS[0][0].n2.n1.s.m_str = "other";
+    obj.vvNS[0][1].m_str = "other";
+    obj.m64ls = { { 1, { "one" } }, { 2, { "other", "other" } }, { 3, { "three" } } };
+    obj.vmds = { { { 0.5, "other" } } };
+
+    return obj;
+}
+
+
+BOOST_AUTO_TEST_CASE(OverwriteTest)
+{
+    const NestedListsStruct expected = MakeNestedLists(7);
+
+    NestedListsStruct actual = MakeOtherNestedLists();
+    bond::DeserializeExisting(Reader(Serialize(expected)), actual);
+
+    BOOST_CHECK(expected == actual);
+}
+
+
+BOOST_AUTO_TEST_CASE(OmittedFieldsTest)
+{
+    StructWithBase actual;
+    actual.m_str = "derived";
+    actual.m_uint8 = 1;
+    actual.SimpleBase::m_int32 = 2;
+    actual.SimpleStruct::m_str = "base";
+    actual.SimpleStruct::m_blob = bond::blob("blob", 4);
+
+    bond::DeserializeExisting(Reader(Serialize(StructWithBase())), actual);
+
+    BOOST_CHECK(StructWithBase() == actual);
+}
+
+
+BOOST_AUTO_TEST_CASE(ReuseMemoryTest)
+{
+    const NestedListsStruct expected = MakeNestedLists(7);
+
+    NestedListsStruct actual = MakeOtherNestedLists();
+
+    const float* vf = actual.vf.data();
+    const std::vector<NestedStruct>* vvNS = actual.vvNS.data();
+    const SimpleListsStruct* lSLS = &actual.lSLS.front();
+    const std::list<std::string>* m64ls = &actual.m64ls[2];
+    const uint64_t* s_uint64 = &*actual.SLS.s_uint64.find(2);
+
+    bond::DeserializeExisting(Reader(Serialize(expected)), actual);
+
+    BOOST_CHECK(expected == actual);
+    BOOST_CHECK_EQUAL(vf, actual.vf.data());
+    BOOST_CHECK_EQUAL(vvNS, actual.vvNS.data());
+    BOOST_CHECK_EQUAL(lSLS, &actual.lSLS.front());
+    BOOST_CHECK_EQUAL(m64ls, &actual.m64ls[2]);
+    BOOST_CHECK_EQUAL(s_uint64, &*actual.SLS.s_uint64.find(2));
+}
+
+
+BOOST_AUTO_TEST_CASE(RecordLoopTest)
+{
+    const bond::blob payloads[] = {
+        Serialize(MakeNestedLists(1)),
+        Serialize(MakeOtherNestedLists()),
+        Serialize(NestedListsStruct()),
+        Serialize(MakeNestedLists(2))
+    };
+
+    NestedListsStruct actual;
+
+    for (const bond::blob& payload : payloads)
+    {
+        Reader reader(payload);
+        bond::bonded<NestedListsStruct, Reader&>(reader).DeserializeExisting(actual);
+
+        NestedListsStruct expected;
+        bond::Deserialize(Reader(payload), expected);
+
+        BOOST_CHECK(expected == actual);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(RuntimeSchemaTest)
+{
+    const NestedListsStruct expected = MakeNestedLists(7);
+
+    Reader reader(Serialize(expected));
+    bond::bonded<void> bonded(reader, bond::GetRuntimeSchema<NestedListsStruct>());
+
+    NestedListsStruct actual = MakeOtherNestedLists();
+    bonded.DeserializeExisting(actual);
+
+    BOOST_CHECK(expected == actual);
+}
+
+
+BOOST_AUTO_TEST_CASE(SimpleJsonTest)
+{
+    const StructWithBase expected = InitRandom<StructWithBase>();
+
+    bond::OutputBuffer output;
+    bond::SimpleJsonWriter<bond::OutputBuffer> writer(output);
+    bond::Serialize(expected, writer);
+
+    StructWithBase actual = InitRandom<StructWithBase>();
+    bond::SimpleJsonReader<bond::InputBuffer> reader(output.GetBuffer());
+    bond::DeserializeExisting(reader, actual);
+
+    UT_Equal(expected, actual);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
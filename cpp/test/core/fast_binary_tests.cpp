@@ -0,0 +1,184 @@
+#include "precompiled.h"
+
+#include <bond/stream/stdio_output_stream.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(FastBinaryTests)
+
+using Reader = bond::FastBinaryReader<bond::InputBuffer>;
+using Writer = bond::FastBinaryWriter<bond::OutputBuffer>;
+
+template <typename T>
+static bond::blob Serialize(const T& obj, uint16_t version = bond::v2, uint32_t reserve = 1024)
+{
+    bond::OutputBuffer output(reserve);
+    Writer writer(output, version);
+
+    bond::Serialize(obj, writer);
+    BOOST_CHECK_EQUAL(output.GetCount(), output.GetBuffer().length());
+
+    return output.GetBuffer();
+}
+
+template <typename T>
+static T Deserialize(const bond::blob& data, uint16_t version = bond::v2)
+{
+    T obj;
+
+    bond::Deserialize(Reader(data, version), obj);
+    return obj;
+}
+
+static uint32_t ReadLength(const bond::blob& data, uint32_t offset)
+{
+    uint32_t length;
+
+    std::memcpy(&length, data.content() + offset, sizeof(length));
+    return length;
+}
+
+
+BOOST_AUTO_TEST_CASE(EncodingTest)
+{
+    const NestedStruct nested = InitRandom<NestedStruct>();
+    const bond::blob v1 = Serialize(nested, bond::v1);
+    const bond::blob v2 = Serialize(nested);
+
+    // The length of a struct precedes its fields, and each of the nested
+    // structs (n3, n3.n2, n3.n2.n1, n3.n2.n1.s, n2, ...) has its own
+    BOOST_CHECK_EQUAL(ReadLength(v2, 0), v2.length() - sizeof(uint32_t));
+    BOOST_CHECK_EQUAL(v2.length(), v1.length() + 10 * sizeof(uint32_t));
+
+    BOOST_CHECK(Deserialize<NestedStruct>(v2) == nested);
+    BOOST_CHECK(Deserialize<NestedStruct>(v1, bond::v1) == nested);
+
+    // A struct hierarchy has one length
+    const StructWithBase derived = InitRandom<StructWithBase>();
+
+    BOOST_CHECK_EQUAL(Serialize(derived).length(), Serialize(derived, bond::v1).length() + sizeof(uint32_t));
+    BOOST_CHECK(Deserialize<StructWithBase>(Serialize(derived)) == derived);
+
+    // Lengths reserved across buffers and around chained blobs
+    NestedStruct1 blobs;
+    const std::string content(1000, 'b');
+
+    blobs.s.m_blob = bond::blob(content.data(), static_cast<uint32_t>(content.size()));
+    blobs.s.m_str = "blobs";
+
+    const bond::blob data = Serialize(blobs, bond::v2, 3);
+
+    BOOST_CHECK_EQUAL(ReadLength(data, 0), data.length() - sizeof(uint32_t));
+    BOOST_CHECK(Deserialize<NestedStruct1>(data) == blobs);
+}
+
+
+BOOST_AUTO_TEST_CASE(SkipTest)
+{
+    const NestedStruct nested = InitRandom<NestedStruct>();
+
+    for (uint16_t version : { bond::v1, bond::v2 })
+    {
+        const bond::blob data = Serialize(nested, version);
+
+        // Unknown structs are skipped
+        const NestedStructView view = Deserialize<NestedStructView>(data, version);
+
+        BOOST_CHECK_EQUAL(view.m_int8, nested.m_int8);
+        BOOST_CHECK(view.n1 == nested.n1);
+
+        // and bonded<T> fields are skipped until they are deserialized
+        const NestedStructBondedView bonded = Deserialize<NestedStructBondedView>(data, version);
+        NestedStruct3 n3;
+        NestedStruct2 n2;
+
+        bonded.n3.Deserialize(n3);
+        bonded.n2.Deserialize(n2);
+
+        BOOST_CHECK(n3 == nested.n3);
+        BOOST_CHECK(n2 == nested.n2);
+        BOOST_CHECK_EQUAL(bonded.m_int8, nested.m_int8);
+    }
+
+    // Structs are skipped by length without reading their fields: the
+    // struct n3 follows the length of NestedStruct, its field header and
+    // its own length
+    bond::blob data = Serialize(nested);
+    const uint32_t offset = 4 + 3 + 4;
+    const uint32_t length = ReadLength(data, offset - 4);
+    boost::shared_ptr<char[]> corrupted = boost::make_shared_noinit<char[]>(data.length());
+
+    std::memcpy(corrupted.get(), data.content(), data.length());
+    std::memset(corrupted.get() + offset, 0xff, length);
+    data.assign(corrupted, data.length());
+
+    BOOST_CHECK(Deserialize<NestedStructView>(data).n1 == nested.n1);
+    BOOST_CHECK_EQUAL(Deserialize<NestedStructBondedView>(data).m_int8, nested.m_int8);
+}
+
+
+BOOST_AUTO_TEST_CASE(TranscodingTest)
+{
+    const NestedStruct nested = InitRandom<NestedStruct>();
+    const bond::blob v1 = Serialize(nested, bond::v1);
+    const bond::blob v2 = Serialize(nested);
+    const bond::RuntimeSchema schema = bond::GetRuntimeSchema<NestedStruct>();
+
+    for (uint16_t from : { bond::v1, bond::v2 })
+    {
+        for (uint16_t to : { bond::v1, bond::v2 })
+        {
+            const bond::blob& input = from == bond::v1 ? v1 : v2;
+            const bond::blob& expected = to == bond::v1 ? v1 : v2;
+
+            // Structs are copied as is between the same versions and
+            // transcoded between different ones, using the compile-time
+            bond::OutputBuffer output;
+            Writer writer(output, to);
+
+            bond::bonded<NestedStruct>(Reader(input, from)).Serialize(writer);
+            BOOST_CHECK(output.GetBuffer() == expected);
+
+            // or the runtime schema
+            bond::OutputBuffer runtime;
+            Writer runtime_writer(runtime, to);
+
+            bond::bonded<void>(Reader(input, from), schema).Serialize(runtime_writer);
+            BOOST_CHECK(runtime.GetBuffer() == expected);
+
+            // and so are bonded<T> fields
+            const NestedStructBondedView view = Deserialize<NestedStructBondedView>(input, from);
+            const NestedStruct copy = Deserialize<NestedStruct>(Serialize(view, to), to);
+
+            BOOST_CHECK(copy.n3 == nested.n3);
+            BOOST_CHECK(copy.n2 == nested.n2);
+            BOOST_CHECK(copy.n1 == nested.n1);
+        }
+    }
+
+    // Marshaled payloads carry the version
+    bond::OutputBuffer output;
+    Writer writer(output, bond::v2);
+
+    bond::Marshal(nested, writer);
+
+    bond::InputBuffer input(output.GetBuffer());
+    BOOST_CHECK(bond::Unmarshal<NestedStruct>(input) == nested);
+}
+
+
+BOOST_AUTO_TEST_CASE(OutputStreamTest)
+{
+    bond::StdioOutputStream stream(stdout);
+
+    // Writing lengths requires an output buffer which can reserve space
+    BOOST_CHECK_NO_THROW(bond::FastBinaryWriter<bond::StdioOutputStream>(stream, bond::v1));
+    BOOST_CHECK_THROW(bond::FastBinaryWriter<bond::StdioOutputStream>(stream, bond::v2), bond::StreamException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -0,0 +1,210 @@
+#include "precompiled.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(FieldDispatchTests)
+
+using Reader = bond::CompactBinaryReader<bond::InputBuffer>;
+using Writer = bond::CompactBinaryWriter<bond::OutputBuffer>;
+
+static ManyFieldsStruct MakeManyFields()
+{
+    ManyFieldsStruct obj;
+
+    obj.u0 = 1; obj.u1 = 2; obj.u2 = 3; obj.u3 = 4;
+    obj.u4 = 5; obj.u5 = 6; obj.u6 = 7; obj.u7 = 8;
+    obj.u8 = 9; obj.u9 = 10; obj.u10 = 11; obj.u11 = 12;
+    obj.u12 = 13; obj.u13 = 14; obj.u14 = 15; obj.u15 = 16;
+
+    obj.s0 = "s0"; obj.s1 = "s1"; obj.s2 = "s2"; obj.s3 = "s3";
+    obj.s4 = "s4"; obj.s5 = "s5"; obj.s6 = "s6"; obj.s7 = "s7";
+
+    obj.l0 = { 0 }; obj.l1 = { 1 }; obj.l2 = { 2, 2 }; obj.l3 = { 3 };
+    obj.l4 = { 4 }; obj.l5 = { 5, 5 }; obj.l6 = { 6 }; obj.l7 = { 7 };
+
+    obj.n0.m_int32 = 400; obj.n1.m_int32 = 401; obj.n2.m_str = "402"; obj.n3.m_int32 = 403;
+    obj.n4.m_int32 = 404; obj.n5.m_int32 = 405; obj.n6.m_str = "406"; obj.n7.m_int32 = 407;
+
+    return obj;
+}
+
+
+// Writes the fields of a struct in the reverse of the schema order, so that
+// every field but the last arrives out of order.
+template <typename T>
+class ReverseFieldWriter
+{
+public:
+    ReverseFieldWriter(const T& obj, const bond::Serializer<Writer>& serializer)
+        : _obj(obj),
+          _serializer(serializer)
+    {}
+
+    template <typename Field>
+    void operator()(const Field&)
+    {
+        const T& obj = _obj;
+        const bond::Serializer<Writer>& serializer = _serializer;
+
+        _fields.insert(_fields.begin(), [&obj, &serializer]
+        {
+            serializer.Field(Field::id, Field::metadata, Field::GetVariable(obj));
+        });
+    }
+
+    void Write() const
+    {
+        for (const auto& field : _fields)
+        {
+            field();
+        }
+    }
+
+private:
+    const T& _obj;
+    const bond::Serializer<Writer>& _serializer;
+    std::vector<std::function<void()> > _fields;
+};
+
+
+// Serializes the fields of obj in reverse order, preceded by a uint32 field
+// for each of the given unknown ids.
+template <typename T>
+static bond::blob SerializeReversed(const T& obj, const std::vector<uint16_t>& unknownIds = {})
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serializer<Writer> serializer(writer);
+
+    ReverseFieldWriter<T> fields(obj, serializer);
+    boost::mpl::for_each<typename bond::schema<T>::type::fields>(std::ref(fields));
+
+    serializer.Begin(bond::schema<T>::type::metadata);
+
+    for (uint16_t id : unknownIds)
+    {
+        writer.WriteFieldBegin(bond::BT_UINT32, id);
+        writer.Write(id);
+        writer.WriteFieldEnd();
+    }
+
+    fields.Write();
+    serializer.End();
+
+    return output.GetBuffer();
+}
+
+
+static bond::blob Serialize(const ManyFieldsStruct& obj)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(obj, writer);
+
+    return output.GetBuffer();
+}
+
+
+BOOST_AUTO_TEST_CASE(OutOfOrderFieldsTest)
+{
+    const ManyFieldsStruct expected = MakeManyFields();
+
+    ManyFieldsStruct actual;
+    bond::Deserialize(Reader(SerializeReversed(expected)), actual);
+
+    BOOST_CHECK(expected == actual);
+}
+
+
+BOOST_AUTO_TEST_CASE(UnknownFieldsTest)
+{
+    const ManyFieldsStruct expected = MakeManyFields();
+
+    ManyFieldsStruct actual;
+    bond::Deserialize(Reader(SerializeReversed(expected, { 5, 1000, 65000 })), actual);
+
+    BOOST_CHECK(expected == actual);
+}
+
+
+BOOST_AUTO_TEST_CASE(OutOfOrderFieldsRuntimeSchemaTest)
+{
+    const ManyFieldsStruct expected = MakeManyFields();
+
+    Reader reader(SerializeReversed(expected));
+    bond::bonded<void> bonded(reader, bond::GetRuntimeSchema<ManyFieldsStruct>());
+
+    ManyFieldsStruct actual;
+    bonded.Deserialize(actual);
+
+    BOOST_CHECK(expected == actual);
+}
+
+
+BOOST_AUTO_TEST_CASE(InOrderFieldsRuntimeSchemaTest)
+{
+    const ManyFieldsStruct expected = MakeManyFields();
+
+    Reader reader(Serialize(expected));
+    bond::bonded<void> bonded(reader, bond::GetRuntimeSchema<ManyFieldsStruct>());
+
+    ManyFieldsStruct actual;
+    bonded.Deserialize(actual);
+
+    BOOST_CHECK(expected == actual);
+}
+
+
+// Ids of ManyFieldsStruct are sparse, so CompiledMappings looks them up by
+// binary search rather than in a table indexed by id.
+BOOST_AUTO_TEST_CASE(SparseCompiledMappingsTest)
+{
+    const ManyFieldsStruct from = MakeManyFields();
+
+    // Maps every field to itself except u1 and n0, which aren't mapped
+    bond::Mappings mappings;
+
+    for (const bond::FieldDef& field : bond::GetRuntimeSchema<ManyFieldsStruct>().GetStruct().fields)
+    {
+        mappings[field.id].path.push_back(field.id);
+    }
+
+    mappings.erase(10);
+    mappings.erase(400);
+
+    ManyFieldsStruct expected = from;
+    expected.u1 = 0;
+    expected.n0 = SimpleStruct();
+
+    const bond::CompiledMappings compiled(mappings);
+
+    // Compile-time schema
+    {
+        ManyFieldsStruct to;
+
+        bond::bonded<ManyFieldsStruct> bonded(Reader(Serialize(from)));
+        bond::Apply(bond::MapTo<ManyFieldsStruct>(to, compiled), bonded);
+
+        BOOST_CHECK(expected == to);
+    }
+
+    // Runtime schema, with the fields out of order
+    {
+        ManyFieldsStruct to;
+
+        bond::bonded<void> bonded(Reader(SerializeReversed(from)), bond::GetRuntimeSchema<ManyFieldsStruct>());
+        bond::Apply(bond::MapTo<ManyFieldsStruct>(to, compiled), bonded);
+
+        BOOST_CHECK(expected == to);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
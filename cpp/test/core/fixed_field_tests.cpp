@@ -0,0 +1,173 @@
+#include "precompiled.h"
+
+#include <fixed_test_reflection.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(FixedFieldTests)
+
+using fixed_test::Ids;
+using fixed_test::VariableIds;
+
+using Reader = bond::CompactBinaryReader<bond::InputBuffer>;
+using Writer = bond::CompactBinaryWriter<bond::OutputBuffer>;
+
+template <typename T>
+static T MakeIds(std::mt19937_64& random)
+{
+    T ids;
+
+    ids.hash = random();
+    ids.signed_hash = static_cast<int64_t>(random());
+    ids.crc = static_cast<uint32_t>(random());
+    ids.offset = -static_cast<int32_t>(random() % 1000);
+    ids.kind = fixed_test::First;
+    ids.optional_hash.set_value() = random();
+    ids.count = 42;
+    ids.name = "ids";
+
+    return ids;
+}
+
+template <typename T>
+static bond::blob Serialize(const T& obj, uint16_t version = bond::v3)
+{
+    bond::OutputBuffer output;
+    Writer writer(output, version);
+
+    bond::Serialize(obj, writer);
+    return output.GetBuffer();
+}
+
+template <typename T>
+static T Deserialize(const bond::blob& data, uint16_t version = bond::v3)
+{
+    T obj;
+
+    bond::Deserialize(Reader(data, version), obj);
+    return obj;
+}
+
+
+BOOST_AUTO_TEST_CASE(RoundtripTest)
+{
+    std::mt19937_64 random(42);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        const Ids ids = MakeIds<Ids>(random);
+        const VariableIds variable = MakeIds<VariableIds>(random);
+
+        BOOST_CHECK(Deserialize<Ids>(Serialize(ids)) == ids);
+
+        // Readers don't need the attribute, and values written with and
+        // without it can be read into fields of either kind
+        const Ids converted = Deserialize<Ids>(Serialize(variable));
+        BOOST_CHECK(Serialize(converted) != Serialize(variable));
+        BOOST_CHECK(Deserialize<VariableIds>(Serialize(converted)) == variable);
+    }
+
+    // Default values, including the omitted field of type maybe
+    BOOST_CHECK(Deserialize<Ids>(Serialize(Ids())) == Ids());
+}
+
+
+BOOST_AUTO_TEST_CASE(EncodingTest)
+{
+    std::mt19937_64 random(7);
+    Ids ids = MakeIds<Ids>(random);
+
+    // Small values such as the offset and kind are shorter as variable
+    // integers, uniformly distributed ones are shorter as words: uint64 takes
+    // 8 bytes instead of up to 10 and uint32 4 bytes instead of 5
+    ids.offset = 0;
+    ids.kind = fixed_test::Second;
+    ids.optional_hash.set_nothing();
+
+    const bond::blob fixed = Serialize(ids);
+    const bond::blob variable = Serialize(Deserialize<VariableIds>(fixed));
+
+    BOOST_CHECK_LT(fixed.length(), variable.length());
+
+    // The value follows the field header as is
+    uint64_t hash;
+    BOOST_REQUIRE_EQUAL(static_cast<uint8_t>(fixed.content()[1]), 20 | (0x06 << 5));
+    BOOST_REQUIRE_EQUAL(static_cast<uint8_t>(fixed.content()[2]), 10);
+    std::memcpy(&hash, fixed.content() + 3, sizeof(hash));
+    BOOST_CHECK_EQUAL(hash, ids.hash);
+
+    // Compact Binary v1 and v2 ignore the attribute
+    BOOST_CHECK(Serialize(ids, bond::v1) == Serialize(Deserialize<VariableIds>(fixed), bond::v1));
+    BOOST_CHECK(Serialize(ids, bond::v2) == Serialize(Deserialize<VariableIds>(fixed), bond::v2));
+    BOOST_CHECK(Deserialize<Ids>(Serialize(ids, bond::v2), bond::v2) == ids);
+}
+
+
+BOOST_AUTO_TEST_CASE(OtherTypesTest)
+{
+    // The attribute has no effect on fields other than 32 and 64 bit
+    // integers and enums
+    fixed_test::VariableOthers variable;
+
+    variable.port = 8080;
+    variable.ratio = 0.5;
+    variable.label = "others";
+    variable.hashes.assign(10, 0x0123456789abcdef);
+    variable.nested.name = "nested";
+
+    const bond::blob data = Serialize(variable);
+    const fixed_test::Others others = Deserialize<fixed_test::Others>(data);
+
+    BOOST_CHECK(Serialize(others) == data);
+    BOOST_CHECK(Deserialize<fixed_test::VariableOthers>(Serialize(others)) == variable);
+}
+
+
+BOOST_AUTO_TEST_CASE(SkipAndPromoteTest)
+{
+    std::mt19937_64 random(3);
+    const Ids ids = MakeIds<Ids>(random);
+    const bond::blob data = Serialize(ids);
+
+    // Fields with the attribute are skipped when unknown
+    BOOST_CHECK_EQUAL(Deserialize<fixed_test::Name>(data).name, ids.name);
+
+    // and promoted to larger types
+    const fixed_test::Promoted promoted = Deserialize<fixed_test::Promoted>(data);
+    BOOST_CHECK_EQUAL(promoted.crc, ids.crc);
+    BOOST_CHECK_EQUAL(promoted.offset, ids.offset);
+
+    // Transcoding with the compile-time and the runtime schema
+    using FastReader = bond::FastBinaryReader<bond::InputBuffer>;
+    using FastWriter = bond::FastBinaryWriter<bond::OutputBuffer>;
+
+    const bond::RuntimeSchema schema = bond::GetRuntimeSchema<Ids>();
+    bond::OutputBuffer fast, fast_runtime, compact_runtime;
+    FastWriter fast_writer(fast), fast_runtime_writer(fast_runtime);
+
+    bond::bonded<Ids>(Reader(data, bond::v3)).Serialize(fast_writer);
+    bond::bonded<void>(Reader(data, bond::v3), schema).Serialize(fast_runtime_writer);
+
+    Ids transcoded;
+    bond::Deserialize(FastReader(fast.GetBuffer()), transcoded);
+    BOOST_CHECK(transcoded == ids);
+
+    transcoded = Ids();
+    bond::Deserialize(FastReader(fast_runtime.GetBuffer()), transcoded);
+    BOOST_CHECK(transcoded == ids);
+
+    // The attribute in the runtime schema is honored too
+    Writer compact_runtime_writer(compact_runtime, bond::v3);
+
+    bond::bonded<void>(FastReader(fast_runtime.GetBuffer()), schema).Serialize(compact_runtime_writer);
+    BOOST_CHECK(compact_runtime.GetBuffer() == data);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
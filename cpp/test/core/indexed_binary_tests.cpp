@@ -0,0 +1,244 @@
+#include "precompiled.h"
+
+#include <bond/protocol/indexed_binary.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(IndexedBinaryTests)
+
+typedef bond::IndexedBinaryReader<bond::InputBuffer> Reader;
+typedef bond::IndexedBinaryWriter<bond::OutputBuffer> Writer;
+
+template <typename T>
+static bond::blob Serialize(const T& value)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(value, writer);
+
+    return output.GetBuffer();
+}
+
+static StructWithBase MakeStructWithBase()
+{
+    StructWithBase value;
+
+    static_cast<SimpleStruct&>(value).m_int32 = 1;
+    static_cast<SimpleBase&>(value).m_int32 = 2;
+    value.m_int32 = 3;
+    static_cast<SimpleStruct&>(value).m_str = "simple struct";
+    value.m_str = "struct with base";
+    value.m_wstr = L"wide string";
+    value.m_uint8 = 200;
+    value.m_double = 3.14;
+
+    return value;
+}
+
+BOOST_AUTO_TEST_CASE(RoundtripTest)
+{
+    const StructWithBase from = MakeStructWithBase();
+    const bond::blob payload = Serialize(from);
+
+    StructWithBase to;
+    bond::Deserialize(Reader(payload), to);
+    BOOST_CHECK((from == to));
+
+    const NestedWithBase nested = InitRandom<NestedWithBase>();
+    NestedWithBase nested_to;
+    bond::Deserialize(Reader(Serialize(nested)), nested_to);
+    BOOST_CHECK((nested == nested_to));
+
+    const ManyFieldsStruct many = InitRandom<ManyFieldsStruct>();
+    ManyFieldsStruct many_to;
+    bond::Deserialize(Reader(Serialize(many)), many_to);
+    BOOST_CHECK((many == many_to));
+}
+
+BOOST_AUTO_TEST_CASE(GetFieldTest)
+{
+    const StructWithBase from = MakeStructWithBase();
+    const bond::bonded<StructWithBase> bonded(Reader(Serialize(from)));
+
+    // Field with the same id at each level of the hierarchy
+    int32_t value = 0;
+    BOOST_CHECK(bond::GetField<SimpleStruct::Schema::var::m_int32>(bonded, value));
+    BOOST_CHECK_EQUAL(value, 1);
+    BOOST_CHECK(bond::GetField<SimpleBase::Schema::var::m_int32>(bonded, value));
+    BOOST_CHECK_EQUAL(value, 2);
+    BOOST_CHECK(bond::GetField<StructWithBase::Schema::var::m_int32>(bonded, value));
+    BOOST_CHECK_EQUAL(value, 3);
+
+    std::string str;
+    BOOST_CHECK(bond::GetField<StructWithBase::Schema::var::m_str>(bonded, str));
+    BOOST_CHECK_EQUAL(str, "struct with base");
+
+    std::wstring wstr;
+    BOOST_CHECK(bond::GetField<SimpleStruct::Schema::var::m_wstr>(bonded, wstr));
+    BOOST_CHECK(wstr == L"wide string");
+
+    uint8_t uint8 = 0;
+    BOOST_CHECK(bond::GetField<StructWithBase::Schema::var::m_uint8>(bonded, uint8));
+    BOOST_CHECK_EQUAL(uint8, 200);
+
+    // Nested structs and containers
+    const NestedWithBase nested = InitRandom<NestedWithBase>();
+    const bond::bonded<NestedWithBase> nested_bonded(Reader(Serialize(nested)));
+
+    NestedWithBase2 n2;
+    BOOST_CHECK(bond::GetField<NestedWithBase::Schema::var::n2>(nested_bonded, n2));
+    BOOST_CHECK((n2 == nested.n2));
+
+    NestedWithBase1 n1;
+    BOOST_CHECK(bond::GetField<NestedWithBase2::Schema::var::n1>(nested_bonded, n1));
+    BOOST_CHECK((n1 == static_cast<const NestedWithBase2&>(nested).n1));
+
+    const ManyFieldsStruct many = InitRandom<ManyFieldsStruct>();
+    const bond::bonded<ManyFieldsStruct> many_bonded(Reader(Serialize(many)));
+
+    std::list<int32_t> list;
+    BOOST_CHECK(bond::GetField<ManyFieldsStruct::Schema::var::l1>(many_bonded, list));
+    BOOST_CHECK((list == many.l1));
+
+    SimpleStruct n7;
+    BOOST_CHECK(bond::GetField<ManyFieldsStruct::Schema::var::n7>(many_bonded, n7));
+    BOOST_CHECK((n7 == many.n7));
+}
+
+BOOST_AUTO_TEST_CASE(GetOmittedFieldTest)
+{
+    ManyFieldsStruct from;
+    from.u1 = 1;
+
+    const bond::bonded<ManyFieldsStruct> bonded(Reader(Serialize(from)));
+
+    // Optional fields with default values are omitted
+    uint32_t value = 5;
+    BOOST_CHECK(!bond::GetField<ManyFieldsStruct::Schema::var::u0>(bonded, value));
+    BOOST_CHECK_EQUAL(value, 5u);
+    BOOST_CHECK(bond::GetField<ManyFieldsStruct::Schema::var::u1>(bonded, value));
+    BOOST_CHECK_EQUAL(value, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(GetFieldTypeMismatchTest)
+{
+    SimpleListsStruct lists;
+    lists.l_bool.push_back(true);
+
+    // Field 1 is a list in the payload and a struct in the schema
+    const bond::bonded<NestedStruct1> bonded(Reader(Serialize(lists)));
+
+    SimpleStruct s;
+    s.m_int32 = 7;
+    BOOST_CHECK(!bond::GetField<NestedStruct1::Schema::var::s>(bonded, s));
+    BOOST_CHECK_EQUAL(s.m_int32, 7);
+
+    // Field 1 is a struct in the payload and uint32 in the schema
+    const bond::bonded<RequiredNested> nested(Reader(Serialize(NestedStruct1())));
+
+    uint32_t x = 7;
+    BOOST_CHECK(!bond::GetField<RequiredNested::Schema::var::x>(nested, x));
+    BOOST_CHECK_EQUAL(x, 7u);
+}
+
+BOOST_AUTO_TEST_CASE(GetFieldOtherProtocolsTest)
+{
+    const StructWithBase from = MakeStructWithBase();
+
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output);
+    bond::Serialize(from, writer);
+
+    const bond::bonded<StructWithBase> bonded(bond::CompactBinaryReader<bond::InputBuffer>(output.GetBuffer()));
+
+    int32_t value = 0;
+    BOOST_CHECK(bond::GetField<SimpleBase::Schema::var::m_int32>(bonded, value));
+    BOOST_CHECK_EQUAL(value, 2);
+
+    const bond::bonded<StructWithBase> instance(from);
+
+    std::string str;
+    BOOST_CHECK(bond::GetField<SimpleStruct::Schema::var::m_str>(instance, str));
+    BOOST_CHECK_EQUAL(str, "simple struct");
+
+    // Omitted fields are reported the same way as by Indexed Binary
+    ManyFieldsStruct many;
+    many.u1 = 1;
+
+    bond::OutputBuffer many_output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> many_writer(many_output);
+    bond::Serialize(many, many_writer);
+
+    const bond::bonded<ManyFieldsStruct> many_bonded(bond::CompactBinaryReader<bond::InputBuffer>(many_output.GetBuffer()));
+
+    uint32_t u = 5;
+    BOOST_CHECK(!bond::GetField<ManyFieldsStruct::Schema::var::u0>(many_bonded, u));
+    BOOST_CHECK_EQUAL(u, 5u);
+    BOOST_CHECK(bond::GetField<ManyFieldsStruct::Schema::var::u1>(many_bonded, u));
+    BOOST_CHECK_EQUAL(u, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(PassThroughTest)
+{
+    const NestedWithBase from = InitRandom<NestedWithBase>();
+    const bond::blob payload = Serialize(from);
+
+    // Same protocol copies the payload
+    BOOST_CHECK(Serialize(bond::bonded<NestedWithBase>(Reader(payload))) == payload);
+
+    // Transcoding via Compact Binary
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output);
+    bond::Serialize(bond::bonded<NestedWithBase>(Reader(payload)), writer);
+
+    const bond::bonded<NestedWithBase> compact(bond::CompactBinaryReader<bond::InputBuffer>(output.GetBuffer()));
+    BOOST_CHECK(Serialize(compact) == payload);
+
+    // Runtime schema
+    const bond::bonded<void> runtime(Reader(payload), bond::GetRuntimeSchema<NestedWithBase>());
+    BOOST_CHECK(Serialize(runtime) == payload);
+}
+
+BOOST_AUTO_TEST_CASE(MarshalTest)
+{
+    const StructWithBase from = MakeStructWithBase();
+
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Marshal<bond::BuiltInProtocols>(from, writer);
+
+    StructWithBase to;
+    bond::Unmarshal(bond::InputBuffer(output.GetBuffer()), to);
+
+    BOOST_CHECK((from == to));
+}
+
+BOOST_AUTO_TEST_CASE(MalformedIndexTest)
+{
+    const bond::blob payload = Serialize(MakeStructWithBase());
+
+    // Point the offsets of the index entries past the end of the struct
+    std::vector<char> data(payload.content(), payload.content() + payload.length());
+    const uint32_t count = static_cast<uint8_t>(data[4]);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        data[8 + i * 8 + 7] = '\x7f';
+    }
+
+    const bond::bonded<StructWithBase> bonded(Reader(bond::blob(data.data(), static_cast<uint32_t>(data.size()))));
+
+    int32_t value;
+    BOOST_CHECK_THROW(bond::GetField<SimpleStruct::Schema::var::m_int32>(bonded, value), bond::StreamException);
+
+    // Truncated index
+    const bond::bonded<StructWithBase> truncated(Reader(payload.range(0, 20)));
+    BOOST_CHECK_THROW(bond::GetField<SimpleStruct::Schema::var::m_int32>(truncated, value), bond::StreamException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -29,6 +29,53 @@ bool Compare(const NestedListsStruct& left, const NestedListsStructView& right)
 }
 
 
+template <typename Reader, typename Writer, typename T>
+TEST_CASE_BEGIN(ByteLists)
+{
+    BondStruct<std::vector<T> > from, to;
+
+    for (uint32_t i = 0; i < 1000; ++i)
+        from.field.push_back(static_cast<T>(i));
+
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(from, writer);
+
+    const bond::blob payload = output.GetBuffer();
+
+    bond::Deserialize(Reader(payload), to);
+    UT_AssertIsTrue(from == to);
+
+    // The list is replaced when deserializing into an existing object.
+    to.field.assign(2000, T(1));
+    bond::DeserializeExisting(Reader(payload), to);
+    UT_AssertIsTrue(from == to);
+
+    BondStruct<std::vector<T> > to2;
+    bond::bonded<void> bonded(Reader(payload), bond::GetRuntimeSchema<BondStruct<std::vector<T> > >());
+    bonded.Deserialize(to2);
+    UT_AssertIsTrue(from == to2);
+
+    // The whole list is bounds checked before it is read.
+    Reader truncated(payload.range(0, payload.length() - 100));
+    UT_AssertThrows(bond::DeserializeExisting(truncated, to), bond::StreamException);
+}
+TEST_CASE_END
+
+
+template <uint16_t N, typename Reader, typename Writer>
+void ByteListTests(const char* name)
+{
+    UnitTestSuite suite(name);
+
+    AddTestCase<TEST_ID(N),
+        ByteLists, Reader, Writer, int8_t>(suite, "List of int8");
+
+    AddTestCase<TEST_ID(N),
+        ByteLists, Reader, Writer, uint8_t>(suite, "List of uint8");
+}
+
+
 template <uint16_t N, typename Reader, typename Writer>
 void SimpleListTests(const char* name)
 {
@@ -54,6 +101,11 @@ void ListTestsInit()
             0x401,
             bond::SimpleBinaryReader<bond::InputBuffer>,
             bond::SimpleBinaryWriter<bond::OutputBuffer> >("List deserialization tests for SimpleBinary");
+
+        ByteListTests<
+            0x405,
+            bond::SimpleBinaryReader<bond::InputBuffer>,
+            bond::SimpleBinaryWriter<bond::OutputBuffer> >("Byte list deserialization tests for SimpleBinary");
     );
 
     TEST_COMPACT_BINARY_PROTOCOL(
@@ -61,6 +113,11 @@ void ListTestsInit()
             0x402,
             bond::CompactBinaryReader<bond::InputBuffer>,
             bond::CompactBinaryWriter<bond::OutputBuffer> >("List deserialization tests for CompactBinary");
+
+        ByteListTests<
+            0x406,
+            bond::CompactBinaryReader<bond::InputBuffer>,
+            bond::CompactBinaryWriter<bond::OutputBuffer> >("Byte list deserialization tests for CompactBinary");
     );
 
     TEST_FAST_BINARY_PROTOCOL(
@@ -68,6 +125,11 @@ void ListTestsInit()
             0x403,
             bond::FastBinaryReader<bond::InputBuffer>,
             bond::FastBinaryWriter<bond::OutputBuffer> >("List deserialization tests for FastBinary");
+
+        ByteListTests<
+            0x407,
+            bond::FastBinaryReader<bond::InputBuffer>,
+            bond::FastBinaryWriter<bond::OutputBuffer> >("Byte list deserialization tests for FastBinary");
     );
 
     TEST_SIMPLE_JSON_PROTOCOL(
@@ -0,0 +1,121 @@
+#include "precompiled.h"
+
+#include <bond/core/box.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <list>
+
+BOOST_AUTO_TEST_SUITE(PackedBoolsTests)
+
+typedef bond::CompactBinaryReader<bond::InputBuffer> Reader;
+typedef bond::CompactBinaryWriter<bond::OutputBuffer> Writer;
+
+template <typename T>
+static bond::blob Serialize(const T& value, uint16_t version)
+{
+    bond::OutputBuffer output;
+    Writer writer(output, version);
+    bond::Serialize(bond::make_box(value), writer);
+    return output.GetBuffer();
+}
+
+template <typename T>
+static T Deserialize(const bond::blob& data, uint16_t version)
+{
+    bond::Box<T> box;
+    bond::Deserialize(Reader(data, version), box);
+    return box.value;
+}
+
+static std::vector<bool> MakeFlags(uint32_t size)
+{
+    std::vector<bool> flags(size);
+
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        flags[i] = (i * 7) % 3 == 0 || i % 11 == 0;
+    }
+
+    return flags;
+}
+
+
+BOOST_AUTO_TEST_CASE(RoundtripTest)
+{
+    for (uint32_t size : { 0, 1, 2, 7, 8, 9, 63, 64, 65, 127, 128, 129, 1000 })
+    {
+        const std::vector<bool> flags = MakeFlags(size);
+
+        for (uint16_t version : { bond::v1, bond::v2, bond::v3 })
+        {
+            BOOST_CHECK(Deserialize<std::vector<bool> >(Serialize(flags, version), version) == flags);
+        }
+
+        // Containers other than std::vector<bool> are read one element at a time
+        const std::list<bool> list(flags.begin(), flags.end());
+
+        BOOST_CHECK(Deserialize<std::list<bool> >(Serialize(flags, bond::v3), bond::v3) == list);
+        BOOST_CHECK(Deserialize<std::vector<bool> >(Serialize(list, bond::v3), bond::v3) == flags);
+    }
+
+    std::set<bool> set;
+    set.insert(false);
+    set.insert(true);
+
+    BOOST_CHECK(Deserialize<std::set<bool> >(Serialize(set, bond::v3), bond::v3) == set);
+}
+
+
+BOOST_AUTO_TEST_CASE(SizeTest)
+{
+    const std::vector<bool> flags = MakeFlags(4000);
+
+    // Struct length, field header, list header and count, packed items, BT_STOP
+    BOOST_CHECK_EQUAL(Serialize(flags, bond::v3).length(), 2u + 1 + 3 + 500 + 1);
+    BOOST_CHECK_EQUAL(Serialize(flags, bond::v2).length(), 2u + 1 + 3 + 4000 + 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(SkipTest)
+{
+    const std::vector<bool> flags = MakeFlags(300);
+
+    Reader input(Serialize(flags, bond::v3), bond::v3);
+    input.Skip(bond::BT_STRUCT);
+    BOOST_CHECK(input.GetBuffer().IsEof());
+
+    // Bools are skipped when read into a list of a different type
+    BOOST_CHECK(Deserialize<std::vector<std::string> >(Serialize(flags, bond::v3), bond::v3).empty());
+
+    bond::Box<std::vector<std::vector<bool> > > nested;
+    nested.value.push_back(flags);
+    nested.value.push_back(MakeFlags(3));
+
+    bond::OutputBuffer output;
+    Writer writer(output, bond::v3);
+    bond::Serialize(nested, writer);
+
+    bond::Box<std::vector<std::vector<bool> > > result;
+    bond::Deserialize(Reader(output.GetBuffer(), bond::v3), result);
+    BOOST_CHECK(result.value == nested.value);
+}
+
+
+BOOST_AUTO_TEST_CASE(TranscodingTest)
+{
+    const std::vector<bool> flags = MakeFlags(200);
+
+    bond::OutputBuffer output;
+    Writer writer(output, bond::v2);
+    bond::Serialize(bond::bonded<bond::Box<std::vector<bool> > >(Reader(Serialize(flags, bond::v3), bond::v3)), writer);
+
+    BOOST_CHECK(Deserialize<std::vector<bool> >(output.GetBuffer(), bond::v2) == flags);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
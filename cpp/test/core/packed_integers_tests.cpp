@@ -0,0 +1,276 @@
+#include "precompiled.h"
+
+#include <bond/core/box.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(PackedIntegersTests)
+
+typedef bond::CompactBinaryReader<bond::InputBuffer> Reader;
+typedef bond::CompactBinaryWriter<bond::OutputBuffer> Writer;
+
+template <typename T>
+static bond::blob Serialize(const T& value, uint16_t version)
+{
+    bond::OutputBuffer output;
+    Writer writer(output, version);
+    bond::Serialize(bond::make_box(value), writer);
+    return output.GetBuffer();
+}
+
+template <typename T>
+static T Deserialize(const bond::blob& data, uint16_t version)
+{
+    bond::Box<T> box;
+    bond::Deserialize(Reader(data, version), box);
+    return box.value;
+}
+
+template <typename T>
+static void Roundtrip(const T& value)
+{
+    BOOST_CHECK(Deserialize<T>(Serialize(value, bond::v3), bond::v3) == value);
+}
+
+template <typename T>
+static void RoundtripIntegers()
+{
+    const T min = (std::numeric_limits<T>::min)();
+    const T max = (std::numeric_limits<T>::max)();
+    std::mt19937_64 random(static_cast<uint32_t>(sizeof(T)));
+
+    for (uint32_t size : { 0, 1, 2, 3, 127, 128, 129, 255, 256, 1000 })
+    {
+        std::vector<T> increasing, random_values, extremes;
+
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            increasing.push_back(static_cast<T>(min + 3 * i));
+            random_values.push_back(static_cast<T>(random()));
+            extremes.push_back(i % 3 == 0 ? min : i % 3 == 1 ? max : T());
+        }
+
+        Roundtrip(increasing);
+        Roundtrip(random_values);
+        Roundtrip(extremes);
+        Roundtrip(std::set<T>(random_values.begin(), random_values.end()));
+        Roundtrip(std::vector<T>(size, max));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(RoundtripTest)
+{
+    RoundtripIntegers<uint16_t>();
+    RoundtripIntegers<uint32_t>();
+    RoundtripIntegers<uint64_t>();
+    RoundtripIntegers<int16_t>();
+    RoundtripIntegers<int32_t>();
+    RoundtripIntegers<int64_t>();
+}
+
+
+BOOST_AUTO_TEST_CASE(ContainersTest)
+{
+    std::vector<bond::BondDataType> types;
+    std::vector<std::vector<int32_t> > lists;
+    std::map<uint32_t, std::vector<uint64_t> > map;
+
+    for (int32_t i = 0; i < 300; ++i)
+    {
+        types.push_back(static_cast<bond::BondDataType>(i % 18));
+        lists.push_back(std::vector<int32_t>(i % 5, -i));
+        map[i].assign(i % 4, i);
+    }
+
+    Roundtrip(types);
+    Roundtrip(lists);
+    Roundtrip(map);
+    Roundtrip(bond::nullable<int64_t>(-1));
+}
+
+
+BOOST_AUTO_TEST_CASE(TranscodingTest)
+{
+    std::vector<int64_t> values;
+
+    for (int64_t i = 0; i < 1000; ++i)
+    {
+        values.push_back(i * i - 500);
+    }
+
+    bond::OutputBuffer output;
+    Writer writer(output, bond::v2);
+    bond::Serialize(bond::bonded<bond::Box<std::vector<int64_t> > >(Reader(Serialize(values, bond::v3), bond::v3)), writer);
+
+    BOOST_CHECK(Deserialize<std::vector<int64_t> >(output.GetBuffer(), bond::v2) == values);
+}
+
+
+BOOST_AUTO_TEST_CASE(MarshalTest)
+{
+    std::vector<uint32_t> values(100, 42);
+
+    bond::OutputBuffer output;
+    Writer writer(output, bond::v3);
+    bond::Marshal(bond::make_box(values), writer);
+
+    bond::Box<std::vector<uint32_t> > box;
+    bond::Unmarshal(bond::InputBuffer(output.GetBuffer()), box);
+
+    BOOST_CHECK(box.value == values);
+}
+
+
+BOOST_AUTO_TEST_CASE(SkipTest)
+{
+    bond::OutputBuffer output;
+    Writer writer(output, bond::v3);
+
+    writer.WriteVersion();
+    writer.WriteFieldBegin(bond::BT_LIST, 0);
+    writer.WriteContainerBegin(200, bond::BT_UINT32);
+
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        writer.Write(i * 7);
+    }
+
+    writer.WriteContainerEnd();
+    writer.WriteFieldEnd();
+    writer.Write(uint32_t(1234));
+
+    Reader reader(output.GetBuffer());
+    uint16_t id;
+    bond::BondDataType type;
+    uint32_t value;
+
+    BOOST_REQUIRE(reader.ReadVersion());
+    reader.ReadFieldBegin(type, id);
+    BOOST_CHECK_EQUAL(type, bond::BT_LIST);
+    reader.Skip(type);
+    reader.Read(value);
+
+    BOOST_CHECK_EQUAL(value, 1234u);
+    BOOST_CHECK(reader.GetBuffer().IsEof());
+
+    // Length of struct written in the first pass includes the packed items
+    Reader input(Serialize(std::vector<int64_t>(300, -1), bond::v3), bond::v3);
+
+    input.Skip(bond::BT_STRUCT);
+    BOOST_CHECK(input.GetBuffer().IsEof());
+}
+
+
+BOOST_AUTO_TEST_CASE(SmallerThanV2Test)
+{
+    std::set<uint64_t> timestamps;
+
+    for (uint64_t i = 0; i < 10000; ++i)
+    {
+        timestamps.insert(1500000000000 + 1000 * i + i % 7);
+    }
+
+    const bond::blob v2 = Serialize(timestamps, bond::v2);
+    const bond::blob v3 = Serialize(timestamps, bond::v3);
+
+    BOOST_CHECK_LT(v3.length() * 4, v2.length());
+    BOOST_CHECK(Deserialize<std::set<uint64_t> >(v3, bond::v3) == timestamps);
+}
+
+
+BOOST_AUTO_TEST_CASE(NotLargerThanV2Test)
+{
+    std::mt19937_64 random(3);
+    std::vector<uint64_t> values;
+    std::vector<int32_t> small;
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        values.push_back(random());
+        small.push_back(static_cast<int32_t>(random() % 100) - 50);
+    }
+
+    // Only the length of the items is added to v2
+    BOOST_CHECK_LE(Serialize(values, bond::v3).length(), Serialize(values, bond::v2).length() + 3);
+    BOOST_CHECK_LE(Serialize(small, bond::v3).length(), Serialize(small, bond::v2).length() + 3);
+    BOOST_CHECK(Deserialize<std::vector<uint64_t> >(Serialize(values, bond::v3), bond::v3) == values);
+    BOOST_CHECK(Deserialize<std::vector<int32_t> >(Serialize(small, bond::v3), bond::v3) == small);
+}
+
+
+BOOST_AUTO_TEST_CASE(MalformedLengthTest)
+{
+    // Blocks shorter than their length
+    const uint8_t blocks[] =
+    {
+        0x08,                                       // struct length
+        bond::BT_LIST,                              // field 0
+        bond::BT_INT32 | (3 << 5),                  // 2 items
+        0x09,                                       // length of packed blocks
+        0x00, 0x00, 0x00, 0x00,                     // first, min, width and an extra byte
+        bond::BT_STOP
+    };
+
+    // Items written as in v2 shorter than their length
+    const uint8_t varints[] =
+    {
+        0x08,                                       // struct length
+        bond::BT_LIST,                              // field 0
+        bond::BT_INT32 | (3 << 5),                  // 2 items
+        0x08,                                       // length of items
+        0x02, 0x04, 0x00, 0x00,                     // items and extra bytes
+        bond::BT_STOP
+    };
+
+    // Blocks longer than their length
+    const uint8_t truncated[] =
+    {
+        0x07,                                       // struct length
+        bond::BT_LIST,                              // field 0
+        bond::BT_INT32 | (3 << 5),                  // 2 items
+        0x05,                                       // length of packed blocks
+        0x00, 0x00, 0x00,                           // first, min and width
+        bond::BT_STOP
+    };
+
+    BOOST_CHECK_THROW(
+        (Deserialize<std::vector<int32_t> >(bond::blob(blocks, sizeof(blocks)), bond::v3)),
+        bond::StreamException);
+
+    BOOST_CHECK_THROW(
+        (Deserialize<std::vector<int32_t> >(bond::blob(varints, sizeof(varints)), bond::v3)),
+        bond::StreamException);
+
+    BOOST_CHECK_THROW(
+        (Deserialize<std::vector<int32_t> >(bond::blob(truncated, sizeof(truncated)), bond::v3)),
+        bond::StreamException);
+}
+
+
+BOOST_AUTO_TEST_CASE(MalformedWidthTest)
+{
+    const uint8_t data[] =
+    {
+        0x08,                                       // struct length
+        bond::BT_LIST,                              // field 0
+        bond::BT_INT32 | (3 << 5),                  // 2 items
+        0x09,                                       // length of packed blocks
+        0x00, 0x00, 65, 0x00,                       // first, min, width and bits
+        bond::BT_STOP
+    };
+
+    BOOST_CHECK_THROW(
+        (Deserialize<std::vector<int32_t> >(bond::blob(data, sizeof(data)), bond::v3)),
+        bond::StreamException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -0,0 +1,248 @@
+#include "precompiled.h"
+#include "records.h"
+
+#include <bond/ext/record_container.h>
+#ifdef BOND_TEST_ZLIB
+#include <bond/ext/zlib_codec.h>
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(RecordContainerTests)
+
+template <typename Writer = bond::CompactBinaryWriter<bond::OutputBuffer> >
+static bond::blob WriteRecords(uint32_t count, const bond::ext::block_codec* codec = nullptr, uint32_t block_size = 1024)
+{
+    bond::OutputBuffer output;
+    bond::ext::record_container_writer<bond::OutputBuffer, Writer> writer(output, codec, block_size);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        writer.write(MakeRecord(i));
+    }
+
+    writer.close();
+    return output.GetBuffer();
+}
+
+template <typename Reader>
+static void CheckRecords(Reader& reader, uint32_t first, uint32_t count)
+{
+    bond::bonded<Record> record;
+    uint32_t i = first;
+
+    for (; reader.read(record); ++i)
+    {
+        BOOST_CHECK(record.Deserialize() == MakeRecord(i));
+    }
+
+    BOOST_CHECK_EQUAL(i, count);
+}
+
+static std::vector<char> Roundtrip(const bond::ext::block_codec& codec, const std::vector<char>& data)
+{
+    std::vector<char> compressed(codec.max_compressed_length(static_cast<uint32_t>(data.size())));
+    compressed.resize(codec.compress(data.data(), static_cast<uint32_t>(data.size()), compressed.data()));
+
+    std::vector<char> result(data.size());
+    codec.decompress(compressed.data(), static_cast<uint32_t>(compressed.size()), result.data(), static_cast<uint32_t>(result.size()));
+    return result;
+}
+
+
+BOOST_AUTO_TEST_CASE(LzCodecTest)
+{
+    const bond::ext::lz_codec codec;
+    std::mt19937 random(42);
+
+    for (uint32_t size : { 0, 1, 3, 4, 5, 15, 16, 17, 100, 300, 70000, 200000 })
+    {
+        std::vector<char> text, noise, run(size, 'a');
+
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            text.push_back("the quick brown fox jumps over the lazy dog "[(i * 7 + i / 100) % 44]);
+            noise.push_back(static_cast<char>(random()));
+        }
+
+        BOOST_CHECK(Roundtrip(codec, text) == text);
+        BOOST_CHECK(Roundtrip(codec, noise) == noise);
+        BOOST_CHECK(Roundtrip(codec, run) == run);
+    }
+
+    // Match beyond the start of the output
+    const char malformed[] = { 0x10, 'a', 0x02, 0x00 };
+    char output[5];
+
+    BOOST_CHECK_THROW(codec.decompress(malformed, sizeof(malformed), output, sizeof(output)), bond::StreamException);
+}
+
+
+BOOST_AUTO_TEST_CASE(RoundtripTest)
+{
+    for (uint32_t count : { 0, 1, 10, 1000 })
+    {
+        const bond::blob data = WriteRecords(count);
+
+        bond::ext::record_container_reader<> reader(data);
+        BOOST_CHECK_EQUAL(reader.record_count(), count);
+        CheckRecords(reader, 0, count);
+
+        bond::ext::record_container_reader<ThreadPerTask> parallel(data, ThreadPerTask(), 3);
+        CheckRecords(parallel, 0, count);
+    }
+
+    // Records are marshaled, so each container can use a different protocol
+    const bond::blob data = WriteRecords<bond::FastBinaryWriter<bond::OutputBuffer> >(100);
+    bond::ext::record_container_reader<> reader(data);
+    CheckRecords(reader, 0, 100);
+}
+
+
+BOOST_AUTO_TEST_CASE(BlocksTest)
+{
+    const bond::blob data = WriteRecords(1000);
+    const bond::blob one_block = WriteRecords(1000, nullptr, 1 << 20);
+
+    bond::ext::record_container_reader<> reader(data);
+
+    BOOST_CHECK_GT(reader.block_count(), 10u);
+    BOOST_CHECK_EQUAL(bond::ext::record_container_reader<>(one_block).block_count(), 1u);
+
+    // Records compress well since they have a lot in common
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output);
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        bond::Marshal(MakeRecord(i), writer);
+    }
+
+    BOOST_CHECK_LT(data.length() * 2, output.GetBuffer().length());
+    BOOST_CHECK_LT(one_block.length() * 4, output.GetBuffer().length());
+
+    // Reading can continue from any block
+    reader.seek(5);
+
+    bond::bonded<Record> record;
+    BOOST_REQUIRE(reader.read(record));
+
+    uint32_t first = 0;
+
+    while (!(record.Deserialize() == MakeRecord(first)))
+    {
+        ++first;
+    }
+
+    CheckRecords(reader, first + 1, 1000);
+}
+
+
+BOOST_AUTO_TEST_CASE(StoredBlocksTest)
+{
+    // Blocks which don't compress are stored
+    std::mt19937 random(7);
+    std::string noise;
+
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        noise.push_back(static_cast<char>(random()));
+    }
+
+    bond::OutputBuffer output;
+    bond::ext::record_container_writer<bond::OutputBuffer> writer(output);
+
+    writer.write(bond::make_box(noise));
+    writer.close();
+
+    const bond::blob data = output.GetBuffer();
+    BOOST_CHECK_EQUAL(data.content()[0], 0);
+
+    bond::ext::record_container_reader<> reader(data);
+    bond::bonded<bond::Box<std::string> > record;
+
+    BOOST_REQUIRE(reader.read(record));
+    BOOST_CHECK(record.Deserialize().value == noise);
+}
+
+
+BOOST_AUTO_TEST_CASE(CorruptionTest)
+{
+    const bond::blob data = WriteRecords(100);
+    bond::bonded<Record> record;
+
+    // Flipped bit in the data of the first block
+    boost::shared_ptr<char[]> corrupted = boost::make_shared_noinit<char[]>(data.length());
+    std::memcpy(corrupted.get(), data.content(), data.length());
+    corrupted[30] ^= 0x10;
+
+    bond::ext::record_container_reader<ThreadPerTask> reader(bond::blob(corrupted, data.length()));
+    BOOST_CHECK_THROW(reader.read(record), bond::StreamException);
+
+    // Truncated container
+    BOOST_CHECK_THROW(bond::ext::record_container_reader<>(data.range(0, data.length() - 1)), bond::StreamException);
+
+    // Index offset past the end of the container, which wraps around to the
+    // footer when the length of the index is added to it
+    const uint32_t count = 0xffffffff;
+    const uint64_t offset = data.length() - 16 - static_cast<uint64_t>(count) * 12;
+
+    boost::shared_ptr<char[]> footer = boost::make_shared_noinit<char[]>(data.length());
+    std::memcpy(footer.get(), data.content(), data.length());
+    std::memcpy(footer.get() + data.length() - 16, &offset, sizeof(offset));
+    std::memcpy(footer.get() + data.length() - 8, &count, sizeof(count));
+
+    BOOST_CHECK_THROW(bond::ext::record_container_reader<>(bond::blob(footer, data.length())), bond::StreamException);
+
+    // Block offset which wraps around to the start of the container when
+    // the length of the block header is added to it
+    uint64_t index_offset;
+    std::memcpy(&index_offset, data.content() + data.length() - 16, sizeof(index_offset));
+
+    const uint64_t block_offset = 0xfffffffffffffff0;
+
+    boost::shared_ptr<char[]> index = boost::make_shared_noinit<char[]>(data.length());
+    std::memcpy(index.get(), data.content(), data.length());
+    std::memcpy(index.get() + index_offset, &block_offset, sizeof(block_offset));
+
+    BOOST_CHECK_THROW(bond::ext::record_container_reader<>(bond::blob(index, data.length())), bond::StreamException);
+
+    // Codec which the reader doesn't know
+    struct TestCodec : bond::ext::lz_codec
+    {
+        uint8_t id() const override
+        {
+            return 42;
+        }
+    } codec;
+
+    const bond::blob custom = WriteRecords(100, &codec);
+
+    BOOST_CHECK_THROW(bond::ext::record_container_reader<>(custom).read(record), bond::StreamException);
+
+    bond::ext::record_container_reader<> known(custom, {}, 4, { &codec });
+    CheckRecords(known, 0, 100);
+}
+
+
+#ifdef BOND_TEST_ZLIB
+BOOST_AUTO_TEST_CASE(ZlibCodecTest)
+{
+    const bond::ext::zlib_codec codec;
+    const bond::blob data = WriteRecords(1000, &codec);
+
+    BOOST_CHECK_LT(data.length(), WriteRecords(1000).length());
+
+    bond::ext::record_container_reader<ThreadPerTask> reader(data, ThreadPerTask(), 4, { &codec });
+    CheckRecords(reader, 0, 1000);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -0,0 +1,132 @@
+#include "precompiled.h"
+#include "records.h"
+
+#include <bond/ext/record_file.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(RecordFileTests)
+
+static bond::blob WriteRecords(uint32_t count, uint16_t version = bond::v2)
+{
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output, version);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        bond::Serialize(MakeRecord(i), writer);
+    }
+
+    return output.GetBuffer();
+}
+
+static void CheckRecords(const std::vector<Record>& records, uint32_t count)
+{
+    BOOST_REQUIRE_EQUAL(records.size(), count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        BOOST_CHECK(records[i] == MakeRecord(i));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(IndexTest)
+{
+    for (uint32_t count : { 0, 1, 1000 })
+    {
+        const bond::blob data = WriteRecords(count);
+        const std::vector<uint32_t> index = bond::ext::index_records(data);
+
+        BOOST_REQUIRE_EQUAL(index.size(), count + 1);
+        BOOST_CHECK_EQUAL(index.front(), 0u);
+        BOOST_CHECK_EQUAL(index.back(), data.length());
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Record record;
+            bond::Deserialize(
+                bond::CompactBinaryReader<bond::InputBuffer>(data.range(index[i], index[i + 1] - index[i]), bond::v2),
+                record);
+
+            BOOST_CHECK(record == MakeRecord(i));
+        }
+
+        // The index stored next to the file is much smaller than the file
+        bond::OutputBuffer output;
+        bond::ext::write_record_index(output, index);
+
+        const bond::blob sidecar = output.GetBuffer();
+
+        BOOST_CHECK(bond::ext::read_record_index(sidecar) == index);
+        BOOST_CHECK_LE(sidecar.length(), 8 + count * 2);
+    }
+
+    // Truncated last record
+    const bond::blob data = WriteRecords(10);
+    BOOST_CHECK_THROW(bond::ext::index_records(data.range(0, data.length() - 1)), bond::StreamException);
+}
+
+
+BOOST_AUTO_TEST_CASE(ParallelTest)
+{
+    const uint32_t count = 1000;
+    const bond::blob data = WriteRecords(count);
+    const std::vector<uint32_t> index = bond::ext::index_records(data);
+    std::vector<Record> records;
+
+    bond::ext::deserialize_records(data, index, records);
+    CheckRecords(records, count);
+
+    for (uint32_t slices : { 0, 1, 2, 3, 7, 16, 2000 })
+    {
+        bond::ext::deserialize_records(data, index, records, ThreadPerTask(), slices);
+        CheckRecords(records, count);
+    }
+
+    // Records of Compact Binary v3
+    const bond::blob v3 = WriteRecords(count, bond::v3);
+
+    bond::ext::deserialize_records(v3, bond::ext::index_records(v3), records, ThreadPerTask(), 4, bond::v3);
+    CheckRecords(records, count);
+
+    // Empty file
+    bond::ext::deserialize_records(bond::blob(), bond::ext::index_records(bond::blob()), records, ThreadPerTask(), 4);
+    BOOST_CHECK(records.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(MalformedTest)
+{
+    const bond::blob data = WriteRecords(100);
+    std::vector<uint32_t> index = bond::ext::index_records(data);
+    std::vector<Record> records;
+
+    // Index of a longer file
+    BOOST_CHECK_THROW(
+        bond::ext::deserialize_records(data.range(0, index[99]), index, records, ThreadPerTask(), 4),
+        bond::StreamException);
+
+    // Offsets out of order
+    std::swap(index[10], index[11]);
+
+    BOOST_CHECK_THROW(
+        bond::ext::deserialize_records(data, index, records, ThreadPerTask(), 4),
+        bond::StreamException);
+
+    // Record boundaries which don't match the file; the exception is
+    // propagated after all the slices complete
+    std::swap(index[10], index[11]);
+    ++index[90];
+
+    BOOST_CHECK_THROW(
+        bond::ext::deserialize_records(data, index, records, ThreadPerTask(), 4),
+        bond::StreamException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -0,0 +1,310 @@
+#include "precompiled.h"
+
+#include <bond/core/box.h>
+#include <bond/core/record_stream.h>
+#include <bond/core/string_ref.h>
+#include <bond/core/tuple.h>
+
+#include <string_ref_test_reflection.h>
+
+#ifdef _MSC_VER
+#pragma warning (push)
+#pragma warning (disable: 4100)
+#endif
+#include <boost/thread.hpp>
+#include <boost/thread/scoped_thread.hpp>
+#ifdef _MSC_VER
+#pragma warning (pop)
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(RecordStreamTests)
+
+typedef bond::RecordWriter<bond::OutputBuffer> Writer;
+typedef bond::RecordReader<bond::InputBuffer> Reader;
+typedef bond::Box<std::vector<std::string> > Names;
+
+using string_ref_test::Record;
+
+static Names MakeNames(uint32_t i)
+{
+    Names names;
+
+    names.value.push_back("host " + std::to_string(i % 3));
+    names.value.push_back("a name that is longer than the small string optimization");
+    names.value.push_back("");
+    names.value.push_back("name " + std::to_string(i));
+    names.value.push_back("host " + std::to_string(i % 3));
+
+    return names;
+}
+
+static Record MakeRecord(uint32_t i)
+{
+    Record record;
+
+    record.title = "title";
+    record.words = { "alpha", "beta", i % 2 ? "alpha" : "gamma" };
+    record.counts = { { "alpha", i }, { "delta", 2 } };
+    record.tags = { "beta" };
+    record.note.set() = "title";
+    record.wide = L"wide";
+    record.nested.name = "nested";
+    record.nested.items = { "alpha", "nested" };
+    record.children.resize(2);
+    record.children.front().name = "beta";
+
+    return record;
+}
+
+static bond::blob WriteNames(uint32_t count, uint32_t max_strings, uint16_t version = bond::v2)
+{
+    bond::OutputBuffer output;
+    Writer writer(output, max_strings, version);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        writer.Write(MakeNames(i));
+    }
+
+    return output.GetBuffer();
+}
+
+static void CheckNames(const bond::blob& data, uint32_t count, uint16_t version = bond::v2)
+{
+    Reader reader(data, version);
+    Names names;
+    uint32_t i = 0;
+
+    for (; reader.Read(names); ++i)
+    {
+        BOOST_CHECK(names.value == MakeNames(i).value);
+    }
+
+    BOOST_CHECK_EQUAL(i, count);
+}
+
+
+BOOST_AUTO_TEST_CASE(RoundtripTest)
+{
+    for (uint32_t count : { 0, 1, 2, 100 })
+    {
+        CheckNames(WriteNames(count, bond::record_stream_max_strings), count);
+        CheckNames(WriteNames(count, bond::record_stream_max_strings, bond::v3), count, bond::v3);
+    }
+
+    // Strings beyond the maximum are written in the records
+    for (uint32_t max_strings : { 0, 1, 2, 5 })
+    {
+        CheckNames(WriteNames(50, max_strings), 50);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(SizeTest)
+{
+    const bond::blob records = WriteNames(100, bond::record_stream_max_strings);
+
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output, bond::v2);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        bond::Serialize(MakeNames(i), writer);
+    }
+
+    BOOST_CHECK_LT(records.length() * 2, output.GetBuffer().length());
+
+    // Only the unique strings are defined when the dictionary is not full
+    BOOST_CHECK_GT(WriteNames(100, 5).length(), records.length());
+}
+
+
+BOOST_AUTO_TEST_CASE(ResetTest)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    std::vector<uint32_t> offsets;
+
+    for (uint32_t i = 0; i < 30; ++i)
+    {
+        if (i % 10 == 0)
+        {
+            writer.Reset();
+        }
+
+        offsets.push_back(output.GetBuffer().length());
+        writer.Write(MakeNames(i));
+    }
+
+    const bond::blob data = output.GetBuffer();
+
+    // Reading can start at any reset point
+    for (uint32_t start : { 0, 10, 20 })
+    {
+        Reader reader(data.range(offsets[start]));
+        Names names;
+        uint32_t i = start;
+
+        for (; reader.Read(names); ++i)
+        {
+            BOOST_CHECK(names.value == MakeNames(i).value);
+        }
+
+        BOOST_CHECK_EQUAL(i, 30u);
+    }
+
+    // References to strings defined before the start are detected
+    Names names;
+
+    BOOST_CHECK_THROW(Reader(data.range(offsets[11])).Read(names), bond::StreamException);
+}
+
+
+BOOST_AUTO_TEST_CASE(StringRefTest)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        writer.Write(MakeRecord(i));
+    }
+
+    Reader reader(output.GetBuffer());
+    std::vector<Record> records(10);
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        BOOST_REQUIRE(reader.Read(records[i]));
+        BOOST_CHECK(records[i] == MakeRecord(i));
+    }
+
+    BOOST_CHECK(!reader.Read(records[0]));
+
+    // Every occurrence of a string references the same data
+    const char* alpha = records[0].words[0].data();
+
+    BOOST_CHECK_EQUAL(records[9].words[0].data(), alpha);
+    BOOST_CHECK_EQUAL(records[9].words[2].data(), alpha);
+    BOOST_CHECK_EQUAL(records[5].counts.begin()->first.data(), alpha);
+    BOOST_CHECK_EQUAL(records[3].nested.items[0].data(), alpha);
+    BOOST_CHECK_EQUAL(records[7].note.value().data(), records[0].title.data());
+}
+
+
+BOOST_AUTO_TEST_CASE(BondedTest)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        if (i == 10)
+        {
+            writer.Reset();
+        }
+
+        writer.Write(MakeRecord(i));
+    }
+
+    Reader reader(output.GetBuffer());
+    std::vector<bond::bonded<Record> > records(20);
+
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        BOOST_REQUIRE(reader.Read(records[i]));
+    }
+
+    // Records are deserialized after the following records and reset points are read
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        BOOST_CHECK(records[i].Deserialize() == MakeRecord(i));
+    }
+
+    // Records are transcoded rather than copied to other streams
+    bond::OutputBuffer other;
+    bond::CompactBinaryWriter<bond::OutputBuffer> compact(other, bond::v2);
+    bond::Serialize(records[15], compact);
+
+    BOOST_CHECK(bond::Deserialize<Record>(bond::CompactBinaryReader<bond::InputBuffer>(other.GetBuffer(), bond::v2))
+        == MakeRecord(15));
+
+    bond::OutputBuffer copy;
+    Writer copy_writer(copy);
+    copy_writer.Write(records[15]);
+    copy_writer.Write(records[4]);
+
+    Reader copy_reader(copy.GetBuffer());
+    Record record;
+
+    BOOST_REQUIRE(copy_reader.Read(record));
+    BOOST_CHECK(record == MakeRecord(15));
+    BOOST_REQUIRE(copy_reader.Read(record));
+    BOOST_CHECK(record == MakeRecord(4));
+}
+
+
+BOOST_AUTO_TEST_CASE(BondedThreadTest)
+{
+    const uint32_t count = 50;
+    const bond::blob data = WriteNames(count, bond::record_stream_max_strings);
+
+    Reader reader(data);
+    std::vector<bond::bonded<Names> > records(count);
+    std::vector<Names> names(count);
+
+    {
+        std::vector<boost::scoped_thread<> > threads;
+
+        // Each record defines a string, which the reader adds while the
+        // preceding records are deserialized
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            BOOST_REQUIRE(reader.Read(records[i]));
+
+            threads.emplace_back([&records, &names, i]
+            {
+                records[i].Deserialize(names[i]);
+            });
+        }
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        BOOST_CHECK(names[i].value == MakeNames(i).value);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(SkipTest)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+
+    // Strings of skipped fields are defined by the records
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        writer.Write(std::make_tuple(std::string("first"), MakeNames(i).value, std::string("host 1")));
+        writer.Write(bond::make_box(std::string("host 1")));
+    }
+
+    Reader reader(output.GetBuffer());
+    bond::Box<std::string> box;
+    uint32_t count = 0;
+
+    while (reader.Read(box))
+    {
+        BOOST_CHECK_EQUAL(box.value, count++ % 2 ? "host 1" : "first");
+    }
+
+    BOOST_CHECK_EQUAL(count, 20u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <bond/core/box.h>
+
+#include <string>
+
+// Records of the record container and record file tests, of lengths up to a
+// few hundred bytes so that their length prefixes take one or two bytes.
+typedef bond::Box<std::string> Record;
+
+inline Record MakeRecord(uint32_t i)
+{
+    return bond::make_box("record " + std::to_string(i) + std::string(i % 300, 'x'));
+}
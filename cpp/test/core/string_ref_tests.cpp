@@ -0,0 +1,202 @@
+#include "precompiled.h"
+
+#include <bond/core/string_ref.h>
+#include <bond/protocol/simple_json_reader.h>
+#include <bond/protocol/simple_json_writer.h>
+
+#include <string_ref_test_reflection.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(StringRefTests)
+
+using string_ref_test::Nested;
+using string_ref_test::Record;
+
+static Record MakeRecord()
+{
+    Record record;
+
+    record.title = "a title that is longer than the small string optimization";
+    record.with_default = "another value";
+    record.words = { "alpha", "beta", "gamma" };
+    record.counts = { { "one", 1 }, { "two", 2 } };
+    record.tags = { "x", "y" };
+    record.note.set() = "a note";
+    record.wide = L"wide";
+    record.nested.name = "nested";
+    record.nested.items = { "first", "second" };
+    record.children.resize(2);
+    record.children.front().name = "child";
+
+    return record;
+}
+
+static bool IsIn(const bond::string_ref& str, const bond::blob& buffer)
+{
+    return str.data() >= buffer.content()
+        && str.data() + str.length() <= buffer.content() + buffer.length();
+}
+
+// Copies the blob into a buffer owned by the blob.
+static bond::blob Owned(const bond::blob& from)
+{
+    return bond::blob_prolong(bond::blob(from.content(), from.length()));
+}
+
+typedef boost::mpl::list<
+    std::pair<bond::CompactBinaryReader<bond::InputBuffer>, bond::CompactBinaryWriter<bond::OutputBuffer> >,
+    std::pair<bond::FastBinaryReader<bond::InputBuffer>, bond::FastBinaryWriter<bond::OutputBuffer> >,
+    std::pair<bond::SimpleBinaryReader<bond::InputBuffer>, bond::SimpleBinaryWriter<bond::OutputBuffer> >
+> binary_protocols;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ReferenceInputTest, Protocols, binary_protocols)
+{
+    typedef typename Protocols::first_type Reader;
+    typedef typename Protocols::second_type Writer;
+
+    const Record from = MakeRecord();
+
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(from, writer);
+
+    const bond::blob payload = Owned(output.GetBuffer());
+
+    Record to;
+    bond::Deserialize(Reader(payload), to);
+
+    BOOST_CHECK((from == to));
+
+    BOOST_CHECK(IsIn(to.title, payload));
+    BOOST_CHECK(IsIn(to.with_default, payload));
+    BOOST_CHECK(IsIn(to.words.back(), payload));
+    BOOST_CHECK(IsIn(to.counts.begin()->first, payload));
+    BOOST_CHECK(IsIn(*to.tags.begin(), payload));
+    BOOST_CHECK(IsIn(to.note.value(), payload));
+    BOOST_CHECK(IsIn(to.nested.items.front(), payload));
+    BOOST_CHECK(IsIn(to.children.front().name, payload));
+
+    // Serializing the deserialized struct produces the same payload.
+    bond::OutputBuffer output2;
+    Writer writer2(output2);
+    bond::Serialize(to, writer2);
+
+    BOOST_CHECK(output2.GetBuffer() == payload);
+}
+
+BOOST_AUTO_TEST_CASE(KeepInputAliveTest)
+{
+    Record to;
+
+    {
+        bond::OutputBuffer output;
+        bond::CompactBinaryWriter<bond::OutputBuffer> writer(output);
+        bond::Serialize(MakeRecord(), writer);
+
+        const bond::blob payload = Owned(output.GetBuffer());
+        bond::Deserialize(bond::CompactBinaryReader<bond::InputBuffer>(payload), to);
+    }
+
+    BOOST_CHECK((MakeRecord() == to));
+    BOOST_CHECK_EQUAL(to.title.str(), "a title that is longer than the small string optimization");
+}
+
+BOOST_AUTO_TEST_CASE(RuntimeSchemaTest)
+{
+    const Record from = MakeRecord();
+
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output);
+    bond::Serialize(from, writer);
+
+    const bond::blob payload = Owned(output.GetBuffer());
+
+    bond::bonded<void> bonded(bond::CompactBinaryReader<bond::InputBuffer>(payload), bond::GetRuntimeSchema<Record>());
+
+    Record to;
+    bonded.Deserialize(to);
+
+    BOOST_CHECK((from == to));
+    BOOST_CHECK(IsIn(to.title, payload));
+    BOOST_CHECK(IsIn(to.words.front(), payload));
+}
+
+BOOST_AUTO_TEST_CASE(JsonTest)
+{
+    const Record from = MakeRecord();
+
+    bond::OutputBuffer output;
+    bond::SimpleJsonWriter<bond::OutputBuffer> writer(output);
+    bond::Serialize(from, writer);
+
+    const std::string json(output.GetBuffer().content(), output.GetBuffer().length());
+
+    Record to;
+    bond::SimpleJsonReader<bond::InputBuffer> reader(bond::blob(json.data(), static_cast<uint32_t>(json.size())));
+    bond::Deserialize(reader, to);
+
+    BOOST_CHECK((from == to));
+}
+
+BOOST_AUTO_TEST_CASE(DefaultValueTest)
+{
+    Record record;
+
+    BOOST_CHECK_EQUAL(record.with_default.str(), "default value");
+    BOOST_CHECK(record.title.empty());
+
+    const bond::RuntimeSchema schema = bond::GetRuntimeSchema<Record>();
+    BOOST_CHECK_EQUAL(schema.GetStruct().fields[1].metadata.default_value.string_value, "default value");
+}
+
+BOOST_AUTO_TEST_CASE(EmptyStringTest)
+{
+    bond::string_ref str("abc");
+
+    bond::resize_string(str, 0);
+    BOOST_CHECK(str.empty());
+    BOOST_CHECK(bond::string_data(str) != nullptr);
+    BOOST_CHECK(bond::string_data(static_cast<const bond::string_ref&>(str)) != nullptr);
+
+    Record from = MakeRecord();
+    from.title = bond::string_ref();
+
+    bond::OutputBuffer output;
+    bond::SimpleJsonWriter<bond::OutputBuffer> writer(output);
+    bond::Serialize(from, writer);
+
+    Record to;
+    bond::SimpleJsonReader<bond::InputBuffer> reader(output.GetBuffer());
+    bond::Deserialize(reader, to);
+
+    BOOST_CHECK(to.title.empty());
+    BOOST_CHECK((from == to));
+}
+
+BOOST_AUTO_TEST_CASE(CompareTest)
+{
+    const char text[] = "abcabd";
+
+    const bond::string_ref abc(text, 3);
+    const bond::string_ref abd(text + 3, 3);
+    const bond::string_ref ab(text, 2);
+    const bond::string_ref empty;
+
+    BOOST_CHECK((abc == "abc"));
+    BOOST_CHECK((abc != abd));
+    BOOST_CHECK((abc < abd));
+    BOOST_CHECK((ab < abc));
+    BOOST_CHECK((empty < ab));
+    BOOST_CHECK((empty == ""));
+    BOOST_CHECK((abd >= abc));
+    BOOST_CHECK_EQUAL(abc.compare(abc), 0);
+    BOOST_CHECK(abc.data() == text);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -20,6 +20,10 @@ using bond::string_length;
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 
+#include <memory>
+#include <thread>
+#include <vector>
+
 using namespace std;
 using boost::mpl::_;
 
@@ -133,6 +137,33 @@ const std::vector<T>& IntegerConstants()
 }
 
 
+// Runs each callback on a new thread, joined when the last copy of the pool
+// is destroyed.
+class ThreadPerTask
+{
+    struct Threads : std::vector<std::thread>
+    {
+        ~Threads()
+        {
+            for (std::thread& thread : *this)
+            {
+                thread.join();
+            }
+        }
+    };
+
+public:
+    template <typename Callback>
+    void operator()(Callback&& callback)
+    {
+        _threads->emplace_back(std::forward<Callback>(callback));
+    }
+
+private:
+    std::shared_ptr<Threads> _threads = std::make_shared<Threads>();
+};
+
+
 // CreateSelfMappings creates mappings compatible with MapTo<T> transform
 // for every field of the specified bond structure.
 template <typename Protocols>
@@ -238,6 +269,16 @@ struct Factory<bond::CompactBinaryReader<Buffer> >
 };
 
 
+template <typename Buffer>
+struct Factory<bond::FastBinaryReader<Buffer> >
+{
+    static bond::FastBinaryReader<Buffer> Create(Buffer& buffer, uint16_t version)
+    {
+        return bond::FastBinaryReader<Buffer>(buffer, version);
+    }
+};
+
+
 template <typename Buffer>
 struct Factory<bond::SimpleJsonWriter<Buffer> >
 {
@@ -271,6 +312,17 @@ struct Factory<bond::CompactBinaryWriter<Buffer> >
 };
 
 
+template <typename Buffer>
+struct Factory<bond::FastBinaryWriter<Buffer> >
+{
+    static void Call(Buffer& buffer, uint16_t version, boost::function<void (bond::FastBinaryWriter<Buffer>&)> func)
+    {
+        bond::FastBinaryWriter<Buffer> writer(buffer, version);
+        return func(writer);
+    }
+};
+
+
 template <typename Reader, typename Writer, typename Protocols = bond::BuiltInProtocols, typename T>
 Reader Serialize(const T& x, uint16_t version = bond::v1)
 {
@@ -513,6 +565,25 @@ void Mapping(const From& from, uint16_t version = bond::v1)
 
         UT_Equal_P(from, to, Protocols);
     }
+
+    // Compiled mappings
+    {
+        const bond::CompiledMappings compiled(mappings);
+
+        bond::bonded<BondedType> bonded(GetBonded<Reader, Writer, BondedType, Protocols>(from, version));
+
+        To to;
+
+        if (boost::mpl::count_if<From::Schema::fields, is_optional_field<_> >::value == 0)
+        {
+            to = InitRandom<To, Protocols>();
+            Fixup(to);
+        }
+
+        bond::Apply<Protocols>(bond::MapTo<To, Protocols>(to, compiled), bonded);
+
+        UT_Equal_P(from, to, Protocols);
+    }
 #else
     (void)from;
     (void)version;
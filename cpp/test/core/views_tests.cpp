@@ -0,0 +1,164 @@
+#include "precompiled.h"
+
+#include <bond/protocol/indexed_binary_view.h>
+
+#include <views_test_views.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(ViewsTests)
+
+using views_test::Base;
+using views_test::Nested;
+using views_test::Record;
+using views_test::NestedView;
+using views_test::BaseView;
+using views_test::RecordView;
+
+static const char payload_bytes[] = "xyz";
+
+static Record MakeRecord()
+{
+    Nested child;
+    child.name = "child";
+    child.values = { 1, 2, 3 };
+
+    Record record;
+
+    static_cast<Base&>(record).id = 42;
+    record.key = "key";
+    record.count = 3;
+    record.title = "title";
+    record.wide = L"wide";
+    record.color = views_test::Blue;
+    record.payload = bond::blob(payload_bytes, 3);
+    record.tags = { "a", "bb" };
+    record.children["c"] = child;
+    record.parent.set() = child;
+    record.matrix = { { 1, 2 }, {}, { 3 } };
+    record.nested.name = "nested";
+    record.lazy = bond::bonded<Nested>(child);
+    record.ids = { 5, 6 };
+    record.id = -1;
+
+    return record;
+}
+
+static bond::blob Serialize(const Record& record)
+{
+    bond::OutputBuffer output;
+    bond::IndexedBinaryWriter<bond::OutputBuffer> writer(output);
+    bond::Serialize(record, writer);
+
+    return output.GetBuffer();
+}
+
+static bool IsIn(const char* data, const bond::blob& buffer)
+{
+    return data >= buffer.content() && data < buffer.content() + buffer.length();
+}
+
+BOOST_AUTO_TEST_CASE(BasicFieldsTest)
+{
+    const bond::blob payload = Serialize(MakeRecord());
+    const RecordView view(payload);
+
+    // Field with the same name in the base struct
+    BOOST_CHECK_EQUAL(view.BaseView::id(), 42u);
+    BOOST_CHECK_EQUAL(view.id(), -1);
+
+    BOOST_CHECK((view.key() == "key"));
+    BOOST_CHECK_EQUAL(view.count(), 3);
+    BOOST_CHECK((view.title() == "title"));
+    BOOST_CHECK(IsIn(view.title().data(), payload));
+    BOOST_CHECK(view.wide() == L"wide");
+    BOOST_CHECK_EQUAL(view.color(), views_test::Blue);
+    BOOST_CHECK(view.payload() == bond::blob(payload_bytes, 3));
+    BOOST_CHECK(IsIn(view.payload().content(), payload));
+    BOOST_CHECK_EQUAL(view.ratio(), 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(ContainersTest)
+{
+    const RecordView view(Serialize(MakeRecord()));
+
+    std::vector<std::string> tags;
+    for (const bond::string_ref& tag : view.tags())
+    {
+        tags.push_back(tag.str());
+    }
+
+    BOOST_CHECK_EQUAL(view.tags().size(), 2u);
+    BOOST_CHECK((tags == std::vector<std::string>{ "a", "bb" }));
+
+    const bond::list_view<int64_t> ids = view.ids();
+    BOOST_CHECK((std::vector<int64_t>(ids.begin(), ids.end()) == std::vector<int64_t>{ 5, 6 }));
+
+    std::vector<std::vector<uint16_t> > matrix;
+    for (const bond::list_view<uint16_t>& row : view.matrix())
+    {
+        matrix.push_back(std::vector<uint16_t>(row.begin(), row.end()));
+    }
+
+    BOOST_CHECK((matrix == std::vector<std::vector<uint16_t> >{ { 1, 2 }, {}, { 3 } }));
+
+    const bond::map_view<bond::string_ref, NestedView> children = view.children();
+    BOOST_REQUIRE_EQUAL(children.size(), 1u);
+    BOOST_CHECK((children.begin()->first == "c"));
+    BOOST_CHECK((children.begin()->second.name() == "child"));
+
+    const bond::list_view<int32_t> values = children.begin()->second.values();
+    BOOST_CHECK((std::vector<int32_t>(values.begin(), values.end()) == std::vector<int32_t>{ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(NestedStructsTest)
+{
+    const Record record = MakeRecord();
+    const RecordView view(Serialize(record));
+
+    BOOST_CHECK((view.nested().name() == "nested"));
+    BOOST_CHECK(view.nested().values().empty());
+    BOOST_CHECK((view.lazy().name() == "child"));
+
+    BOOST_REQUIRE(view.parent().hasvalue());
+    BOOST_CHECK((view.parent().value().name() == "child"));
+
+    Nested nested;
+    view.nested().Deserialize(nested);
+    BOOST_CHECK((nested == record.nested));
+
+    Record to;
+    view.Deserialize(to);
+    to.lazy = record.lazy;
+    BOOST_CHECK((to == record));
+}
+
+BOOST_AUTO_TEST_CASE(DefaultValuesTest)
+{
+    Record record;
+    record.lazy = bond::bonded<Nested>(Nested());
+
+    const RecordView view(Serialize(record));
+
+    BOOST_CHECK_EQUAL(view.count(), 7);
+    BOOST_CHECK((view.key() == "none"));
+    BOOST_CHECK_EQUAL(view.color(), views_test::Green);
+    BOOST_CHECK(view.title().empty());
+    BOOST_CHECK(view.tags().empty());
+    BOOST_CHECK(!view.parent().hasvalue());
+    BOOST_CHECK(view.nested().name().empty());
+
+    // Empty view of a struct missing from the payload
+    const RecordView empty;
+
+    BOOST_CHECK_EQUAL(empty.count(), 7);
+    BOOST_CHECK((empty.key() == "none"));
+    BOOST_CHECK(empty.children().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <bond/ext/grpc/admission_control.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+BOOST_AUTO_TEST_SUITE(AdmissionControlTests)
+
+using bond::ext::grpc::admission_control;
+using bond::ext::grpc::admission_options;
+
+static const auto no_deadline = (std::chrono::system_clock::time_point::max)();
+
+BOOST_AUTO_TEST_CASE(DefaultOptionsAdmitEverything)
+{
+    admission_control admission;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        BOOST_CHECK(admission.enter(no_deadline).ok());
+    }
+
+    BOOST_CHECK_EQUAL(admission.in_flight(), 100u);
+    BOOST_CHECK_EQUAL(admission.rejected(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrencyLimitRejectsExcessCalls)
+{
+    admission_options options;
+    options.max_concurrent_calls = 2;
+    admission_control admission{ options };
+
+    BOOST_CHECK(admission.enter(no_deadline).ok());
+    BOOST_CHECK(admission.enter(no_deadline).ok());
+
+    ::grpc::Status status = admission.enter(no_deadline);
+    BOOST_CHECK_EQUAL(status.error_code(), ::grpc::StatusCode::RESOURCE_EXHAUSTED);
+    BOOST_CHECK_EQUAL(admission.in_flight(), 2u);
+    BOOST_CHECK_EQUAL(admission.rejected(), 1u);
+
+    admission.leave();
+    BOOST_CHECK(admission.enter(no_deadline).ok());
+    BOOST_CHECK_EQUAL(admission.in_flight(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(ExpiredDeadlineIsDropped)
+{
+    admission_control admission;
+    const auto expired = std::chrono::system_clock::now() - std::chrono::seconds(1);
+
+    ::grpc::Status status = admission.enter(expired);
+    BOOST_CHECK_EQUAL(status.error_code(), ::grpc::StatusCode::DEADLINE_EXCEEDED);
+    BOOST_CHECK_EQUAL(admission.in_flight(), 0u);
+    BOOST_CHECK_EQUAL(admission.expired(), 1u);
+
+    BOOST_CHECK(admission.enter(std::chrono::system_clock::now() + std::chrono::minutes(1)).ok());
+}
+
+BOOST_AUTO_TEST_CASE(ExpiredDeadlineIsKeptWhenDisabled)
+{
+    admission_options options;
+    options.drop_expired_calls = false;
+    admission_control admission{ options };
+
+    BOOST_CHECK(admission.enter(std::chrono::system_clock::now() - std::chrono::seconds(1)).ok());
+    BOOST_CHECK_EQUAL(admission.expired(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(QueueDelayLimitRejectsStaleCalls)
+{
+    admission_options options;
+    options.max_queue_delay = std::chrono::milliseconds(100);
+    admission_control admission{ options };
+
+    const auto now = admission_control::clock::now();
+
+    BOOST_CHECK(admission.dequeue(no_deadline, now).ok());
+
+    ::grpc::Status status = admission.dequeue(no_deadline, now - std::chrono::seconds(1));
+    BOOST_CHECK_EQUAL(status.error_code(), ::grpc::StatusCode::RESOURCE_EXHAUSTED);
+    BOOST_CHECK_EQUAL(admission.rejected(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(DeadlineExpiredWhileQueuedIsDropped)
+{
+    admission_control admission;
+
+    ::grpc::Status status = admission.dequeue(
+        std::chrono::system_clock::now() - std::chrono::milliseconds(1),
+        admission_control::clock::now());
+
+    BOOST_CHECK_EQUAL(status.error_code(), ::grpc::StatusCode::DEADLINE_EXCEEDED);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
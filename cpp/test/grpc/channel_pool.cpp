@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <bond/ext/grpc/channel_pool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <set>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(ChannelPoolTests)
+
+using bond::ext::grpc::channel_pool;
+using bond::ext::grpc::channel_selection;
+
+static std::vector<std::shared_ptr<::grpc::ChannelInterface>> make_channels(size_t count)
+{
+    std::vector<std::shared_ptr<::grpc::ChannelInterface>> channels;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ::grpc::ChannelArguments args;
+        args.SetInt("bond.test.channel", static_cast<int>(i));
+
+        // Channels connect lazily, so nothing has to listen on this address.
+        channels.push_back(::grpc::CreateCustomChannel(
+            "127.0.0.1:1", ::grpc::InsecureChannelCredentials(), args));
+    }
+
+    return channels;
+}
+
+BOOST_AUTO_TEST_CASE(EmptyPoolThrows)
+{
+    BOOST_CHECK_THROW(
+        channel_pool{ std::vector<std::shared_ptr<::grpc::ChannelInterface>>{} },
+        bond::ext::grpc::InvalidChannelCount);
+}
+
+BOOST_AUTO_TEST_CASE(LeaseCountsOutstandingCalls)
+{
+    channel_pool pool{ make_channels(1) };
+
+    {
+        channel_pool::lease first = pool.acquire();
+        channel_pool::lease second = pool.acquire();
+
+        BOOST_CHECK(first);
+        BOOST_CHECK_EQUAL(first.index(), 0u);
+        BOOST_CHECK(first.channel() == pool.channel(0));
+        BOOST_CHECK_EQUAL(pool.outstanding(0), 2u);
+
+        channel_pool::lease moved = std::move(first);
+        BOOST_CHECK(!first);
+        BOOST_CHECK_EQUAL(pool.outstanding(0), 2u);
+
+        moved.reset();
+        BOOST_CHECK(!moved);
+        BOOST_CHECK_EQUAL(pool.outstanding(0), 1u);
+    }
+
+    BOOST_CHECK_EQUAL(pool.outstanding(0), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(LeastOutstandingBalancesCalls)
+{
+    channel_pool pool{ make_channels(4), channel_selection::least_outstanding };
+
+    std::vector<channel_pool::lease> leases;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        leases.push_back(pool.acquire());
+    }
+
+    for (size_t i = 0; i < pool.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(pool.outstanding(i), 2u);
+    }
+
+    // The next call goes to the channel that has just been freed up.
+    leases[5].reset();
+    const size_t freed = leases[5].index();
+
+    channel_pool::lease next = pool.acquire();
+    BOOST_CHECK_EQUAL(next.index(), freed);
+}
+
+BOOST_AUTO_TEST_CASE(PowerOfTwoChoicesUsesAllChannels)
+{
+    channel_pool pool{ make_channels(4), channel_selection::power_of_two_choices };
+
+    std::vector<channel_pool::lease> leases;
+    std::set<size_t> used;
+    for (size_t i = 0; i < 400; ++i)
+    {
+        leases.push_back(pool.acquire());
+        used.insert(leases.back().index());
+    }
+
+    BOOST_CHECK_EQUAL(used.size(), pool.size());
+
+    // Picking the less loaded of two channels keeps the load close to even.
+    for (size_t i = 0; i < pool.size(); ++i)
+    {
+        BOOST_CHECK_GE(pool.outstanding(i), 90u);
+        BOOST_CHECK_LE(pool.outstanding(i), 110u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CreateMakesDistinctChannels)
+{
+    auto pool = channel_pool::Create("127.0.0.1:1", ::grpc::InsecureChannelCredentials(), 3);
+
+    BOOST_REQUIRE_EQUAL(pool->size(), 3u);
+    BOOST_CHECK(pool->channel(0) != pool->channel(1));
+    BOOST_CHECK(pool->channel(1) != pool->channel(2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
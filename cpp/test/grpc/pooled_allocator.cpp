@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <bond/ext/grpc/detail/pooled_allocator.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(PooledAllocatorTests)
+
+using bond::ext::grpc::detail::pooled_allocator;
+
+struct block
+{
+    char data[200];
+};
+
+BOOST_AUTO_TEST_CASE(FreedBlocksAreReused)
+{
+    pooled_allocator<block> allocator;
+
+    block* first = allocator.allocate(1);
+    allocator.deallocate(first, 1);
+
+    block* second = allocator.allocate(1);
+    BOOST_CHECK_EQUAL(first, second);
+    allocator.deallocate(second, 1);
+}
+
+BOOST_AUTO_TEST_CASE(SimilarSizesShareBlocks)
+{
+    struct other_block
+    {
+        char data[220];
+    };
+
+    pooled_allocator<block> allocator;
+    pooled_allocator<other_block> otherAllocator{ allocator };
+
+    block* first = allocator.allocate(1);
+    allocator.deallocate(first, 1);
+
+    other_block* second = otherAllocator.allocate(1);
+    BOOST_CHECK_EQUAL(static_cast<void*>(first), static_cast<void*>(second));
+    otherAllocator.deallocate(second, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ArraysAreNotPooled)
+{
+    pooled_allocator<int> allocator;
+    std::vector<int, pooled_allocator<int>> values(1000, 42, allocator);
+
+    BOOST_CHECK_EQUAL(values.size(), 1000u);
+    BOOST_CHECK_EQUAL(values.back(), 42);
+}
+
+BOOST_AUTO_TEST_CASE(WorksWithSharedPtrAndPromise)
+{
+    std::shared_ptr<block> shared = std::allocate_shared<block>(pooled_allocator<block>{});
+    BOOST_CHECK(shared);
+
+    std::promise<int> promise{ std::allocator_arg, pooled_allocator<int>{} };
+    std::future<int> future = promise.get_future();
+    promise.set_value(7);
+    BOOST_CHECK_EQUAL(future.get(), 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
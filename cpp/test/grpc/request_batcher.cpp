@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <bond/core/box.h>
+#include <bond/ext/grpc/detail/serialization.h>
+#include <bond/ext/grpc/io_manager.h>
+#include <bond/ext/grpc/request_batcher.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(RequestBatcherTests)
+
+using batcher = bond::ext::grpc::request_batcher<bond::Box<int32_t>, bond::Box<int32_t>>;
+using batch_result = bond::ext::grpc::unary_call_result<batcher::batch_response>;
+using result = bond::ext::grpc::unary_call_result<bond::Box<int32_t>>;
+
+// Records the batches it is given and, unless told to fail, responds with
+// every request incremented by one.
+struct fake_service
+{
+    std::vector<size_t> batches;
+    ::grpc::Status status = ::grpc::Status::OK;
+
+    batcher::batch_dispatcher dispatcher()
+    {
+        return [this](const batcher::batch_request& request, const std::function<void(batch_result)>& cb)
+        {
+            batches.push_back(request.value.size());
+
+            // Round-trip the request as it would go over the wire.
+            const batcher::batch_request received = bond::ext::grpc::detail::Deserialize<batcher::batch_request>(
+                bond::ext::grpc::detail::Serialize(bond::bonded<batcher::batch_request>{ boost::ref(request) }))
+                .Deserialize();
+
+            batcher::batch_response response;
+            for (const auto& item : received.value)
+            {
+                bond::Box<int32_t> value = item.Deserialize();
+                ++value.value;
+                response.value.emplace_back(value);
+            }
+
+            cb(batch_result{
+                bond::ext::grpc::detail::Serialize(bond::bonded<batcher::batch_response>{ boost::ref(response) }),
+                status,
+                std::make_shared<::grpc::ClientContext>() });
+        };
+    }
+};
+
+static std::shared_ptr<bond::ext::grpc::io_manager> make_io_manager()
+{
+    return std::make_shared<bond::ext::grpc::io_manager>(1);
+}
+
+BOOST_AUTO_TEST_CASE(FullBatchIsSentRightAway)
+{
+    fake_service service;
+    bond::ext::grpc::batching_options options;
+    options.max_batch_size = 3;
+    options.max_delay = std::chrono::hours(1);
+
+    batcher b{ make_io_manager(), service.dispatcher(), options };
+
+    std::vector<int32_t> responses;
+    for (int32_t i = 0; i < 7; ++i)
+    {
+        b.Async(bond::make_box(i), [&responses](result r)
+        {
+            BOOST_CHECK(r.status().ok());
+            responses.push_back(r.response().Deserialize().value);
+        });
+    }
+
+    BOOST_CHECK_EQUAL(service.batches.size(), 2u);
+    BOOST_CHECK_EQUAL(b.pending(), 1u);
+
+    b.Flush();
+    BOOST_CHECK_EQUAL(b.pending(), 0u);
+
+    const std::vector<size_t> expectedBatches = { 3, 3, 1 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(service.batches.begin(), service.batches.end(), expectedBatches.begin(), expectedBatches.end());
+
+    const std::vector<int32_t> expectedResponses = { 1, 2, 3, 4, 5, 6, 7 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(responses.begin(), responses.end(), expectedResponses.begin(), expectedResponses.end());
+}
+
+BOOST_AUTO_TEST_CASE(PendingBatchIsSentAfterDelay)
+{
+    fake_service service;
+    bond::ext::grpc::batching_options options;
+    options.max_delay = std::chrono::milliseconds(10);
+
+    batcher b{ make_io_manager(), service.dispatcher(), options };
+
+    std::future<result> first = b.Async(bond::make_box(41));
+    std::future<result> second = b.Async(bond::make_box(1));
+
+    BOOST_REQUIRE(first.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    BOOST_CHECK_EQUAL(first.get().response().Deserialize().value, 42);
+    BOOST_CHECK_EQUAL(second.get().response().Deserialize().value, 2);
+    BOOST_CHECK_EQUAL(service.batches.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(ZeroDelaySendsEveryRequest)
+{
+    fake_service service;
+    bond::ext::grpc::batching_options options;
+    options.max_delay = std::chrono::steady_clock::duration::zero();
+
+    batcher b{ make_io_manager(), service.dispatcher(), options };
+
+    b.Async(bond::make_box(1), {});
+    b.Async(bond::make_box(2), {});
+
+    BOOST_CHECK_EQUAL(service.batches.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(FailedBatchFailsEveryRequest)
+{
+    fake_service service;
+    service.status = ::grpc::Status{ ::grpc::StatusCode::UNAVAILABLE, "unavailable" };
+
+    std::vector<std::future<result>> results;
+
+    {
+        batcher b{ make_io_manager(), service.dispatcher() };
+
+        results.push_back(b.Async(bond::make_box(1)));
+        results.push_back(b.Async(bond::make_box(2)));
+
+        // Pending requests are sent when the batcher is destroyed.
+    }
+
+    BOOST_CHECK_EQUAL(service.batches.size(), 1u);
+
+    for (auto& r : results)
+    {
+        try
+        {
+            r.get();
+            BOOST_ERROR("Expected an exception.");
+        }
+        catch (const bond::ext::grpc::UnaryCallException& ex)
+        {
+            BOOST_CHECK_EQUAL(ex.status().error_code(), ::grpc::StatusCode::UNAVAILABLE);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MissingResponsesAreReported)
+{
+    batcher b{
+        make_io_manager(),
+        [](const batcher::batch_request&, const std::function<void(batch_result)>& cb)
+        {
+            batcher::batch_response response;
+            response.value.emplace_back(bond::make_box(10));
+
+            cb(batch_result{
+                bond::ext::grpc::detail::Serialize(bond::bonded<batcher::batch_response>{ boost::ref(response) }),
+                ::grpc::Status::OK,
+                std::make_shared<::grpc::ClientContext>() });
+        } };
+
+    std::future<result> first = b.Async(bond::make_box(1));
+    std::future<result> second = b.Async(bond::make_box(2));
+    b.Flush();
+
+    BOOST_CHECK_EQUAL(first.get().response().Deserialize().value, 10);
+    BOOST_CHECK_THROW(second.get(), bond::ext::grpc::UnaryCallException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_unit_test()
+{
+    return true;
+}
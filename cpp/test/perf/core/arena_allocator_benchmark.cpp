@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Benchmark of deserializing into structs that allocate from an arena.
+//
+// Deserializes a large nested struct generated with the default allocator
+// and with bond::ext::arena_allocator, using both a new arena for every
+// struct and one arena that is reset between structs, as in a loop reading
+// a stream of records. Both allocators count their allocations through
+// counting_allocator.
+
+#include "arena_allocator_benchmark_reflection.h"
+#include "arena_allocator_benchmark_types.h"
+#include "arena/arena_allocator_benchmark_reflection.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/cmdargs.h>
+#include <bond/protocol/compact_binary.h>
+#include <bond/stream/output_buffer.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using Reader = bond::CompactBinaryReader<bond::InputBuffer>;
+using Writer = bond::CompactBinaryWriter<bond::OutputBuffer>;
+
+using arena_type = bond::ext::monotonic_arena<benchmark::counting_allocator<char> >;
+using allocator_type = bond::ext::arena_allocator<char, benchmark::counting_allocator<char> >;
+
+// The strings of the baseline struct use counting_allocator, so they are
+// assigned from C strings.
+static benchmark::Document MakeDocument()
+{
+    benchmark::Document document;
+
+    document.title.assign("a document with many small strings and containers");
+
+    for (uint64_t i = 0; i < 200; ++i)
+    {
+        const std::string suffix = std::to_string(i);
+
+        benchmark::Element element;
+        element.name.assign(("element with a long name " + suffix).c_str());
+
+        for (const char* name : { "class", "style", "identifier", "description" })
+        {
+            benchmark::Attribute attribute;
+            attribute.name.assign((std::string("attribute ") + name).c_str());
+            attribute.value.assign(("value of attribute " + suffix).c_str());
+            element.attributes.push_back(attribute);
+        }
+
+        element.text.emplace_back(("first paragraph of element " + suffix).c_str());
+        element.text.emplace_back(("second paragraph of element " + suffix).c_str());
+        element.counters.emplace(("characters in element " + suffix).c_str(), i * 100);
+        element.counters.emplace(("words in element " + suffix).c_str(), i * 10);
+
+        document.elements.push_back(element);
+    }
+
+    return document;
+}
+
+// Serializes the struct into a payload that is allocated from the arena too.
+static bool Matches(const benchmark_arena::Document& document, arena_type& arena, const bond::blob& expected)
+{
+    using Output = bond::OutputMemoryStream<allocator_type>;
+
+    Output output{ allocator_type(arena) };
+    bond::CompactBinaryWriter<Output> writer(output);
+    bond::Serialize(document, writer);
+
+    return output.GetBuffer() == expected;
+}
+
+static bool Matches(const benchmark::Document& document, const bond::blob& expected)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(document, writer);
+
+    return output.GetBuffer() == expected;
+}
+
+template <typename Deserialize>
+static bool Measure(const char* name, const bond::blob& payload, uint32_t iterations, Deserialize deserialize)
+{
+    if (!deserialize(payload, true))
+    {
+        std::cerr << name << ": deserialized struct doesn't match" << std::endl;
+        return false;
+    }
+
+    const std::size_t allocations = benchmark::allocation_count();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        deserialize(payload, false);
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << elapsed.count() / iterations << " ns and "
+              << static_cast<double>(benchmark::allocation_count() - allocations) / iterations
+              << " allocations per struct" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    benchmark::Options options;
+
+    try
+    {
+        options = bond::cmd::GetArgs<benchmark::Options>(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+        options.help = true;
+    }
+
+    if (options.help)
+    {
+        bond::cmd::ShowUsage<benchmark::Options>(argv[0]);
+        return 1;
+    }
+
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(MakeDocument(), writer);
+
+    const bond::blob payload = output.GetBuffer();
+
+    bool ok = true;
+
+    ok = Measure("std::allocator", payload, options.iterations,
+        [](const bond::blob& payload, bool check)
+        {
+            benchmark::Document document;
+            bond::Deserialize(Reader(payload), document);
+
+            return !check || Matches(document, payload);
+        }) && ok;
+
+    ok = Measure("arena_allocator, new arena", payload, options.iterations,
+        [](const bond::blob& payload, bool check)
+        {
+            arena_type arena;
+            benchmark_arena::Document document{ allocator_type(arena) };
+            bond::Deserialize(Reader(payload), document);
+
+            return !check || Matches(document, arena, payload);
+        }) && ok;
+
+    arena_type arena;
+
+    ok = Measure("arena_allocator, reset arena", payload, options.iterations,
+        [&arena](const bond::blob& payload, bool check)
+        {
+            arena.reset();
+
+            benchmark_arena::Document document{ allocator_type(arena) };
+            bond::Deserialize(Reader(payload), document);
+
+            return !check || Matches(document, arena, payload);
+        }) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace benchmark
+{
+    // Number of allocations made by all counting_allocator instances.
+    inline std::size_t& allocation_count()
+    {
+        static std::size_t count = 0;
+        return count;
+    }
+
+    // Allocator that forwards to std::allocator and counts allocations, so
+    // that the allocations made by generated types can be compared without
+    // replacing the global operator new.
+    template <typename T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        counting_allocator() = default;
+
+        template <typename U>
+        counting_allocator(const counting_allocator<U>&)
+        {}
+
+        T* allocate(std::size_t n)
+        {
+            ++allocation_count();
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* ptr, std::size_t n)
+        {
+            std::allocator<T>().deallocate(ptr, n);
+        }
+    };
+
+    template <typename T, typename U>
+    inline bool operator==(const counting_allocator<T>&, const counting_allocator<U>&)
+    {
+        return true;
+    }
+
+    template <typename T, typename U>
+    inline bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&)
+    {
+        return false;
+    }
+
+} // namespace benchmark
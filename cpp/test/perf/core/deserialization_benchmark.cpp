@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Benchmark of deserializing typical structs.
+//
+// Deserializes a record from Compact Binary and Fast Binary payloads written
+// for the same struct, as is almost always the case in practice, and from a
+// payload written by a newer version of the struct. Records are deserialized
+// both into new objects and into an existing object that is reused, as in a
+// loop reading a stream of records.
+
+#include "deserialization_benchmark_reflection.h"
+#include "deserialization_benchmark_types.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/cmdargs.h>
+#include <bond/protocol/compact_binary.h>
+#include <bond/protocol/fast_binary.h>
+#include <bond/stream/output_buffer.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace benchmark;
+
+static Record MakeRecord()
+{
+    Record record;
+
+    record.timestamp = 1530000000000;
+    record.severity = Warning;
+    record.source = "frontend-17";
+    record.message = "request took longer than expected to complete";
+    record.thread_id = 4711;
+    record.duration = 0.125;
+    record.success = true;
+    record.location.file = "request_handler.cpp";
+    record.location.line = 273;
+    record.location.function = "Handle";
+    record.counters = { 1, 12, 123, 1234, 12345, 123456 };
+    record.tags = { "http", "slow", "retried" };
+    record.properties = { { "method", "GET" }, { "status", "200" }, { "region", "west" } };
+    record.correlation_id = 0x123456789abcdef;
+
+    return record;
+}
+
+template <typename Writer, typename T>
+static bond::blob Serialize(const T& obj)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(obj, writer);
+
+    return output.GetBuffer();
+}
+
+template <typename Reader>
+static bool Measure(const char* name, const bond::blob& payload, bool existing, const Record& expected, uint32_t iterations)
+{
+    Record obj;
+
+    const auto deserialize = [&]
+    {
+        Reader reader(payload);
+
+        if (existing)
+        {
+            bond::bonded<Record, Reader&>(reader).DeserializeExisting(obj);
+        }
+        else
+        {
+            obj = Record();
+            bond::Deserialize(reader, obj);
+        }
+    };
+
+    deserialize();
+
+    if (!(obj == expected))
+    {
+        std::cerr << name << ": deserialized struct doesn't match" << std::endl;
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        deserialize();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << elapsed.count() / iterations << " ns per struct" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    try
+    {
+        options = bond::cmd::GetArgs<Options>(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+        options.help = true;
+    }
+
+    if (options.help)
+    {
+        bond::cmd::ShowUsage<Options>(argv[0]);
+        return 1;
+    }
+
+    using CompactReader = bond::CompactBinaryReader<bond::InputBuffer>;
+    using CompactWriter = bond::CompactBinaryWriter<bond::OutputBuffer>;
+    using FastReader = bond::FastBinaryReader<bond::InputBuffer>;
+    using FastWriter = bond::FastBinaryWriter<bond::OutputBuffer>;
+
+    const Record record = MakeRecord();
+
+    NewerRecord newer;
+    bond::Deserialize(CompactReader(Serialize<CompactWriter>(record)), newer);
+    newer.schema_version = "2";
+
+    const bond::blob compact = Serialize<CompactWriter>(record);
+    const bond::blob compactNewer = Serialize<CompactWriter>(newer);
+    const bond::blob fast = Serialize<FastWriter>(record);
+    const bond::blob fastNewer = Serialize<FastWriter>(newer);
+
+    bool ok = true;
+    ok = Measure<CompactReader>("Compact Binary", compact, false, record, options.iterations) && ok;
+    ok = Measure<CompactReader>("Compact Binary, newer struct", compactNewer, false, record, options.iterations) && ok;
+    ok = Measure<FastReader>("Fast Binary", fast, false, record, options.iterations) && ok;
+    ok = Measure<FastReader>("Fast Binary, newer struct", fastNewer, false, record, options.iterations) && ok;
+    ok = Measure<CompactReader>("Compact Binary, existing object", compact, true, record, options.iterations) && ok;
+    ok = Measure<CompactReader>("Compact Binary, newer struct, existing object", compactNewer, true, record, options.iterations) && ok;
+    ok = Measure<FastReader>("Fast Binary, existing object", fast, true, record, options.iterations) && ok;
+    ok = Measure<FastReader>("Fast Binary, newer struct, existing object", fastNewer, true, record, options.iterations) && ok;
+
+    return ok ? 0 : 1;
+}
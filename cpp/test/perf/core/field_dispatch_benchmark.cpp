@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Benchmark of looking up fields by id during deserialization.
+//
+// Deserializes a struct with 128 fields from Compact Binary payloads that
+// have the fields in schema order and in a shuffled order, using both the
+// compile-time and the runtime schema of the struct. Also maps the struct to
+// itself with bond::MapTo, using bond::Mappings and bond::CompiledMappings.
+
+#include "field_dispatch_benchmark_reflection.h"
+#include "field_dispatch_benchmark_types.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/cmdargs.h>
+#include <bond/protocol/compact_binary.h>
+#include <bond/stream/output_buffer.h>
+
+#include <boost/mpl/for_each.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace benchmark;
+
+using Reader = bond::CompactBinaryReader<bond::InputBuffer>;
+using Writer = bond::CompactBinaryWriter<bond::OutputBuffer>;
+
+// Gives every field a value different from its default, so that none of them
+// is omitted from the payload.
+class field_filler
+{
+public:
+    explicit field_filler(Wide& obj)
+        : _obj(obj)
+    {}
+
+    template <typename Field>
+    void operator()(const Field&) const
+    {
+        set(Field::GetVariable(_obj), Field::id);
+    }
+
+private:
+    static void set(uint32_t& var, uint16_t id)
+    {
+        var = id;
+    }
+
+    static void set(std::string& var, uint16_t id)
+    {
+        var = "field " + std::to_string(id);
+    }
+
+    Wide& _obj;
+};
+
+// Collects a function that writes each field of a struct so that the fields
+// can be written in any order.
+class field_writers
+{
+public:
+    field_writers(const Wide& obj, const bond::Serializer<Writer>& serializer)
+        : _obj(obj),
+          _serializer(serializer)
+    {}
+
+    template <typename Field>
+    void operator()(const Field&)
+    {
+        const Wide& obj = _obj;
+        const bond::Serializer<Writer>& serializer = _serializer;
+
+        writers.push_back([&obj, &serializer]
+        {
+            serializer.Field(Field::id, Field::metadata, Field::GetVariable(obj));
+        });
+    }
+
+    std::vector<std::function<void()> > writers;
+
+private:
+    const Wide& _obj;
+    const bond::Serializer<Writer>& _serializer;
+};
+
+static bond::blob Serialize(const Wide& obj, bool shuffle)
+{
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serializer<Writer> serializer(writer);
+
+    field_writers fields(obj, serializer);
+    boost::mpl::for_each<bond::schema<Wide>::type::fields>(std::ref(fields));
+
+    if (shuffle)
+    {
+        std::shuffle(fields.writers.begin(), fields.writers.end(), std::mt19937{ 42 });
+    }
+
+    serializer.Begin(bond::schema<Wide>::type::metadata);
+
+    for (const auto& write : fields.writers)
+    {
+        write();
+    }
+
+    serializer.End();
+
+    return output.GetBuffer();
+}
+
+template <typename Function>
+static bool Measure(const char* name, const Function& deserialize, const Wide& expected, uint32_t iterations)
+{
+    if (!(deserialize() == expected))
+    {
+        std::cerr << name << ": deserialized struct doesn't match" << std::endl;
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        deserialize();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << elapsed.count() / iterations << " ns per struct" << std::endl;
+    return true;
+}
+
+static bool Measure(const char* name, const bond::blob& payload, bool runtimeSchema, const Wide& expected, uint32_t iterations)
+{
+    const bond::RuntimeSchema schema = bond::GetRuntimeSchema<Wide>();
+
+    const auto deserialize = [&]
+    {
+        Wide obj;
+        Reader reader(payload);
+
+        if (runtimeSchema)
+        {
+            bond::bonded<void>(reader, schema).Deserialize(obj);
+        }
+        else
+        {
+            bond::Deserialize(reader, obj);
+        }
+
+        return obj;
+    };
+
+    return Measure(name, deserialize, expected, iterations);
+}
+
+// Maps the fields of the payload to the same fields of Wide.
+template <typename Mappings>
+static bool MeasureMapTo(const char* name, const bond::blob& payload, const Mappings& mappings, const Wide& expected, uint32_t iterations)
+{
+    const auto map = [&]
+    {
+        Wide obj;
+        bond::bonded<Wide> bonded{ Reader(payload) };
+
+        bond::Apply(bond::MapTo<Wide>(obj, mappings), bonded);
+
+        return obj;
+    };
+
+    return Measure(name, map, expected, iterations);
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    try
+    {
+        options = bond::cmd::GetArgs<Options>(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+        options.help = true;
+    }
+
+    if (options.help)
+    {
+        bond::cmd::ShowUsage<Options>(argv[0]);
+        return 1;
+    }
+
+    Wide obj;
+    boost::mpl::for_each<bond::schema<Wide>::type::fields>(field_filler{ obj });
+
+    const bond::blob ordered = Serialize(obj, false);
+    const bond::blob shuffled = Serialize(obj, true);
+
+    bool ok = true;
+    ok = Measure("ordered, compile-time schema", ordered, false, obj, options.iterations) && ok;
+    ok = Measure("shuffled, compile-time schema", shuffled, false, obj, options.iterations) && ok;
+    ok = Measure("ordered, runtime schema", ordered, true, obj, options.iterations) && ok;
+    ok = Measure("shuffled, runtime schema", shuffled, true, obj, options.iterations) && ok;
+
+    bond::Mappings mappings;
+
+    for (const bond::FieldDef& field : bond::GetRuntimeSchema<Wide>().GetStruct().fields)
+    {
+        mappings[field.id].path.push_back(field.id);
+    }
+
+    const bond::CompiledMappings compiled(mappings);
+
+    ok = MeasureMapTo("ordered, MapTo with Mappings", ordered, mappings, obj, options.iterations) && ok;
+    ok = MeasureMapTo("ordered, MapTo with CompiledMappings", ordered, compiled, obj, options.iterations) && ok;
+
+    return ok ? 0 : 1;
+}
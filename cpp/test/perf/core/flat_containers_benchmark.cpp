@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Benchmark of flat containers versus the standard ordered containers.
+//
+// Deserializes a Compact Binary payload with a map, a set and a short list
+// both into std::map, std::set and std::vector and into boost flat_map,
+// flat_set and small_vector, and then looks up every key of the map in the
+// deserialized struct. The payload is written once in sorted order, as from
+// standard ordered containers, and once shuffled, as from hashed containers
+// or by other Bond languages.
+
+#include "flat_containers_benchmark_reflection.h"
+#include "flat_containers_benchmark_types.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/cmdargs.h>
+#include <bond/protocol/compact_binary.h>
+#include <bond/stream/output_buffer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace benchmark;
+
+using Reader = bond::CompactBinaryReader<bond::InputBuffer>;
+using Writer = bond::CompactBinaryWriter<bond::OutputBuffer>;
+
+static Index MakeIndex(uint32_t size)
+{
+    Index index;
+
+    for (uint64_t i = 0; i < size; ++i)
+    {
+        const uint64_t id = i * 7919 + 17;
+
+        index.names.emplace(id, "item " + std::to_string(id));
+        index.ids.insert(id);
+    }
+
+    index.counters = { 1, 12, 123, 1234 };
+
+    return index;
+}
+
+// Writes the index with the items of the map and the set in a random order.
+static bond::blob SerializeShuffled(const Index& index)
+{
+    std::vector<uint64_t> ids(index.ids.begin(), index.ids.end());
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(ids.size()));
+
+    bond::OutputBuffer output;
+    Writer writer(output);
+
+    writer.WriteStructBegin(bond::Metadata(), false);
+
+    writer.WriteFieldBegin(bond::BT_MAP, 10);
+    writer.WriteContainerBegin(static_cast<uint32_t>(ids.size()), std::make_pair(bond::BT_UINT64, bond::BT_STRING));
+
+    for (uint64_t id : ids)
+    {
+        writer.Write(id);
+        writer.Write(index.names.at(id));
+    }
+
+    writer.WriteContainerEnd();
+    writer.WriteFieldEnd();
+
+    writer.WriteFieldBegin(bond::BT_SET, 20);
+    writer.WriteContainerBegin(static_cast<uint32_t>(ids.size()), bond::BT_UINT64);
+
+    for (uint64_t id : ids)
+    {
+        writer.Write(id);
+    }
+
+    writer.WriteContainerEnd();
+    writer.WriteFieldEnd();
+
+    writer.WriteFieldBegin(bond::BT_LIST, 30);
+    writer.WriteContainerBegin(static_cast<uint32_t>(index.counters.size()), bond::BT_UINT32);
+
+    for (uint32_t counter : index.counters)
+    {
+        writer.Write(counter);
+    }
+
+    writer.WriteContainerEnd();
+    writer.WriteFieldEnd();
+
+    writer.WriteStructEnd();
+
+    return output.GetBuffer();
+}
+
+template <typename T>
+static bool Matches(const T& obj, const Index& expected)
+{
+    if (obj.names.size() != expected.names.size())
+        return false;
+
+    auto it = expected.names.begin();
+
+    for (const auto& item : obj.names)
+    {
+        if (item.first != it->first || item.second != it->second)
+            return false;
+
+        ++it;
+    }
+
+    return obj.ids.size() == expected.ids.size()
+        && std::equal(obj.ids.begin(), obj.ids.end(), expected.ids.begin())
+        && obj.counters.size() == expected.counters.size()
+        && std::equal(obj.counters.begin(), obj.counters.end(), expected.counters.begin());
+}
+
+template <typename T>
+static bool Measure(const char* name, const bond::blob& payload, const Index& expected, uint32_t iterations)
+{
+    const auto deserialize = [&]
+    {
+        T obj;
+        bond::Deserialize(Reader(payload), obj);
+
+        return obj;
+    };
+
+    const T obj = deserialize();
+
+    if (!Matches(obj, expected))
+    {
+        std::cerr << name << ": deserialized struct doesn't match" << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        deserialize();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        for (const auto& item : expected.names)
+        {
+            found += obj.names.count(item.first);
+        }
+    }
+
+    const std::chrono::duration<double, std::nano> lookups = std::chrono::steady_clock::now() - start;
+
+    if (found != expected.names.size() * iterations)
+    {
+        std::cerr << name << ": lookups failed" << std::endl;
+        return false;
+    }
+
+    std::cout << name << ": " << elapsed.count() / iterations << " ns per struct, "
+              << lookups.count() / (iterations * std::max<size_t>(expected.names.size(), 1))
+              << " ns per lookup" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    try
+    {
+        options = bond::cmd::GetArgs<Options>(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+        options.help = true;
+    }
+
+    if (options.help)
+    {
+        bond::cmd::ShowUsage<Options>(argv[0]);
+        return 1;
+    }
+
+    const Index index = MakeIndex(options.size);
+
+    bond::OutputBuffer output;
+    Writer writer(output);
+    bond::Serialize(index, writer);
+
+    const bond::blob payload = output.GetBuffer();
+    const bond::blob shuffled = SerializeShuffled(index);
+
+    bool ok = true;
+    ok = Measure<Index>("sorted, std::map, std::set, std::vector", payload, index, options.iterations) && ok;
+    ok = Measure<FlatIndex>("sorted, flat_map, flat_set, small_vector", payload, index, options.iterations) && ok;
+    ok = Measure<Index>("shuffled, std::map, std::set, std::vector", shuffled, index, options.iterations) && ok;
+    ok = Measure<FlatIndex>("shuffled, flat_map, flat_set, small_vector", shuffled, index, options.iterations) && ok;
+
+    return ok ? 0 : 1;
+}
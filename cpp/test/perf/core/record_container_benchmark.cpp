@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Benchmark of the record container.
+//
+// Writes log-like records into a record container with each available codec,
+// reporting the time to write it and its size compared to the marshaled
+// records, and then reads the records back, decompressing the blocks on the
+// reading thread and on a thread per block, and deserializes them.
+
+#include "record_container_benchmark_reflection.h"
+#include "record_container_benchmark_types.h"
+#include "thread_per_task.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/cmdargs.h>
+#include <bond/ext/record_container.h>
+#ifdef BOND_BENCHMARK_ZLIB
+#include <bond/ext/zlib_codec.h>
+#endif
+#include <bond/protocol/compact_binary.h>
+#include <bond/stream/output_buffer.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace benchmark;
+
+static Record MakeRecord(uint32_t i)
+{
+    Record record;
+
+    record.timestamp = 1530000000000 + i * 17;
+    record.severity = static_cast<Severity>(i % 4);
+    record.source = "frontend-" + std::to_string(i % 32);
+    record.message = "request " + std::to_string(i) + " took longer than expected to complete";
+    record.thread_id = 4711 + i % 8;
+    record.duration = 0.125 * (i % 100);
+    record.success = i % 3 != 0;
+    record.tags = { "http", "slow", "retried" };
+    record.properties = { { "method", "GET" }, { "status", "200" }, { "region", "west" } };
+    record.correlation_id = 0x123456789abcdef + i;
+
+    return record;
+}
+
+template <typename Function>
+static double Measure(uint32_t iterations, const Function& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+template <typename ThreadPool>
+static bool Read(const bond::blob& data, uint32_t count, ThreadPool thread_pool, const bond::ext::block_codec* codec)
+{
+    bond::ext::record_container_reader<ThreadPool> reader(data, thread_pool, 4, { codec });
+    bond::bonded<Record> bonded;
+    Record record;
+    uint32_t i = 0;
+
+    for (; reader.read(bonded); ++i)
+    {
+        bonded.DeserializeExisting(record);
+
+        if (i >= count || !(record == MakeRecord(i)))
+        {
+            std::cerr << "Record " << i << " doesn't match" << std::endl;
+            return false;
+        }
+    }
+
+    return i == count;
+}
+
+static bool Run(const char* name, const bond::ext::block_codec* codec, const std::vector<Record>& records,
+                double megabytes, const Options& options)
+{
+    bond::blob data;
+
+    const double write = Measure(options.iterations, [&]
+    {
+        bond::OutputBuffer output;
+        bond::ext::record_container_writer<bond::OutputBuffer> writer(output, codec, options.block_size);
+
+        for (const Record& record : records)
+        {
+            writer.write(record);
+        }
+
+        writer.close();
+        data = output.GetBuffer();
+    });
+
+    const uint32_t count = static_cast<uint32_t>(records.size());
+    bool ok = true;
+
+    const double read = Measure(options.iterations, [&]
+    {
+        ok = Read(data, count, bond::ext::inline_thread_pool(), codec) && ok;
+    });
+
+    const double parallel = Measure(options.iterations, [&]
+    {
+        ok = Read(data, count, thread_per_task(), codec) && ok;
+    });
+
+    std::cout << name << ": " << data.length() / 1e6 << " MB, ratio " << megabytes * 1e6 / data.length()
+        << ", write " << write << " ms, read " << read << " ms, read with a thread per block "
+        << parallel << " ms" << std::endl;
+
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    try
+    {
+        options = bond::cmd::GetArgs<Options>(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+        options.help = true;
+    }
+
+    if (options.help)
+    {
+        bond::cmd::ShowUsage<Options>(argv[0]);
+        return 1;
+    }
+
+    std::vector<Record> records;
+    bond::OutputBuffer marshaled;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(marshaled);
+
+    for (uint32_t i = 0; i < options.records; ++i)
+    {
+        records.push_back(MakeRecord(i));
+        bond::Marshal(records.back(), writer);
+    }
+
+    const double megabytes = marshaled.GetBuffer().length() / 1e6;
+
+    std::cout << options.records << " records, " << megabytes << " MB marshaled" << std::endl;
+
+    bool ok = true;
+
+    bond::ext::lz_codec lz;
+    ok = Run("lz", &lz, records, megabytes, options) && ok;
+
+#ifdef BOND_BENCHMARK_ZLIB
+    bond::ext::zlib_codec zlib(1);
+    ok = Run("zlib level 1", &zlib, records, megabytes, options) && ok;
+#endif
+
+    return ok ? 0 : 1;
+}
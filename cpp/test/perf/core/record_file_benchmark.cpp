@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Benchmark of deserializing a record file in parallel.
+//
+// Writes a file of Compact Binary v2 records, measures scanning its record
+// boundaries and reading its index, and then deserializes all the records
+// with 1, 2, 4, ... threads, reporting the throughput and the speedup over
+// a single thread.
+
+#include "record_file_benchmark_reflection.h"
+#include "record_file_benchmark_types.h"
+#include "thread_per_task.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/cmdargs.h>
+#include <bond/ext/record_file.h>
+#include <bond/protocol/compact_binary.h>
+#include <bond/stream/output_buffer.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace benchmark;
+
+static Record MakeRecord(uint32_t i)
+{
+    Record record;
+
+    record.timestamp = 1530000000000 + i * 17;
+    record.severity = static_cast<Severity>(i % 4);
+    record.source = "frontend-" + std::to_string(i % 32);
+    record.message = "request " + std::to_string(i) + " took longer than expected to complete";
+    record.thread_id = 4711 + i % 8;
+    record.duration = 0.125 * (i % 100);
+    record.success = i % 3 != 0;
+    record.location.file = "request_handler.cpp";
+    record.location.line = 273 + i % 50;
+    record.location.function = "Handle";
+    record.counters = { i, 12, 123, 1234, 12345, 123456 };
+    record.tags = { "http", "slow", "retried" };
+    record.properties = { { "method", "GET" }, { "status", "200" }, { "region", "west" } };
+    record.correlation_id = 0x123456789abcdef + i;
+
+    return record;
+}
+
+template <typename Function>
+static double Measure(uint32_t iterations, const Function& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    try
+    {
+        options = bond::cmd::GetArgs<Options>(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+        options.help = true;
+    }
+
+    if (options.help)
+    {
+        bond::cmd::ShowUsage<Options>(argv[0]);
+        return 1;
+    }
+
+    const uint32_t max_threads = options.threads != 0
+        ? options.threads
+        : (std::max)(1u, std::thread::hardware_concurrency());
+
+    bond::OutputBuffer output;
+    bond::CompactBinaryWriter<bond::OutputBuffer> writer(output, bond::v2);
+
+    for (uint32_t i = 0; i < options.records; ++i)
+    {
+        bond::Serialize(MakeRecord(i), writer);
+    }
+
+    const bond::blob data = output.GetBuffer();
+    const double megabytes = data.length() / 1e6;
+
+    std::vector<uint32_t> index;
+
+    const double scan = Measure(options.iterations, [&] { index = bond::ext::index_records(data); });
+
+    bond::OutputBuffer sidecar;
+    bond::ext::write_record_index(sidecar, index);
+
+    const bond::blob sidecar_data = sidecar.GetBuffer();
+
+    const double read_index = Measure(options.iterations, [&] { index = bond::ext::read_record_index(sidecar_data); });
+
+    std::cout << options.records << " records, " << megabytes << " MB, index of "
+        << sidecar_data.length() / 1e3 << " KB" << std::endl;
+    std::cout << "Scanning the records: " << scan << " ms" << std::endl;
+    std::cout << "Reading the index: " << read_index << " ms" << std::endl;
+
+    std::vector<Record> records;
+    double single = 0;
+
+    for (uint32_t threads = 1; ; threads = (std::min)(threads * 2, max_threads))
+    {
+        const double elapsed = Measure(options.iterations, [&]
+        {
+            bond::ext::deserialize_records(data, index, records, thread_per_task(), threads);
+        });
+
+        if (threads == 1)
+        {
+            single = elapsed;
+        }
+
+        std::cout << threads << " threads: " << elapsed << " ms, "
+            << megabytes * 1e3 / elapsed << " MB/s, speedup " << single / elapsed << std::endl;
+
+        if (threads == max_threads)
+        {
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < options.records; ++i)
+    {
+        if (!(records[i] == MakeRecord(i)))
+        {
+            std::cerr << "Record " << i << " doesn't match" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace benchmark
+{
+    // Thread pool which runs each callback on a new thread, joined when the
+    // last copy of the pool is destroyed.
+    class thread_per_task
+    {
+        struct threads : std::vector<std::thread>
+        {
+            ~threads()
+            {
+                for (std::thread& thread : *this)
+                {
+                    thread.join();
+                }
+            }
+        };
+
+    public:
+        template <typename Callback>
+        void operator()(Callback&& callback)
+        {
+            _threads->emplace_back(std::forward<Callback>(callback));
+        }
+
+    private:
+        std::shared_ptr<threads> _threads = std::make_shared<threads>();
+    };
+
+} // namespace benchmark
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Replaces the global scalar operator new to count calls to it. It is kept
+// in its own translation unit so that the compiler cannot inline it at call
+// sites. Other operator new forms and direct malloc calls are not counted.
+
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> new_calls{ 0 };
+
+void* operator new(std::size_t size)
+{
+    new_calls.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+namespace benchmark
+{
+    uint64_t operator_new_count()
+    {
+        return new_calls.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+#include <cstdint>
+
+namespace benchmark
+{
+    // Returns the number of calls to the global scalar operator new made so
+    // far by the process. Array, nothrow and aligned forms of operator new
+    // and direct calls to malloc are not counted.
+    uint64_t operator_new_count();
+}
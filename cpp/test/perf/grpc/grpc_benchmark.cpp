@@ -0,0 +1,353 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Loopback benchmark of Bond gRPC calls.
+//
+// Starts a service and a client in the same process and, for every
+// combination of payload size and concurrency, keeps the given number of
+// echo calls outstanding for a fixed time. The latency percentiles,
+// throughput, C++ operator new calls and CPU time per call are written as
+// JSON.
+
+#include "allocation_counter.h"
+#include "grpc_benchmark_grpc.h"
+#include "grpc_benchmark_reflection.h"
+#include "grpc_benchmark_types.h"
+
+#include <bond/core/bond.h>
+#include <bond/core/cmdargs.h>
+#include <bond/ext/grpc/io_manager.h>
+#include <bond/ext/grpc/server.h>
+#include <bond/ext/grpc/thread_pool.h>
+#include <bond/ext/grpc/unary_call.h>
+#include <bond/protocol/simple_json_writer.h>
+#include <bond/stream/output_buffer.h>
+
+#include <boost/chrono/process_cpu_clocks.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace benchmark;
+
+// Latency histogram with buckets 1% apart, so that recording a call takes
+// neither a lock nor an allocation.
+class histogram
+{
+public:
+    histogram()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& count : _counts)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void record(std::chrono::steady_clock::duration latency)
+    {
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+        const size_t bucket = ns < 1 ? 0 : static_cast<size_t>(std::log(ns) / std::log(growth));
+
+        _counts[(std::min)(bucket, _counts.size() - 1)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns the upper bound of the bucket containing the given quantile,
+    // in microseconds.
+    double percentile(double quantile) const
+    {
+        uint64_t total = 0;
+        for (const auto& count : _counts)
+        {
+            total += count.load(std::memory_order_relaxed);
+        }
+
+        const uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * total));
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < _counts.size(); ++i)
+        {
+            seen += _counts[i].load(std::memory_order_relaxed);
+            if (seen != 0 && seen >= rank)
+            {
+                return std::pow(growth, static_cast<double>(i + 1)) / 1000;
+            }
+        }
+
+        return 0;
+    }
+
+private:
+    static constexpr double growth = 1.01;
+
+    // Enough buckets for latencies of up to 100 seconds.
+    std::array<std::atomic<uint64_t>, 2600> _counts;
+};
+
+constexpr double histogram::growth;
+
+class BenchmarkServiceImpl final : public Benchmark::Service
+{
+public:
+    using Benchmark::Service::Service;
+
+private:
+    void Echo(bond::ext::grpc::unary_call<Payload, Payload> call) override
+    {
+        call.Finish(call.request().Deserialize());
+    }
+};
+
+// Keeps a fixed number of calls outstanding until stopped.
+class load
+{
+public:
+    load(Benchmark::Client& client, const Payload& payload, histogram& latencies)
+        : _client(client),
+          _payload(payload),
+          _latencies(latencies)
+    {}
+
+    void run(uint32_t concurrency, std::chrono::milliseconds duration)
+    {
+        _stopping = false;
+        _outstanding = concurrency;
+
+        for (uint32_t i = 0; i < concurrency; ++i)
+        {
+            start();
+        }
+
+        std::this_thread::sleep_for(duration);
+        _stopping = true;
+
+        std::unique_lock<std::mutex> lock{ _mutex };
+        _done.wait(lock, [this] { return _outstanding == 0; });
+    }
+
+    uint64_t calls() const
+    {
+        return _calls;
+    }
+
+    uint64_t errors() const
+    {
+        return _errors;
+    }
+
+    void reset()
+    {
+        _calls = 0;
+        _errors = 0;
+        _latencies.reset();
+    }
+
+private:
+    void start()
+    {
+        const auto started = std::chrono::steady_clock::now();
+
+        _client.AsyncEcho(
+            _payload,
+            [this, started](bond::ext::grpc::unary_call_result<Payload> result)
+            {
+                if (result.status().ok())
+                {
+                    // Deserialize to account for the cost of reading the
+                    // response too.
+                    result.response().Deserialize();
+
+                    _latencies.record(std::chrono::steady_clock::now() - started);
+                    ++_calls;
+                }
+                else
+                {
+                    ++_errors;
+                }
+
+                if (!_stopping)
+                {
+                    start();
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock{ _mutex };
+                if (--_outstanding == 0)
+                {
+                    _done.notify_one();
+                }
+            });
+    }
+
+    Benchmark::Client& _client;
+    const Payload& _payload;
+    histogram& _latencies;
+    std::atomic<bool> _stopping{ false };
+    std::atomic<uint64_t> _calls{ 0 };
+    std::atomic<uint64_t> _errors{ 0 };
+    std::mutex _mutex;
+    std::condition_variable _done;
+    uint32_t _outstanding = 0;
+};
+
+static Result Measure(Benchmark::Client& client, uint32_t payloadSize, uint32_t concurrency, const Options& options)
+{
+    boost::shared_ptr<char[]> buffer{ new char[payloadSize == 0 ? 1 : payloadSize]() };
+
+    Payload payload;
+    payload.data = bond::blob{ buffer, payloadSize };
+
+    std::unique_ptr<histogram> latencies{ new histogram };
+    load generator{ client, payload, *latencies };
+
+    generator.run(concurrency, std::chrono::milliseconds(options.warmup_ms));
+    generator.reset();
+
+    const uint64_t newCallsBefore = operator_new_count();
+    const auto cpuBefore = boost::chrono::process_cpu_clock::now();
+    const auto wallBefore = std::chrono::steady_clock::now();
+
+    generator.run(concurrency, std::chrono::milliseconds(options.duration_ms));
+
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallBefore;
+    const auto cpu = boost::chrono::process_cpu_clock::now() - cpuBefore;
+    const uint64_t newCalls = operator_new_count() - newCallsBefore;
+
+    const double cpuNs = static_cast<double>(cpu.count().user + cpu.count().system);
+
+    Result result;
+    result.payload_size = payloadSize;
+    result.concurrency = concurrency;
+    result.calls = generator.calls();
+    result.errors = generator.errors();
+
+    if (result.calls != 0)
+    {
+        result.qps = result.calls / wall.count();
+        result.latency_p50_us = latencies->percentile(0.5);
+        result.latency_p99_us = latencies->percentile(0.99);
+        result.latency_p999_us = latencies->percentile(0.999);
+        result.operator_new_calls_per_call = static_cast<double>(newCalls) / result.calls;
+        result.cpu_us_per_call = cpuNs / 1000 / result.calls;
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    try
+    {
+        options = bond::cmd::GetArgs<Options>(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+        options.help = true;
+    }
+
+    if (options.help || (options.transport != "tcp" && options.transport != "inproc"))
+    {
+        bond::cmd::ShowUsage<Options>(argv[0]);
+        return 1;
+    }
+
+    if (options.payload_sizes.empty())
+    {
+        options.payload_sizes = { 16, 1024, 64 * 1024, 1024 * 1024 };
+    }
+
+    if (options.concurrency.empty())
+    {
+        options.concurrency = { 1, 16, 128 };
+    }
+
+    bond::ext::grpc::thread_pool threadPool;
+    auto ioManager = std::make_shared<bond::ext::grpc::io_manager>();
+
+    const std::string address = "127.0.0.1:" + std::to_string(options.port);
+
+    ::grpc::ServerBuilder builder;
+    builder.SetMaxMessageSize((std::numeric_limits<int>::max)());
+
+    if (options.transport == "tcp")
+    {
+        builder.AddListeningPort(address, ::grpc::InsecureServerCredentials());
+    }
+
+    auto server = bond::ext::grpc::server::Start(
+        builder,
+        std::unique_ptr<BenchmarkServiceImpl>{ new BenchmarkServiceImpl{ threadPool } });
+
+    ::grpc::ChannelArguments args;
+    args.SetMaxReceiveMessageSize((std::numeric_limits<int>::max)());
+
+    Benchmark::Client client(
+        options.transport == "tcp"
+            ? ::grpc::CreateCustomChannel(address, ::grpc::InsecureChannelCredentials(), args)
+            : server.InProcessChannel(args),
+        ioManager,
+        threadPool);
+
+    Report report;
+    report.transport = options.transport;
+    report.hardware_threads = std::thread::hardware_concurrency();
+    report.duration_ms = options.duration_ms;
+
+    for (uint32_t payloadSize : options.payload_sizes)
+    {
+        for (uint32_t concurrency : options.concurrency)
+        {
+            Result result = Measure(client, payloadSize, concurrency, options);
+
+            std::cerr << "payload " << payloadSize << " B, concurrency " << concurrency
+                << ": " << result.qps << " calls/s, p50 " << result.latency_p50_us
+                << " us, p99 " << result.latency_p99_us << " us" << std::endl;
+
+            report.results.push_back(result);
+        }
+    }
+
+    bond::OutputBuffer output;
+    bond::SimpleJsonWriter<bond::OutputBuffer> writer(output, /* pretty */ true);
+    bond::Serialize(report, writer);
+
+    const bond::blob json = output.GetBuffer();
+
+    if (options.output.empty())
+    {
+        std::cout.write(json.content(), json.length());
+        std::cout << std::endl;
+    }
+    else
+    {
+        std::ofstream file{ options.output };
+        file.write(json.content(), json.length());
+    }
+
+    bool failed = false;
+    for (const Result& result : report.results)
+    {
+        failed = failed || result.calls == 0 || result.errors != 0;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+#include "channel_pool_grpc.h"
+#include "channel_pool_types.h"
+
+#include <bond/ext/grpc/channel_pool.h>
+#include <bond/ext/grpc/io_manager.h>
+#include <bond/ext/grpc/server.h>
+#include <bond/ext/grpc/thread_pool.h>
+#include <bond/ext/grpc/unary_call.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+using namespace examples::channel_pool;
+
+// Sends the request payload back as the response.
+class LoopbackServiceImpl final : public Loopback::Service
+{
+public:
+    using Loopback::Service::Service;
+
+private:
+    void Echo(bond::ext::grpc::unary_call<Payload, Payload> call) override
+    {
+        call.Finish(call.request().Deserialize());
+    }
+};
+
+// Keeps a fixed number of calls outstanding on the client for the given
+// duration and returns the number of calls completed per second.
+static double MeasureThroughput(
+    Loopback::Client& client,
+    const Payload& payload,
+    size_t concurrency,
+    std::chrono::steady_clock::duration duration)
+{
+    std::mutex mutex;
+    std::condition_variable done;
+    std::atomic<uint64_t> completed{ 0 };
+    std::atomic<uint64_t> failed{ 0 };
+    size_t outstanding = 0;
+    std::atomic<bool> stopping{ false };
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto stop = start + duration;
+
+    std::function<void(bond::ext::grpc::unary_call_result<Payload>)> callback;
+    callback = [&](bond::ext::grpc::unary_call_result<Payload> result)
+    {
+        if (result.status().ok())
+        {
+            ++completed;
+        }
+        else
+        {
+            ++failed;
+        }
+
+        if (!stopping && std::chrono::steady_clock::now() < stop)
+        {
+            client.AsyncEcho(payload, callback);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{ mutex };
+        stopping = true;
+        if (--outstanding == 0)
+        {
+            done.notify_one();
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        outstanding = concurrency;
+    }
+
+    for (size_t i = 0; i < concurrency; ++i)
+    {
+        client.AsyncEcho(payload, callback);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock{ mutex };
+        done.wait(lock, [&] { return outstanding == 0; });
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (failed != 0)
+    {
+        std::cout << failed << " calls failed" << std::endl;
+        return 0;
+    }
+
+    return completed / elapsed.count();
+}
+
+int main()
+{
+    auto ioManager = std::make_shared<bond::ext::grpc::io_manager>();
+    bond::ext::grpc::thread_pool threadPool;
+
+    std::unique_ptr<LoopbackServiceImpl> service{ new LoopbackServiceImpl{ threadPool } };
+
+    const std::string server_address("127.0.0.1:50051");
+
+    ::grpc::ServerBuilder builder;
+    builder.AddListeningPort(server_address, ::grpc::InsecureServerCredentials());
+    builder.SetMaxMessageSize(64 * 1024 * 1024);
+
+    auto server = bond::ext::grpc::server::Start(builder, std::move(service));
+
+    // Large payloads make a single connection's flow-control window and
+    // stream limit the bottleneck.
+    const uint32_t payloadSize = 256 * 1024;
+    boost::shared_ptr<char[]> buffer{ new char[payloadSize]() };
+
+    Payload payload;
+    payload.data = bond::blob{ buffer, payloadSize };
+
+    const size_t concurrency = 64;
+    const auto duration = std::chrono::seconds(1);
+
+    ::grpc::ChannelArguments args;
+    args.SetMaxReceiveMessageSize(64 * 1024 * 1024);
+
+    Loopback::Client single(
+        ::grpc::CreateCustomChannel(server_address, ::grpc::InsecureChannelCredentials(), args),
+        ioManager,
+        threadPool);
+
+    const double singleRate = MeasureThroughput(single, payload, concurrency, duration);
+    std::cout << "1 channel: " << singleRate << " calls/s" << std::endl;
+
+    const size_t channels[] = { 2, 4, 8 };
+
+    for (size_t count : channels)
+    {
+        Loopback::Client pooled(
+            bond::ext::grpc::channel_pool::Create(
+                server_address,
+                ::grpc::InsecureChannelCredentials(),
+                count,
+                bond::ext::grpc::channel_selection::power_of_two_choices,
+                args),
+            ioManager,
+            threadPool);
+
+        const double pooledRate = MeasureThroughput(pooled, payload, concurrency, duration);
+        std::cout << count << " channels: " << pooledRate << " calls/s ("
+            << pooledRate / singleRate << "x)" << std::endl;
+
+        if (pooledRate == 0)
+        {
+            return 1;
+        }
+    }
+
+    return singleRate == 0 ? 1 : 0;
+}